@@ -13,6 +13,17 @@ namespace dxvk {
     m_desc        (*pDesc),
     m_resource    (this),
     m_d3d10       (this) {
+    Rc<DxvkDevice> device = m_parent->GetDXVKDevice();
+
+    // Tile pools do not have a buffer of their own, pages
+    // are only allocated once they are mapped to a resource
+    if (pDesc->MiscFlags & D3D11_RESOURCE_MISC_TILE_POOL) {
+      m_sparseAllocator = device->createSparsePageAllocator();
+      m_sparseAllocator->setCapacity(uint32_t(pDesc->ByteWidth / SparseMemoryPageSize));
+      m_mapMode = D3D11_COMMON_BUFFER_MAP_MODE_NONE;
+      return;
+    }
+
     DxvkBufferCreateInfo  info;
     info.size   = pDesc->ByteWidth;
     info.usage  = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
@@ -66,9 +77,19 @@ namespace dxvk {
       info.access |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
     }
 
+    if (pDesc->MiscFlags & D3D11_RESOURCE_MISC_TILED) {
+      info.flags = VK_BUFFER_CREATE_SPARSE_BINDING_BIT
+                 | VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT
+                 | VK_BUFFER_CREATE_SPARSE_ALIASED_BIT;
+    }
+
     // Create the buffer and set the entire buffer slice as mapped,
-    // so that we only have to update it when invalidating th buffer
-    m_buffer = m_parent->GetDXVKDevice()->createBuffer(info, GetMemoryFlags());
+    // so that we only have to update it when invalidating th buffer.
+    // Small dynamic buffers suballocate from a shared buffer pool in
+    // order to avoid creating lots of small Vulkan buffers.
+    m_buffer = pDesc->Usage == D3D11_USAGE_DYNAMIC
+      ? device->createPooledBuffer(info, GetMemoryFlags())
+      : device->createBuffer      (info, GetMemoryFlags());
     m_mapped = m_buffer->getSliceHandle();
 
     m_mapMode = DetermineMapMode();
@@ -167,9 +188,27 @@ namespace dxvk {
     if (!pDesc->ByteWidth)
       return E_INVALIDARG;
 
-    // We don't support tiled resources
-    if (pDesc->MiscFlags & (D3D11_RESOURCE_MISC_TILE_POOL | D3D11_RESOURCE_MISC_TILED))
-      return E_INVALIDARG;
+    // Tiled buffers must be default buffers without CPU
+    // access, and cannot be used as constant buffers
+    if (pDesc->MiscFlags & D3D11_RESOURCE_MISC_TILED) {
+      if ((pDesc->MiscFlags & D3D11_RESOURCE_MISC_TILE_POOL)
+       || (pDesc->Usage != D3D11_USAGE_DEFAULT)
+       || (pDesc->CPUAccessFlags)
+       || (pDesc->BindFlags & D3D11_BIND_CONSTANT_BUFFER))
+        return E_INVALIDARG;
+    }
+
+    // Tile pools are not actual buffers and cannot be
+    // bound, and their size must be a multiple of the
+    // tile size
+    if (pDesc->MiscFlags & D3D11_RESOURCE_MISC_TILE_POOL) {
+      if ((pDesc->MiscFlags != D3D11_RESOURCE_MISC_TILE_POOL)
+       || (pDesc->Usage != D3D11_USAGE_DEFAULT)
+       || (pDesc->BindFlags)
+       || (pDesc->CPUAccessFlags)
+       || (pDesc->ByteWidth % SparseMemoryPageSize))
+        return E_INVALIDARG;
+    }
     
     // Constant buffer size must be a multiple of 16
     if ((pDesc->BindFlags & D3D11_BIND_CONSTANT_BUFFER)
@@ -209,6 +248,10 @@ namespace dxvk {
 
   VkMemoryPropertyFlags D3D11Buffer::GetMemoryFlags() const {
     VkMemoryPropertyFlags memoryFlags = 0;
+
+    // Memory for tiled buffers is provided by tile pools
+    if (m_desc.MiscFlags & D3D11_RESOURCE_MISC_TILED)
+      return VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
     
     switch (m_desc.Usage) {
       case D3D11_USAGE_IMMUTABLE:
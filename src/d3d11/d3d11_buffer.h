@@ -96,6 +96,14 @@ namespace dxvk {
       return size - offset;
     }
 
+    Rc<DxvkSparsePageAllocator> GetSparseAllocator() const {
+      return m_sparseAllocator;
+    }
+
+    bool IsTilePool() const {
+      return m_sparseAllocator != nullptr;
+    }
+
     DxvkBufferSlice GetSOCounter() {
       return m_soCounter != nullptr
         ? DxvkBufferSlice(m_soCounter)
@@ -150,6 +158,7 @@ namespace dxvk {
     
     Rc<DxvkBuffer>                m_buffer;
     Rc<DxvkBuffer>                m_soCounter;
+    Rc<DxvkSparsePageAllocator>   m_sparseAllocator;
     DxvkBufferSliceHandle         m_mapped;
     uint64_t                      m_seq = 0ull;
 
@@ -3,6 +3,8 @@
 #include "d3d11_buffer.h"
 #include "d3d11_texture.h"
 
+#include <algorithm>
+
 namespace dxvk {
     
   D3D11CommandList::D3D11CommandList(
@@ -76,8 +78,12 @@ namespace dxvk {
     for (const auto& chunk : m_chunks)
       seq = CsThread->dispatchChunk(DxvkCsChunkRef(chunk));
     
-    for (const auto& resource : m_resources)
-      TrackResourceSequenceNumber(resource, seq);
+    for (const auto& resource : m_resourceTable) {
+      if (resource.buffer)
+        resource.buffer->TrackSequenceNumber(seq);
+      else
+        resource.texture->TrackSequenceNumber(resource.subresource, seq);
+    }
 
     MarkSubmitted();
     return seq;
@@ -92,35 +98,55 @@ namespace dxvk {
   }
 
 
-  void D3D11CommandList::TrackResourceSequenceNumber(
-    const D3D11ResourceRef&   Resource,
-          uint64_t            Seq) {
-    ID3D11Resource* iface = Resource.Get();
-    UINT subresource = Resource.GetSubresource();
+  void D3D11CommandList::Finalize() {
+    // Deduplicate resources, since applications tend to
+    // use the same resources many times in one command list
+    std::sort(m_resources.begin(), m_resources.end(),
+      [] (const D3D11ResourceRef& a, const D3D11ResourceRef& b) {
+        if (a.Get() != b.Get())
+          return std::less<ID3D11Resource*>()(a.Get(), b.Get());
+
+        return a.GetSubresource() < b.GetSubresource();
+      });
+
+    auto end = std::unique(m_resources.begin(), m_resources.end(),
+      [] (const D3D11ResourceRef& a, const D3D11ResourceRef& b) {
+        return a.Get() == b.Get() && a.GetSubresource() == b.GetSubresource();
+      });
+
+    m_resources.erase(end, m_resources.end());
+
+    m_resourceTable.clear();
+    m_resourceTable.reserve(m_resources.size());
+
+    for (const auto& resource : m_resources) {
+      ID3D11Resource* iface = resource.Get();
+
+      D3D11CommandListResource entry = { };
+      entry.subresource = resource.GetSubresource();
+
+      switch (resource.GetType()) {
+        case D3D11_RESOURCE_DIMENSION_UNKNOWN:
+          continue;
 
-    switch (Resource.GetType()) {
-      case D3D11_RESOURCE_DIMENSION_UNKNOWN:
-        break;
+        case D3D11_RESOURCE_DIMENSION_BUFFER:
+          entry.buffer = static_cast<D3D11Buffer*>(iface);
+          break;
 
-      case D3D11_RESOURCE_DIMENSION_BUFFER: {
-        auto impl = static_cast<D3D11Buffer*>(iface);
-        impl->TrackSequenceNumber(Seq);
-      } break;
+        case D3D11_RESOURCE_DIMENSION_TEXTURE1D:
+          entry.texture = static_cast<D3D11Texture1D*>(iface)->GetCommonTexture();
+          break;
 
-      case D3D11_RESOURCE_DIMENSION_TEXTURE1D: {
-        auto impl = static_cast<D3D11Texture1D*>(iface)->GetCommonTexture();
-        impl->TrackSequenceNumber(subresource, Seq);
-      } break;
+        case D3D11_RESOURCE_DIMENSION_TEXTURE2D:
+          entry.texture = static_cast<D3D11Texture2D*>(iface)->GetCommonTexture();
+          break;
 
-      case D3D11_RESOURCE_DIMENSION_TEXTURE2D: {
-        auto impl = static_cast<D3D11Texture2D*>(iface)->GetCommonTexture();
-        impl->TrackSequenceNumber(subresource, Seq);
-      } break;
+        case D3D11_RESOURCE_DIMENSION_TEXTURE3D:
+          entry.texture = static_cast<D3D11Texture3D*>(iface)->GetCommonTexture();
+          break;
+      }
 
-      case D3D11_RESOURCE_DIMENSION_TEXTURE3D: {
-        auto impl = static_cast<D3D11Texture3D*>(iface)->GetCommonTexture();
-        impl->TrackSequenceNumber(subresource, Seq);
-      } break;
+      m_resourceTable.push_back(entry);
     }
   }
 
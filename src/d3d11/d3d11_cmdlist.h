@@ -3,6 +3,22 @@
 #include "d3d11_context.h"
 
 namespace dxvk {
+
+  class D3D11Buffer;
+  class D3D11CommonTexture;
+
+  /**
+   * \brief Resolved resource usage entry
+   *
+   * Points directly to the object that tracks sequence
+   * numbers, so that replaying a command list does not
+   * need to look at the resource type again.
+   */
+  struct D3D11CommandListResource {
+    D3D11Buffer*        buffer;
+    D3D11CommonTexture* texture;
+    UINT                subresource;
+  };
   
   class D3D11CommandList : public D3D11DeviceChild<ID3D11CommandList> {
     
@@ -37,6 +53,16 @@ namespace dxvk {
             D3D11_RESOURCE_DIMENSION ResourceType,
             UINT                Subresource);
 
+    /**
+     * \brief Finalizes resource usage tracking
+     *
+     * Removes duplicate resource references and resolves the
+     * remaining ones, so that each submission of the command
+     * list only needs to walk a compact table. Must be called
+     * once no more commands will be added to the list.
+     */
+    void Finalize();
+
   private:
 
     UINT         const m_contextFlags;
@@ -44,14 +70,11 @@ namespace dxvk {
     std::vector<DxvkCsChunkRef>         m_chunks;
     std::vector<Com<D3D11Query, false>> m_queries;
     std::vector<D3D11ResourceRef>       m_resources;
+    std::vector<D3D11CommandListResource> m_resourceTable;
 
     std::atomic<bool> m_submitted = { false };
     std::atomic<bool> m_warned    = { false };
 
-    void TrackResourceSequenceNumber(
-      const D3D11ResourceRef&   Resource,
-            uint64_t            Seq);
-
     void MarkSubmitted();
     
   };
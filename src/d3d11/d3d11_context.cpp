@@ -332,7 +332,7 @@ namespace dxvk {
     auto buf = static_cast<D3D11Buffer*>(pDstBuffer);
     auto uav = static_cast<D3D11UnorderedAccessView*>(pSrcView);
 
-    if (!buf || !uav)
+    if (!buf || !uav || buf->IsTilePool())
       return;
 
     auto counterSlice = uav->GetCounterSlice();
@@ -952,6 +952,8 @@ namespace dxvk {
     if (!ctrBuf.defined())
       return;
 
+    ApplyDirtyState();
+
     EmitCs([=] (DxvkContext* ctx) {
       ctx->drawIndirectXfb(ctrBuf,
         vtxBuf.buffer()->getXfbVertexStride(),
@@ -965,6 +967,7 @@ namespace dxvk {
           UINT            VertexCount,
           UINT            StartVertexLocation) {
     D3D10DeviceLock lock = LockContext();
+    ApplyDirtyState();
 
     EmitCs([=] (DxvkContext* ctx) {
       ctx->draw(
@@ -980,6 +983,7 @@ namespace dxvk {
           UINT            StartIndexLocation,
           INT             BaseVertexLocation) {
     D3D10DeviceLock lock = LockContext();
+    ApplyDirtyState();
 
     EmitCs([=] (DxvkContext* ctx) {
       ctx->drawIndexed(
@@ -997,6 +1001,7 @@ namespace dxvk {
           UINT            StartVertexLocation,
           UINT            StartInstanceLocation) {
     D3D10DeviceLock lock = LockContext();
+    ApplyDirtyState();
 
     EmitCs([=] (DxvkContext* ctx) {
       ctx->draw(
@@ -1016,6 +1021,7 @@ namespace dxvk {
           INT             BaseVertexLocation,
           UINT            StartInstanceLocation) {
     D3D10DeviceLock lock = LockContext();
+    ApplyDirtyState();
 
     EmitCs([=] (DxvkContext* ctx) {
       ctx->drawIndexed(
@@ -1038,6 +1044,8 @@ namespace dxvk {
     if (!ValidateDrawBufferSize(pBufferForArgs, AlignedByteOffsetForArgs, sizeof(VkDrawIndexedIndirectCommand)))
       return;
 
+    ApplyDirtyState();
+
     // If possible, batch up multiple indirect draw calls of
     // the same type into one single multiDrawIndirect call
     auto cmdData = static_cast<D3D11CmdDrawIndirectData*>(m_cmdData);
@@ -1073,6 +1081,8 @@ namespace dxvk {
     if (!ValidateDrawBufferSize(pBufferForArgs, AlignedByteOffsetForArgs, sizeof(VkDrawIndirectCommand)))
       return;
 
+    ApplyDirtyState();
+
     // If possible, batch up multiple indirect draw calls of
     // the same type into one single multiDrawIndirect call
     auto cmdData = static_cast<D3D11CmdDrawIndirectData*>(m_cmdData);
@@ -1149,7 +1159,7 @@ namespace dxvk {
       m_state.ia.inputLayout = inputLayout;
 
       if (!equal)
-        ApplyInputLayout();
+        m_dirtyState.set(D3D11DirtyState::InputLayout);
     }
   }
 
@@ -1160,7 +1170,7 @@ namespace dxvk {
 
     if (m_state.ia.primitiveTopology != Topology) {
       m_state.ia.primitiveTopology = Topology;
-      ApplyPrimitiveTopology();
+      m_dirtyState.set(D3D11DirtyState::PrimitiveTopology);
     }
   }
 
@@ -2242,14 +2252,14 @@ namespace dxvk {
       m_state.om.cbState    = blendState;
       m_state.om.sampleMask = SampleMask;
 
-      ApplyBlendState();
+      m_dirtyState.set(D3D11DirtyState::BlendState);
     }
 
     if (BlendFactor != nullptr) {
       for (uint32_t i = 0; i < 4; i++)
         m_state.om.blendFactor[i] = BlendFactor[i];
 
-      ApplyBlendFactor();
+      m_dirtyState.set(D3D11DirtyState::BlendFactor);
     }
   }
 
@@ -2264,12 +2274,12 @@ namespace dxvk {
 
     if (m_state.om.dsState != depthStencilState) {
       m_state.om.dsState = depthStencilState;
-      ApplyDepthStencilState();
+      m_dirtyState.set(D3D11DirtyState::DepthStencilState);
     }
 
     if (m_state.om.stencilRef != StencilRef) {
       m_state.om.stencilRef = StencilRef;
-      ApplyStencilRef();
+      m_dirtyState.set(D3D11DirtyState::StencilRef);
     }
   }
 
@@ -2357,14 +2367,14 @@ namespace dxvk {
 
     if (m_state.rs.state != nextRasterizerState) {
       m_state.rs.state = nextRasterizerState;
-      ApplyRasterizerState();
+      m_dirtyState.set(D3D11DirtyState::RasterizerState);
 
       // If necessary, update the rasterizer sample count push constant
       uint32_t currSampleCount = currRasterizerState != nullptr ? currRasterizerState->Desc()->ForcedSampleCount : 0;
       uint32_t nextSampleCount = nextRasterizerState != nullptr ? nextRasterizerState->Desc()->ForcedSampleCount : 0;
 
       if (currSampleCount != nextSampleCount)
-        ApplyRasterizerSampleCount();
+        m_dirtyState.set(D3D11DirtyState::RasterizerSampleCount);
 
       // In D3D11, the rasterizer state defines whether the scissor test is
       // enabled, so if that changes, we need to update scissor rects as well.
@@ -2372,7 +2382,7 @@ namespace dxvk {
       bool nextScissorEnable = nextRasterizerState != nullptr ? nextRasterizerState->Desc()->ScissorEnable : false;
 
       if (currScissorEnable != nextScissorEnable)
-        ApplyViewportState();
+        m_dirtyState.set(D3D11DirtyState::ViewportState);
     }
   }
 
@@ -2403,7 +2413,7 @@ namespace dxvk {
     }
 
     if (dirty)
-      ApplyViewportState();
+      m_dirtyState.set(D3D11DirtyState::ViewportState);
   }
 
 
@@ -2438,7 +2448,7 @@ namespace dxvk {
       m_state.rs.state->GetDesc(&rsDesc);
 
       if (rsDesc.ScissorEnable)
-        ApplyViewportState();
+        m_dirtyState.set(D3D11DirtyState::ViewportState);
     }
   }
 
@@ -2634,10 +2644,39 @@ namespace dxvk {
           ID3D11Buffer*                     pBuffer,
           UINT64                            BufferStartOffsetInBytes,
           UINT                              Flags) {
-    static bool s_errorShown = false;
+    D3D10DeviceLock lock = LockContext();
 
-    if (!std::exchange(s_errorShown, true))
-      Logger::err("D3D11DeviceContext::CopyTiles: Not implemented");
+    if (!pTiledResource || !pTileRegionStartCoordinate || !pTileRegionSize || !pBuffer)
+      return;
+
+    // Exactly one copy direction must be specified
+    constexpr UINT directionFlags
+      = D3D11_TILE_COPY_LINEAR_BUFFER_TO_SWIZZLED_TILED_RESOURCE
+      | D3D11_TILE_COPY_SWIZZLED_TILED_RESOURCE_TO_LINEAR_BUFFER;
+
+    UINT direction = Flags & directionFlags;
+
+    if (direction != D3D11_TILE_COPY_LINEAR_BUFFER_TO_SWIZZLED_TILED_RESOURCE
+     && direction != D3D11_TILE_COPY_SWIZZLED_TILED_RESOURCE_TO_LINEAR_BUFFER)
+      return;
+
+    auto buffer = static_cast<D3D11Buffer*>(pBuffer);
+
+    if (buffer->IsTilePool())
+      return;
+
+    VkDeviceSize byteCount = SparseMemoryPageSize * pTileRegionSize->NumTiles;
+
+    if (BufferStartOffsetInBytes + byteCount > buffer->Desc()->ByteWidth)
+      return;
+
+    CopyTiledResourceData(pTiledResource,
+      pTileRegionStartCoordinate, pTileRegionSize,
+      buffer->GetBufferSlice(BufferStartOffsetInBytes, byteCount),
+      Flags);
+
+    if (buffer->HasSequenceNumber())
+      GetTypedContext()->TrackBufferSequenceNumber(buffer);
   }
 
 
@@ -2649,12 +2688,73 @@ namespace dxvk {
     const D3D11_TILED_RESOURCE_COORDINATE*  pSourceRegionStartCoordinate,
     const D3D11_TILE_REGION_SIZE*           pTileRegionSize,
           UINT                              Flags) {
-    static bool s_errorShown = false;
+    D3D10DeviceLock lock = LockContext();
 
-    if (!std::exchange(s_errorShown, true))
-      Logger::err("D3D11DeviceContext::CopyTileMappings: Not implemented");
+    if (!pDestTiledResource || !pSourceTiledResource
+     || !pDestRegionStartCoordinate || !pSourceRegionStartCoordinate
+     || !pTileRegionSize)
+      return E_INVALIDARG;
+
+    DxvkSparseBindInfo bindInfo;
+    bindInfo.dstResource = GetTiledResource(pDestTiledResource);
+    bindInfo.srcResource = GetTiledResource(pSourceTiledResource);
+
+    if (bindInfo.dstResource == nullptr || bindInfo.srcResource == nullptr)
+      return E_INVALIDARG;
+
+    auto dstPageTable = bindInfo.dstResource->getSparsePageTable();
+    auto srcPageTable = bindInfo.srcResource->getSparsePageTable();
+
+    VkOffset3D dstRegionOffset = {
+      int32_t(pDestRegionStartCoordinate->X),
+      int32_t(pDestRegionStartCoordinate->Y),
+      int32_t(pDestRegionStartCoordinate->Z) };
+
+    VkOffset3D srcRegionOffset = {
+      int32_t(pSourceRegionStartCoordinate->X),
+      int32_t(pSourceRegionStartCoordinate->Y),
+      int32_t(pSourceRegionStartCoordinate->Z) };
+
+    VkExtent3D regionExtent = {
+      pTileRegionSize->Width,
+      pTileRegionSize->Height,
+      pTileRegionSize->Depth };
+
+    if (pTileRegionSize->bUseBox && pTileRegionSize->NumTiles
+        != regionExtent.width * regionExtent.height * regionExtent.depth)
+      return E_INVALIDARG;
+
+    bindInfo.binds.reserve(pTileRegionSize->NumTiles);
+
+    for (uint32_t i = 0; i < pTileRegionSize->NumTiles; i++) {
+      uint32_t dstPage = dstPageTable->computePageIndex(
+        pDestRegionStartCoordinate->Subresource, dstRegionOffset,
+        regionExtent, !pTileRegionSize->bUseBox, i);
+
+      uint32_t srcPage = srcPageTable->computePageIndex(
+        pSourceRegionStartCoordinate->Subresource, srcRegionOffset,
+        regionExtent, !pTileRegionSize->bUseBox, i);
+
+      if (dstPage == ~0u || srcPage == ~0u)
+        return E_INVALIDARG;
+
+      DxvkSparseBind bind;
+      bind.mode = DxvkSparseBindMode::Copy;
+      bind.dstPage = dstPage;
+      bind.srcPage = srcPage;
+
+      bindInfo.binds.push_back(bind);
+    }
+
+    if (!bindInfo.binds.empty()) {
+      EmitCs([
+        cBindInfo = std::move(bindInfo)
+      ] (DxvkContext* ctx) {
+        ctx->updatePageTable(cBindInfo);
+      });
+    }
 
-    return DXGI_ERROR_INVALID_CALL;
+    return S_OK;
   }
 
 
@@ -2662,12 +2762,27 @@ namespace dxvk {
   HRESULT STDMETHODCALLTYPE D3D11CommonContext<ContextType>::ResizeTilePool(
           ID3D11Buffer*                     pTilePool,
           UINT64                            NewSizeInBytes) {
-    static bool s_errorShown = false;
+    D3D10DeviceLock lock = LockContext();
 
-    if (!std::exchange(s_errorShown, true))
-      Logger::err("D3D11DeviceContext::ResizeTilePool: Not implemented");
+    if (!pTilePool || (NewSizeInBytes % SparseMemoryPageSize))
+      return E_INVALIDARG;
+
+    auto tilePool = static_cast<D3D11Buffer*>(pTilePool);
 
-    return DXGI_ERROR_INVALID_CALL;
+    if (!tilePool->IsTilePool())
+      return E_INVALIDARG;
+
+    // Pages beyond the new size remain valid for as long
+    // as they are mapped to any resource, so shrinking
+    // the pool only releases pages that are not in use
+    EmitCs([
+      cAllocator = tilePool->GetSparseAllocator(),
+      cPageCount = uint32_t(NewSizeInBytes / SparseMemoryPageSize)
+    ] (DxvkContext* ctx) {
+      cAllocator->setCapacity(cPageCount);
+    });
+
+    return S_OK;
   }
 
 
@@ -2675,7 +2790,14 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11CommonContext<ContextType>::TiledResourceBarrier(
           ID3D11DeviceChild*                pTiledResourceOrViewAccessBeforeBarrier,
           ID3D11DeviceChild*                pTiledResourceOrViewAccessAfterBarrier) {
+    D3D10DeviceLock lock = LockContext();
 
+    // Tiled resources can alias each other through the tile pool,
+    // which per-resource barrier tracking cannot detect. Since the
+    // resources may also be null, just emit a full barrier.
+    EmitCs([] (DxvkContext* ctx) {
+      ctx->emitFullBarrier();
+    });
   }
 
 
@@ -2691,12 +2813,116 @@ namespace dxvk {
     const UINT*                             pTilePoolStartOffsets,
     const UINT*                             pRangeTileCounts,
           UINT                              Flags) {
-    bool s_errorShown = false;
+    D3D10DeviceLock lock = LockContext();
 
-    if (std::exchange(s_errorShown, true))
-      Logger::err("D3D11DeviceContext::UpdateTileMappings: Not implemented");
+    if (!pTiledResource || !NumRanges || !NumTiledResourceRegions)
+      return E_INVALIDARG;
+
+    DxvkSparseBindInfo bindInfo;
+    bindInfo.dstResource = GetTiledResource(pTiledResource);
+
+    if (bindInfo.dstResource == nullptr)
+      return E_INVALIDARG;
+
+    if (pTilePool) {
+      auto tilePool = static_cast<D3D11Buffer*>(pTilePool);
+
+      if (!tilePool->IsTilePool())
+        return E_INVALIDARG;
+
+      bindInfo.srcAllocator = tilePool->GetSparseAllocator();
+    }
+
+    auto pageTable = bindInfo.dstResource->getSparsePageTable();
+
+    // Gather the resource pages covered by all regions in order.
+    // Without explicit sizes, a single region starting at the
+    // resource origin covers the entire resource, otherwise
+    // each region covers a single tile.
+    std::vector<uint32_t> pages;
+
+    for (uint32_t i = 0; i < NumTiledResourceRegions; i++) {
+      D3D11_TILED_RESOURCE_COORDINATE regionCoord = { };
+      D3D11_TILE_REGION_SIZE regionSize = { };
+      regionSize.NumTiles = 1;
+
+      if (pTiledResourceRegionStartCoordinates)
+        regionCoord = pTiledResourceRegionStartCoordinates[i];
+
+      if (pTiledResourceRegionSizes)
+        regionSize = pTiledResourceRegionSizes[i];
+      else if (!pTiledResourceRegionStartCoordinates && NumTiledResourceRegions == 1)
+        regionSize.NumTiles = pageTable->getPageCount();
+
+      VkOffset3D regionOffset = {
+        int32_t(regionCoord.X),
+        int32_t(regionCoord.Y),
+        int32_t(regionCoord.Z) };
+
+      VkExtent3D regionExtent = {
+        regionSize.Width,
+        regionSize.Height,
+        regionSize.Depth };
+
+      if (regionSize.bUseBox && regionSize.NumTiles
+          != regionExtent.width * regionExtent.height * regionExtent.depth)
+        return E_INVALIDARG;
+
+      for (uint32_t j = 0; j < regionSize.NumTiles; j++) {
+        uint32_t page = pageTable->computePageIndex(regionCoord.Subresource,
+          regionOffset, regionExtent, !regionSize.bUseBox, j);
+
+        if (page == ~0u)
+          return E_INVALIDARG;
+
+        pages.push_back(page);
+      }
+    }
 
-    return DXGI_ERROR_INVALID_CALL;
+    // Assign tile pool ranges to the resource pages
+    uint32_t pageIndex = 0;
+
+    for (uint32_t i = 0; i < NumRanges && pageIndex < pages.size(); i++) {
+      UINT rangeFlags = pRangeFlags ? pRangeFlags[i] : 0u;
+      UINT rangeStart = pTilePoolStartOffsets ? pTilePoolStartOffsets[i] : 0u;
+      UINT rangeCount = pRangeTileCounts ? pRangeTileCounts[i] : UINT(pages.size());
+
+      if (!(rangeFlags & (D3D11_TILE_RANGE_NULL | D3D11_TILE_RANGE_SKIP)) && !pTilePool)
+        return E_INVALIDARG;
+
+      for (uint32_t j = 0; j < rangeCount && pageIndex < pages.size(); j++) {
+        uint32_t page = pages[pageIndex++];
+
+        if (rangeFlags & D3D11_TILE_RANGE_SKIP)
+          continue;
+
+        DxvkSparseBind bind;
+        bind.dstPage = page;
+        bind.srcPage = 0;
+
+        if (rangeFlags & D3D11_TILE_RANGE_NULL) {
+          bind.mode = DxvkSparseBindMode::Null;
+        } else {
+          bind.mode = DxvkSparseBindMode::Bind;
+          bind.srcPage = (rangeFlags & D3D11_TILE_RANGE_REUSE_SINGLE_TILE)
+            ? rangeStart : rangeStart + j;
+        }
+
+        bindInfo.binds.push_back(bind);
+      }
+    }
+
+    // NO_OVERWRITE is only a hint, binds are
+    // always ordered with respect to prior work
+    if (!bindInfo.binds.empty()) {
+      EmitCs([
+        cBindInfo = std::move(bindInfo)
+      ] (DxvkContext* ctx) {
+        ctx->updatePageTable(cBindInfo);
+      });
+    }
+
+    return S_OK;
   }
 
 
@@ -2707,10 +2933,25 @@ namespace dxvk {
     const D3D11_TILE_REGION_SIZE*           pDestTileRegionSize,
     const void*                             pSourceTileData,
           UINT                              Flags) {
-    bool s_errorShown = false;
+    D3D10DeviceLock lock = LockContext();
 
-    if (std::exchange(s_errorShown, true))
-      Logger::err("D3D11DeviceContext::UpdateTiles: Not implemented");
+    if (!pDestTiledResource || !pDestTileRegionStartCoordinate
+     || !pDestTileRegionSize || !pSourceTileData)
+      return;
+
+    if (!pDestTileRegionSize->NumTiles)
+      return;
+
+    // Source data is tightly packed in the same
+    // layout that CopyTiles uses for buffers
+    VkDeviceSize byteCount = SparseMemoryPageSize * pDestTileRegionSize->NumTiles;
+
+    DxvkBufferSlice stagingSlice = AllocStagingBuffer(byteCount);
+    std::memcpy(stagingSlice.mapPtr(0), pSourceTileData, byteCount);
+
+    CopyTiledResourceData(pDestTiledResource,
+      pDestTileRegionStartCoordinate, pDestTileRegionSize,
+      std::move(stagingSlice), D3D11_TILE_COPY_LINEAR_BUFFER_TO_SWIZZLED_TILED_RESOURCE);
   }
 
 
@@ -2832,25 +3073,155 @@ namespace dxvk {
 
 
   template<typename ContextType>
-  void D3D11CommonContext<ContextType>::ApplyInputLayout() {
-    auto inputLayout = m_state.ia.inputLayout.prvRef();
+  void D3D11CommonContext<ContextType>::ApplyDirtyState() {
+    if (likely(m_dirtyState.isClear()))
+      return;
+
+    D3D11RenderStateUpdate state;
+    state.flags = m_dirtyState;
+
+    if (m_dirtyState.test(D3D11DirtyState::InputLayout))
+      state.inputLayout = m_state.ia.inputLayout.prvRef();
+
+    if (m_dirtyState.test(D3D11DirtyState::PrimitiveTopology))
+      state.iaState = GetInputAssemblyState();
+
+    if (m_dirtyState.test(D3D11DirtyState::BlendState)) {
+      state.cbState = m_state.om.cbState;
+      state.sampleMask = m_state.om.sampleMask;
+    }
+
+    if (m_dirtyState.test(D3D11DirtyState::BlendFactor)) {
+      state.blendConstants = DxvkBlendConstants {
+        m_state.om.blendFactor[0], m_state.om.blendFactor[1],
+        m_state.om.blendFactor[2], m_state.om.blendFactor[3] };
+    }
+
+    if (m_dirtyState.test(D3D11DirtyState::DepthStencilState))
+      state.dsState = m_state.om.dsState;
 
-    if (likely(inputLayout != nullptr)) {
+    if (m_dirtyState.test(D3D11DirtyState::StencilRef))
+      state.stencilRef = m_state.om.stencilRef;
+
+    if (m_dirtyState.test(D3D11DirtyState::RasterizerState))
+      state.rsState = m_state.rs.state;
+
+    if (m_dirtyState.test(D3D11DirtyState::RasterizerSampleCount))
+      state.sampleCount = GetRasterizerSampleCount();
+
+    // Viewport state is large, so only capture it when it
+    // actually changed, and avoid copying the full arrays
+    // in the common case of only one viewport being bound.
+    if (!m_dirtyState.test(D3D11DirtyState::ViewportState)) {
       EmitCs([
-        cInputLayout = std::move(inputLayout)
+        cState = std::move(state)
       ] (DxvkContext* ctx) {
-        cInputLayout->BindToContext(ctx);
+        ExecRenderState(ctx, cState);
       });
     } else {
-      EmitCs([] (DxvkContext* ctx) {
+      D3D11ViewportStateUpdate vpState;
+      GetViewportState(&vpState);
+
+      if (likely(vpState.viewportCount == 1)) {
+        EmitCs([
+          cState    = std::move(state),
+          cViewport = vpState.viewports[0],
+          cScissor  = vpState.scissors[0]
+        ] (DxvkContext* ctx) {
+          ExecRenderState(ctx, cState);
+
+          ctx->setViewports(1,
+            &cViewport,
+            &cScissor);
+        });
+      } else {
+        EmitCs([
+          cState    = std::move(state),
+          cVpState  = vpState
+        ] (DxvkContext* ctx) {
+          ExecRenderState(ctx, cState);
+
+          ctx->setViewports(
+            cVpState.viewportCount,
+            cVpState.viewports.data(),
+            cVpState.scissors.data());
+        });
+      }
+    }
+
+    m_dirtyState.clrAll();
+  }
+
+
+  template<typename ContextType>
+  void D3D11CommonContext<ContextType>::ExecRenderState(
+          DxvkContext*                      ctx,
+    const D3D11RenderStateUpdate&           State) {
+    if (State.flags.test(D3D11DirtyState::InputLayout)) {
+      if (likely(State.inputLayout != nullptr))
+        State.inputLayout->BindToContext(ctx);
+      else
         ctx->setInputLayout(0, nullptr, 0, nullptr);
-      });
+    }
+
+    if (State.flags.test(D3D11DirtyState::PrimitiveTopology))
+      ctx->setInputAssemblyState(State.iaState);
+
+    if (State.flags.test(D3D11DirtyState::BlendState)) {
+      if (State.cbState != nullptr) {
+        State.cbState->BindToContext(ctx, State.sampleMask);
+      } else {
+        DxvkBlendMode cbState;
+        DxvkLogicOpState loState;
+        DxvkMultisampleState msState;
+        InitDefaultBlendState(&cbState, &loState, &msState, State.sampleMask);
+
+        for (uint32_t i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; i++)
+          ctx->setBlendMode(i, cbState);
+
+        ctx->setLogicOpState(loState);
+        ctx->setMultisampleState(msState);
+      }
+    }
+
+    if (State.flags.test(D3D11DirtyState::BlendFactor))
+      ctx->setBlendConstants(State.blendConstants);
+
+    if (State.flags.test(D3D11DirtyState::DepthStencilState)) {
+      if (State.dsState != nullptr) {
+        State.dsState->BindToContext(ctx);
+      } else {
+        DxvkDepthStencilState dsState;
+        InitDefaultDepthStencilState(&dsState);
+
+        ctx->setDepthStencilState(dsState);
+      }
+    }
+
+    if (State.flags.test(D3D11DirtyState::StencilRef))
+      ctx->setStencilReference(State.stencilRef);
+
+    if (State.flags.test(D3D11DirtyState::RasterizerState)) {
+      if (State.rsState != nullptr) {
+        State.rsState->BindToContext(ctx);
+      } else {
+        DxvkRasterizerState rsState;
+        InitDefaultRasterizerState(&rsState);
+
+        ctx->setRasterizerState(rsState);
+      }
+    }
+
+    if (State.flags.test(D3D11DirtyState::RasterizerSampleCount)) {
+      DxbcPushConstants pc;
+      pc.rasterizerSampleCount = State.sampleCount;
+      ctx->pushConstants(0, sizeof(pc), &pc);
     }
   }
 
 
   template<typename ContextType>
-  void D3D11CommonContext<ContextType>::ApplyPrimitiveTopology() {
+  DxvkInputAssemblyState D3D11CommonContext<ContextType>::GetInputAssemblyState() const {
     D3D11_PRIMITIVE_TOPOLOGY topology = m_state.ia.primitiveTopology;
     DxvkInputAssemblyState iaState = { };
 
@@ -2876,125 +3247,50 @@ namespace dxvk {
       uint32_t vertexCount = uint32_t(topology - D3D11_PRIMITIVE_TOPOLOGY_1_CONTROL_POINT_PATCHLIST + 1);
       iaState = { VK_PRIMITIVE_TOPOLOGY_PATCH_LIST, VK_FALSE, vertexCount };
     }
-    
-    EmitCs([iaState] (DxvkContext* ctx) {
-      ctx->setInputAssemblyState(iaState);
-    });
-  }
-
-
-  template<typename ContextType>
-  void D3D11CommonContext<ContextType>::ApplyBlendState() {
-    if (m_state.om.cbState != nullptr) {
-      EmitCs([
-        cBlendState = m_state.om.cbState,
-        cSampleMask = m_state.om.sampleMask
-      ] (DxvkContext* ctx) {
-        cBlendState->BindToContext(ctx, cSampleMask);
-      });
-    } else {
-      EmitCs([
-        cSampleMask = m_state.om.sampleMask
-      ] (DxvkContext* ctx) {
-        DxvkBlendMode cbState;
-        DxvkLogicOpState loState;
-        DxvkMultisampleState msState;
-        InitDefaultBlendState(&cbState, &loState, &msState, cSampleMask);
 
-        for (uint32_t i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; i++)
-          ctx->setBlendMode(i, cbState);
-
-        ctx->setLogicOpState(loState);
-        ctx->setMultisampleState(msState);
-      });
-    }
+    return iaState;
   }
 
 
   template<typename ContextType>
-  void D3D11CommonContext<ContextType>::ApplyBlendFactor() {
-    EmitCs([
-      cBlendConstants = DxvkBlendConstants {
-        m_state.om.blendFactor[0], m_state.om.blendFactor[1],
-        m_state.om.blendFactor[2], m_state.om.blendFactor[3] }
-    ] (DxvkContext* ctx) {
-      ctx->setBlendConstants(cBlendConstants);
-    });
-  }
+  uint32_t D3D11CommonContext<ContextType>::GetRasterizerSampleCount() const {
+    uint32_t sampleCount = m_state.om.sampleCount;
 
+    if (unlikely(!sampleCount)) {
+      // The rasterizer state may have been unbound since
+      // the sample count was marked as dirty
+      if (m_state.rs.state != nullptr)
+        sampleCount = m_state.rs.state->Desc()->ForcedSampleCount;
 
-  template<typename ContextType>
-  void D3D11CommonContext<ContextType>::ApplyDepthStencilState() {
-    if (m_state.om.dsState != nullptr) {
-      EmitCs([
-        cDepthStencilState = m_state.om.dsState
-      ] (DxvkContext* ctx) {
-        cDepthStencilState->BindToContext(ctx);
-      });
-    } else {
-      EmitCs([] (DxvkContext* ctx) {
-        DxvkDepthStencilState dsState;
-        InitDefaultDepthStencilState(&dsState);
-
-        ctx->setDepthStencilState(dsState);
-      });
+      if (!sampleCount)
+        sampleCount = 1;
     }
-  }
-  
-  
-  template<typename ContextType>
-  void D3D11CommonContext<ContextType>::ApplyStencilRef() {
-    EmitCs([
-      cStencilRef = m_state.om.stencilRef
-    ] (DxvkContext* ctx) {
-      ctx->setStencilReference(cStencilRef);
-    });
-  }
-  
-  
-  template<typename ContextType>
-  void D3D11CommonContext<ContextType>::ApplyRasterizerState() {
-    if (m_state.rs.state != nullptr) {
-      EmitCs([
-        cRasterizerState = m_state.rs.state
-      ] (DxvkContext* ctx) {
-        cRasterizerState->BindToContext(ctx);
-      });
-    } else {
-      EmitCs([] (DxvkContext* ctx) {
-        DxvkRasterizerState rsState;
-        InitDefaultRasterizerState(&rsState);
 
-        ctx->setRasterizerState(rsState);
-      });
-    }
+    return sampleCount;
   }
 
 
   template<typename ContextType>
-  void D3D11CommonContext<ContextType>::ApplyRasterizerSampleCount() {
-    DxbcPushConstants pc;
-    pc.rasterizerSampleCount = m_state.om.sampleCount;
+  Rc<DxvkResource> D3D11CommonContext<ContextType>::GetTiledResource(
+          ID3D11Resource*                   pResource) const {
+    D3D11_COMMON_RESOURCE_DESC desc = { };
+    GetCommonResourceDesc(pResource, &desc);
 
-    if (unlikely(!m_state.om.sampleCount)) {
-      pc.rasterizerSampleCount = m_state.rs.state->Desc()->ForcedSampleCount;
+    if (!(desc.MiscFlags & D3D11_RESOURCE_MISC_TILED))
+      return nullptr;
 
-      if (!m_state.om.sampleCount)
-        pc.rasterizerSampleCount = 1;
-    }
+    if (desc.Dim == D3D11_RESOURCE_DIMENSION_BUFFER)
+      return static_cast<D3D11Buffer*>(pResource)->GetBuffer();
 
-    EmitCs([
-      cPushConstants = pc
-    ] (DxvkContext* ctx) {
-      ctx->pushConstants(0, sizeof(cPushConstants), &cPushConstants);
-    });
+    return GetCommonTexture(pResource)->GetImage();
   }
 
 
   template<typename ContextType>
-  void D3D11CommonContext<ContextType>::ApplyViewportState() {
-    std::array<VkViewport, D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE> viewports;
-    std::array<VkRect2D,   D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE> scissors;
+  void D3D11CommonContext<ContextType>::GetViewportState(
+          D3D11ViewportStateUpdate*         pState) const {
+    auto& viewports = pState->viewports;
+    auto& scissors  = pState->scissors;
 
     // The backend can't handle a viewport count of zero,
     // so we should at least specify one empty viewport
@@ -3006,6 +3302,9 @@ namespace dxvk {
       scissors [0] = VkRect2D();
     }
 
+    pState->viewportCount = viewportCount;
+
+
     // D3D11's coordinate system has its origin in the bottom left,
     // but the viewport coordinates are aligned to the top-left
     // corner so we can get away with flipping the viewport.
@@ -3059,28 +3358,6 @@ namespace dxvk {
         scissors[i] = VkRect2D { srPosA, srSize };
       }
     }
-
-    if (likely(viewportCount == 1)) {
-      EmitCs([
-        cViewport = viewports[0],
-        cScissor  = scissors[0]
-      ] (DxvkContext* ctx) {
-        ctx->setViewports(1,
-          &cViewport,
-          &cScissor);
-      });
-    } else {
-      EmitCs([
-        cViewportCount = viewportCount,
-        cViewports     = viewports,
-        cScissors      = scissors
-      ] (DxvkContext* ctx) {
-        ctx->setViewports(
-          cViewportCount,
-          cViewports.data(),
-          cScissors.data());
-      });
-    }
   }
 
 
@@ -3088,11 +3365,33 @@ namespace dxvk {
   template<DxbcProgramType ShaderStage>
   void D3D11CommonContext<ContextType>::BindShader(
     const D3D11CommonShader*    pShaderModule) {
-    if (pShaderModule) {
+    if (pShaderModule && unlikely(!pShaderModule->IsTranslated())) {
+      // Resolve the shader on the CS thread so that the application
+      // does not have to wait for shader translation to finish
+      EmitCs([
+        cDevice = m_device,
+        cModule = pShaderModule->GetModule()
+      ] (DxvkContext* ctx) {
+        constexpr VkShaderStageFlagBits stage = GetShaderStage(ShaderStage);
+
+        uint32_t slotId = computeConstantBufferBinding(ShaderStage,
+          D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT);
+
+        Rc<DxvkShader> shader = cModule->GetShader();
+
+        if (shader != nullptr && shader->needsLibraryCompile())
+          cDevice->requestCompileShader(shader);
+
+        ctx->bindShader<stage>(std::move(shader));
+        ctx->bindResourceBuffer(stage, slotId, cModule->GetIcb());
+      });
+    } else if (pShaderModule) {
       auto buffer = pShaderModule->GetIcb();
       auto shader = pShaderModule->GetShader();
 
-      if (unlikely(shader->needsLibraryCompile()))
+      // The shader is null if translation failed, in
+      // which case we just unbind the shader stage
+      if (unlikely(shader != nullptr && shader->needsLibraryCompile()))
         m_device->requestCompileShader(shader);
 
       EmitCs([
@@ -3157,7 +3456,7 @@ namespace dxvk {
     // If necessary, update push constant for the sample count
     if (m_state.om.sampleCount != sampleCount) {
       m_state.om.sampleCount = sampleCount;
-      ApplyRasterizerSampleCount();
+      m_dirtyState.set(D3D11DirtyState::RasterizerSampleCount);
     }
   }
 
@@ -3516,6 +3815,10 @@ namespace dxvk {
           D3D11Buffer*                      pSrcBuffer,
           VkDeviceSize                      SrcOffset,
           VkDeviceSize                      ByteCount) {
+    // Tile pools do not have any buffer to copy from or to
+    if (pDstBuffer->IsTilePool() || pSrcBuffer->IsTilePool())
+      return;
+
     // Clamp copy region to prevent out-of-bounds access
     VkDeviceSize dstLength = pDstBuffer->Desc()->ByteWidth;
     VkDeviceSize srcLength = pSrcBuffer->Desc()->ByteWidth;
@@ -3796,6 +4099,85 @@ namespace dxvk {
   }
 
 
+  template<typename ContextType>
+  void D3D11CommonContext<ContextType>::CopyTiledResourceData(
+          ID3D11Resource*                   pResource,
+    const D3D11_TILED_RESOURCE_COORDINATE*  pRegionCoordinate,
+    const D3D11_TILE_REGION_SIZE*           pRegionSize,
+          DxvkBufferSlice                   BufferSlice,
+          UINT                              Flags) {
+    Rc<DxvkResource> resource = GetTiledResource(pResource);
+
+    if (resource == nullptr)
+      return;
+
+    auto pageTable = resource->getSparsePageTable();
+
+    VkOffset3D regionOffset = {
+      int32_t(pRegionCoordinate->X),
+      int32_t(pRegionCoordinate->Y),
+      int32_t(pRegionCoordinate->Z) };
+
+    VkExtent3D regionExtent = {
+      pRegionSize->Width,
+      pRegionSize->Height,
+      pRegionSize->Depth };
+
+    if (pRegionSize->bUseBox && pRegionSize->NumTiles
+        != regionExtent.width * regionExtent.height * regionExtent.depth)
+      return;
+
+    // Tile i of the region maps to the i-th 64k block of the buffer
+    std::vector<uint32_t> pages(pRegionSize->NumTiles);
+
+    for (uint32_t i = 0; i < pRegionSize->NumTiles; i++) {
+      pages[i] = pageTable->computePageIndex(
+        pRegionCoordinate->Subresource, regionOffset,
+        regionExtent, !pRegionSize->bUseBox, i);
+
+      if (pages[i] == ~0u)
+        return;
+    }
+
+    bool toBuffer = Flags & D3D11_TILE_COPY_SWIZZLED_TILED_RESOURCE_TO_LINEAR_BUFFER;
+
+    D3D11_COMMON_RESOURCE_DESC desc = { };
+    GetCommonResourceDesc(pResource, &desc);
+
+    if (desc.Dim == D3D11_RESOURCE_DIMENSION_BUFFER) {
+      EmitCs([
+        cSparse       = static_cast<D3D11Buffer*>(pResource)->GetBuffer(),
+        cBufferSlice  = std::move(BufferSlice),
+        cPages        = std::move(pages),
+        cToBuffer     = toBuffer
+      ] (DxvkContext* ctx) {
+        if (cToBuffer) {
+          ctx->copySparsePagesToBuffer(cBufferSlice.buffer(),
+            cBufferSlice.offset(), cSparse, cPages.size(), cPages.data());
+        } else {
+          ctx->copySparsePagesFromBuffer(cSparse, cPages.size(), cPages.data(),
+            cBufferSlice.buffer(), cBufferSlice.offset());
+        }
+      });
+    } else {
+      EmitCs([
+        cSparse       = GetCommonTexture(pResource)->GetImage(),
+        cBufferSlice  = std::move(BufferSlice),
+        cPages        = std::move(pages),
+        cToBuffer     = toBuffer
+      ] (DxvkContext* ctx) {
+        if (cToBuffer) {
+          ctx->copySparsePagesToBuffer(cBufferSlice.buffer(),
+            cBufferSlice.offset(), cSparse, cPages.size(), cPages.data());
+        } else {
+          ctx->copySparsePagesFromBuffer(cSparse, cPages.size(), cPages.data(),
+            cBufferSlice.buffer(), cBufferSlice.offset());
+        }
+      });
+    }
+  }
+
+
   template<typename ContextType>
   void D3D11CommonContext<ContextType>::DiscardBuffer(
           ID3D11Resource*                   pResource) {
@@ -3916,6 +4298,9 @@ namespace dxvk {
 
   template<typename ContextType>
   void D3D11CommonContext<ContextType>::ResetCommandListState() {
+    // Any pending render state is overridden with defaults here
+    m_dirtyState.clrAll();
+
     EmitCs([
       cUsedBindings = GetMaxUsedBindings()
     ] (DxvkContext* ctx) {
@@ -4052,6 +4437,9 @@ namespace dxvk {
     m_state.srv.reset();
     m_state.uav.reset();
     m_state.samplers.reset();
+
+    // The backend is expected to use default state here
+    m_dirtyState.clrAll();
   }
 
 
@@ -4170,15 +4558,17 @@ namespace dxvk {
     BindShader<DxbcProgramType::PixelShader>(GetCommonShader(m_state.ps.ptr()));
     BindShader<DxbcProgramType::ComputeShader>(GetCommonShader(m_state.cs.ptr()));
 
-    ApplyInputLayout();
-    ApplyPrimitiveTopology();
-    ApplyBlendState();
-    ApplyBlendFactor();
-    ApplyDepthStencilState();
-    ApplyStencilRef();
-    ApplyRasterizerState();
-    ApplyRasterizerSampleCount();
-    ApplyViewportState();
+    // Render state gets applied lazily on the next draw
+    m_dirtyState.set(
+      D3D11DirtyState::InputLayout,
+      D3D11DirtyState::PrimitiveTopology,
+      D3D11DirtyState::BlendState,
+      D3D11DirtyState::BlendFactor,
+      D3D11DirtyState::DepthStencilState,
+      D3D11DirtyState::StencilRef,
+      D3D11DirtyState::RasterizerState,
+      D3D11DirtyState::RasterizerSampleCount,
+      D3D11DirtyState::ViewportState);
 
     BindDrawBuffers(
       m_state.id.argBuffer.ptr(),
@@ -4852,6 +5242,9 @@ namespace dxvk {
       const auto bufferResource = static_cast<D3D11Buffer*>(pDstResource);
       uint64_t bufferSize = bufferResource->Desc()->ByteWidth;
 
+      if (unlikely(bufferResource->IsTilePool()))
+        return;
+
       // Provide a fast path for mapped buffer updates since some
       // games use UpdateSubresource to update constant buffers.
       if (likely(bufferResource->GetMapMode() == D3D11_COMMON_BUFFER_MAP_MODE_DIRECT) && likely(!pDstBox)) {
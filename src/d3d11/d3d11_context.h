@@ -778,6 +778,8 @@ namespace dxvk {
     DxvkCsChunkRef              m_csChunk;
     D3D11CmdData*               m_cmdData;
 
+    D3D11DirtyStateFlags        m_dirtyState;
+
     DxvkCsChunkRef AllocCsChunk();
     
     DxvkDataSlice AllocUpdateBufferSlice(size_t Size);
@@ -785,23 +787,11 @@ namespace dxvk {
     DxvkBufferSlice AllocStagingBuffer(
             VkDeviceSize                      Size);
 
-    void ApplyInputLayout();
-    
-    void ApplyPrimitiveTopology();
-    
-    void ApplyBlendState();
-    
-    void ApplyBlendFactor();
-    
-    void ApplyDepthStencilState();
-    
-    void ApplyStencilRef();
-    
-    void ApplyRasterizerState();
-    
-    void ApplyRasterizerSampleCount();
+    void ApplyDirtyState();
 
-    void ApplyViewportState();
+    static void ExecRenderState(
+            DxvkContext*                      ctx,
+      const D3D11RenderStateUpdate&           State);
 
     template<DxbcProgramType ShaderStage>
     void BindShader(
@@ -890,6 +880,13 @@ namespace dxvk {
             VkOffset3D                        SrcOffset,
             VkExtent3D                        SrcExtent);
 
+    void CopyTiledResourceData(
+            ID3D11Resource*                   pResource,
+      const D3D11_TILED_RESOURCE_COORDINATE*  pRegionCoordinate,
+      const D3D11_TILE_REGION_SIZE*           pRegionSize,
+            DxvkBufferSlice                   BufferSlice,
+            UINT                              Flags);
+
     void DiscardBuffer(
             ID3D11Resource*                   pResource);
 
@@ -917,8 +914,18 @@ namespace dxvk {
             UINT                              NumSamplers,
             ID3D11SamplerState**              ppSamplers);
 
+    DxvkInputAssemblyState GetInputAssemblyState() const;
+
     D3D11MaxUsedBindings GetMaxUsedBindings();
 
+    uint32_t GetRasterizerSampleCount() const;
+
+    Rc<DxvkResource> GetTiledResource(
+            ID3D11Resource*                   pResource) const;
+
+    void GetViewportState(
+            D3D11ViewportStateUpdate*         pState) const;
+
     void ResetCommandListState();
 
     void ResetContextState();
@@ -171,6 +171,8 @@ namespace dxvk {
 
     // Make sure all commands are visible to the command list
     FlushCsChunk();
+
+    m_commandList->Finalize();
     
     if (ppCommandList)
       *ppCommandList = m_commandList.ref();
@@ -186,7 +188,7 @@ namespace dxvk {
     else
       ResetContextState();
     
-    m_mappedResources.clear();
+    ResetMapEntries();
     ResetStagingBuffer();
     return S_OK;
   }
@@ -412,29 +414,96 @@ namespace dxvk {
   D3D11DeferredContextMapEntry* D3D11DeferredContext::FindMapEntry(
           ID3D11Resource*               pResource,
           UINT                          Subresource) {
-    // Recently mapped resources as well as entries with
-    // up-to-date map infos will be located at the end
-    // of the resource array, so scan in reverse order.
-    size_t size = m_mappedResources.size();
-
-    for (size_t i = 1; i <= size; i++) {
-      auto entry = &m_mappedResources[size - i];
-
-      if (entry->Resource.Get()            == pResource
-       && entry->Resource.GetSubresource() == Subresource)
-        return entry;
-    }
+    if (m_mappedResources.empty())
+      return nullptr;
 
-    return nullptr;
+    uint32_t index = m_mappedResourceIndex[FindMapIndexSlot(pResource, Subresource)];
+    return index ? &m_mappedResources[index - 1] : nullptr;
   }
 
+
   void D3D11DeferredContext::AddMapEntry(
           ID3D11Resource*               pResource,
           UINT                          Subresource,
           D3D11_RESOURCE_DIMENSION      ResourceType,
     const D3D11_MAPPED_SUBRESOURCE&     MapInfo) {
+    // Keep the load factor at or below one half
+    if (2 * (m_mappedResources.size() + 1) > m_mappedResourceIndex.size())
+      RebuildMapIndex(std::max<size_t>(64, 2 * m_mappedResourceIndex.size()));
+
+    uint32_t& index = m_mappedResourceIndex[FindMapIndexSlot(pResource, Subresource)];
+
+    // Only the most recent map info of any given
+    // subresource is ever needed, so replace it
+    if (index) {
+      m_mappedResources[index - 1].MapInfo = MapInfo;
+      return;
+    }
+
     m_mappedResources.emplace_back(pResource,
       Subresource, ResourceType, MapInfo);
+    index = uint32_t(m_mappedResources.size());
+  }
+
+
+  void D3D11DeferredContext::ResetMapEntries() {
+    // Only clear the slots that are in use, since the index may be
+    // much larger than the number of entries in this command list.
+    // Go in reverse insertion order so that the probe sequence of
+    // each remaining entry is still intact when it is looked up.
+    for (size_t i = m_mappedResources.size(); i; i--) {
+      const auto& entry = m_mappedResources[i - 1];
+
+      size_t slot = FindMapIndexSlot(
+        entry.Resource.Get(),
+        entry.Resource.GetSubresource());
+
+      m_mappedResourceIndex[slot] = 0u;
+    }
+
+    m_mappedResources.clear();
+  }
+
+
+  void D3D11DeferredContext::RebuildMapIndex(
+          size_t                        Capacity) {
+    m_mappedResourceIndex.clear();
+    m_mappedResourceIndex.resize(Capacity, 0u);
+
+    for (size_t i = 0; i < m_mappedResources.size(); i++) {
+      const auto& entry = m_mappedResources[i];
+
+      size_t slot = FindMapIndexSlot(
+        entry.Resource.Get(),
+        entry.Resource.GetSubresource());
+
+      m_mappedResourceIndex[slot] = uint32_t(i + 1);
+    }
+  }
+
+
+  size_t D3D11DeferredContext::FindMapIndexSlot(
+          ID3D11Resource*               pResource,
+          UINT                          Subresource) const {
+    // Returns the slot that either holds the given
+    // subresource, or the first empty slot found
+    uint64_t key = uint64_t(reinterpret_cast<uintptr_t>(pResource))
+                 ^ (uint64_t(Subresource) * 0x9e3779b97f4a7c15ull);
+
+    size_t mask = m_mappedResourceIndex.size() - 1;
+    size_t slot = size_t((key * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+
+    while (uint32_t index = m_mappedResourceIndex[slot]) {
+      const auto& entry = m_mappedResources[index - 1];
+
+      if (entry.Resource.Get()            == pResource
+       && entry.Resource.GetSubresource() == Subresource)
+        break;
+
+      slot = (slot + 1) & mask;
+    }
+
+    return slot;
   }
 
 
@@ -84,10 +84,12 @@ namespace dxvk {
     // Command list that we're recording
     Com<D3D11CommandList> m_commandList;
     
-    // Info about currently mapped (sub)resources. Using a vector
-    // here is reasonable since there will usually only be a small
-    // number of mapped resources per command list.
+    // Info about currently mapped (sub)resources. Some engines map
+    // hundreds of dynamic buffers per command list, so entries are
+    // indexed by an open-addressing hash table that stores the
+    // array index plus one, with zero denoting an empty slot.
     std::vector<D3D11DeferredContextMapEntry> m_mappedResources;
+    std::vector<uint32_t>                     m_mappedResourceIndex;
     
     // Begun and ended queries, will also be stored in command list
     std::vector<Com<D3D11Query, false>> m_queriesBegun;
@@ -131,6 +133,15 @@ namespace dxvk {
             D3D11_RESOURCE_DIMENSION      ResourceType,
       const D3D11_MAPPED_SUBRESOURCE&     MapInfo);
 
+    void ResetMapEntries();
+
+    void RebuildMapIndex(
+            size_t                        Capacity);
+
+    size_t FindMapIndexSlot(
+            ID3D11Resource*               pResource,
+            UINT                          Subresource) const;
+
     static DxvkCsChunkFlags GetCsChunkFlags(
             D3D11Device*                  pDevice);
     
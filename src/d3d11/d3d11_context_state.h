@@ -347,4 +347,59 @@ namespace dxvk {
     uint32_t  soCount;
   };
 
+
+  /**
+   * \brief Dirty render state
+   *
+   * Fixed-function state that has been changed by the
+   * application, but not yet been sent to the CS thread.
+   */
+  enum class D3D11DirtyState : uint32_t {
+    InputLayout,
+    PrimitiveTopology,
+    BlendState,
+    BlendFactor,
+    DepthStencilState,
+    StencilRef,
+    RasterizerState,
+    RasterizerSampleCount,
+    ViewportState,
+  };
+
+  using D3D11DirtyStateFlags = Flags<D3D11DirtyState>;
+
+  /**
+   * \brief Render state update
+   *
+   * Stores all dirty fixed-function state except for viewports,
+   * so that it can be applied with one single CS command. Only
+   * members whose dirty flag is set are valid.
+   */
+  struct D3D11RenderStateUpdate {
+    D3D11DirtyStateFlags          flags;
+    Com<D3D11InputLayout, false>  inputLayout     = nullptr;
+    DxvkInputAssemblyState        iaState         = { };
+    D3D11BlendState*              cbState         = nullptr;
+    UINT                          sampleMask      = 0u;
+    DxvkBlendConstants            blendConstants  = { };
+    D3D11DepthStencilState*       dsState         = nullptr;
+    UINT                          stencilRef      = 0u;
+    D3D11RasterizerState*         rsState         = nullptr;
+    uint32_t                      sampleCount     = 0u;
+  };
+
+  /**
+   * \brief Viewport state update
+   *
+   * Stores viewports and scissor rects in the format expected
+   * by the backend. Kept separate from the remaining render
+   * state since it is large and changes less frequently.
+   */
+  struct D3D11ViewportStateUpdate {
+    uint32_t viewportCount = 0u;
+
+    std::array<VkViewport, D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE> viewports;
+    std::array<VkRect2D,   D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE> scissors;
+  };
+
 }
\ No newline at end of file
@@ -45,7 +45,8 @@ namespace dxvk {
     m_dxvkAdapter   (m_dxvkDevice->adapter()),
     m_d3d11Formats  (m_dxvkDevice),
     m_d3d11Options  (m_dxvkDevice->instance()->config(), m_dxvkDevice),
-    m_dxbcOptions   (m_dxvkDevice, m_d3d11Options) {
+    m_dxbcOptions   (m_dxvkDevice, m_d3d11Options),
+    m_tiledResourcesTier(DetermineTiledResourcesTier()) {
     m_initializer = new D3D11Initializer(this);
     m_context     = new D3D11ImmediateContext(this, m_dxvkDevice);
     m_d3d10Device = new D3D10Device(this, m_context.ptr());
@@ -89,6 +90,11 @@ namespace dxvk {
     if (FAILED(hr))
       return hr;
 
+    if (desc.MiscFlags & (D3D11_RESOURCE_MISC_TILED | D3D11_RESOURCE_MISC_TILE_POOL)) {
+      if (m_tiledResourcesTier == D3D11_TILED_RESOURCES_NOT_SUPPORTED || pInitialData)
+        return E_INVALIDARG;
+    }
+
     if (!ppBuffer)
       return S_FALSE;
     
@@ -131,6 +137,9 @@ namespace dxvk {
 
     if (FAILED(hr))
       return hr;
+
+    if (desc.MiscFlags & D3D11_RESOURCE_MISC_TILED)
+      return E_INVALIDARG;
     
     if (!ppTexture1D)
       return S_FALSE;
@@ -207,6 +216,11 @@ namespace dxvk {
 
     if (FAILED(hr))
       return hr;
+
+    if (desc.MiscFlags & D3D11_RESOURCE_MISC_TILED) {
+      if (m_tiledResourcesTier == D3D11_TILED_RESOURCES_NOT_SUPPORTED || pInitialData)
+        return E_INVALIDARG;
+    }
     
     if (!ppTexture2D)
       return S_FALSE;
@@ -282,6 +296,10 @@ namespace dxvk {
 
     if (FAILED(hr))
       return hr;
+
+    // Tiled 3D textures require Tier 3
+    if (desc.MiscFlags & D3D11_RESOURCE_MISC_TILED)
+      return E_INVALIDARG;
     
     if (!ppTexture3D)
       return S_FALSE;
@@ -1637,7 +1655,7 @@ namespace dxvk {
 
         // Min/Max filtering requires Tiled Resources Tier 2 for some reason,
         // so we cannot support it even though Vulkan exposes this feature
-        info->TiledResourcesTier                    = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
+        info->TiledResourcesTier                    = m_tiledResourcesTier;
         info->MinMaxFiltering                       = FALSE;
         info->ClearViewAlsoSupportsDepthOnlyFormats = TRUE;
         info->MapOnDefaultBuffers                   = TRUE;
@@ -1686,7 +1704,7 @@ namespace dxvk {
         info->ROVsSupported                  = FALSE;
         info->ConservativeRasterizationTier  = D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED;
         info->MapOnDefaultTextures           = TRUE;
-        info->TiledResourcesTier             = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
+        info->TiledResourcesTier             = m_tiledResourcesTier;
         info->StandardSwizzle                = FALSE;
         info->UnifiedMemoryArchitecture      = m_dxvkDevice->isUnifiedMemoryArchitecture();
 
@@ -1814,27 +1832,119 @@ namespace dxvk {
           UINT*                     pNumSubresourceTilings,
           UINT                      FirstSubresourceTilingToGet,
           D3D11_SUBRESOURCE_TILING* pSubresourceTilingsForNonPackedMips) {
-    static bool s_errorShown = false;
+    D3D11_COMMON_RESOURCE_DESC desc = { };
+    GetCommonResourceDesc(pTiledResource, &desc);
 
-    if (!std::exchange(s_errorShown, true))
-      Logger::err("D3D11Device::GetResourceTiling: Tiled resources not supported");
+    DxvkSparsePageTable* pageTable = nullptr;
+
+    if (desc.MiscFlags & D3D11_RESOURCE_MISC_TILED) {
+      if (desc.Dim == D3D11_RESOURCE_DIMENSION_BUFFER)
+        pageTable = static_cast<D3D11Buffer*>(pTiledResource)->GetBuffer()->getSparsePageTable();
+      else
+        pageTable = GetCommonTexture(pTiledResource)->GetImage()->getSparsePageTable();
+    }
+
+    if (!pageTable) {
+      if (pNumTilesForEntireResource)
+        *pNumTilesForEntireResource = 0;
+
+      if (pPackedMipDesc)
+        *pPackedMipDesc = D3D11_PACKED_MIP_DESC();
+
+      if (pStandardTileShapeForNonPackedMips)
+        *pStandardTileShapeForNonPackedMips = D3D11_TILE_SHAPE();
+
+      if (pNumSubresourceTilings) {
+        if (pSubresourceTilingsForNonPackedMips) {
+          for (uint32_t i = 0; i < *pNumSubresourceTilings; i++)
+            pSubresourceTilingsForNonPackedMips[i] = D3D11_SUBRESOURCE_TILING();
+        }
+
+        *pNumSubresourceTilings = 0;
+      }
+
+      return;
+    }
 
     if (pNumTilesForEntireResource)
-      *pNumTilesForEntireResource = 0;
+      *pNumTilesForEntireResource = pageTable->getPageCount();
+
+    if (desc.Dim == D3D11_RESOURCE_DIMENSION_BUFFER) {
+      // Buffers consist of one single subresource
+      // with no packed mips and a linear tile shape
+      if (pPackedMipDesc)
+        *pPackedMipDesc = D3D11_PACKED_MIP_DESC();
+
+      if (pStandardTileShapeForNonPackedMips) {
+        pStandardTileShapeForNonPackedMips->WidthInTexels  = uint32_t(SparseMemoryPageSize);
+        pStandardTileShapeForNonPackedMips->HeightInTexels = 1;
+        pStandardTileShapeForNonPackedMips->DepthInTexels  = 1;
+      }
+
+      if (pNumSubresourceTilings) {
+        uint32_t tilingCount = (*pNumSubresourceTilings && !FirstSubresourceTilingToGet) ? 1u : 0u;
+
+        if (tilingCount && pSubresourceTilingsForNonPackedMips) {
+          auto& tiling = pSubresourceTilingsForNonPackedMips[0];
+          tiling.WidthInTiles = pageTable->getPageCount();
+          tiling.HeightInTiles = 1;
+          tiling.DepthInTiles = 1;
+          tiling.StartTileIndexInOverallResource = 0;
+        }
+
+        *pNumSubresourceTilings = tilingCount;
+      }
+
+      return;
+    }
+
+    // Textures have their standard mips laid out per array layer,
+    // with each layer's mip tail following its standard mips
+    DxvkSparseImageProperties properties = pageTable->getProperties();
 
-    if (pPackedMipDesc)
-      *pPackedMipDesc = D3D11_PACKED_MIP_DESC();
+    if (pPackedMipDesc) {
+      uint32_t mipCount = GetCommonTexture(pTiledResource)->Desc()->MipLevels;
+      bool hasMipTail = properties.pagedMipCount < mipCount;
 
-    if (pStandardTileShapeForNonPackedMips)
-      *pStandardTileShapeForNonPackedMips = D3D11_TILE_SHAPE();
+      pPackedMipDesc->NumStandardMips = properties.pagedMipCount;
+      pPackedMipDesc->NumPackedMips = mipCount - properties.pagedMipCount;
+      pPackedMipDesc->NumTilesForPackedMips = properties.mipTailPageCount;
+      pPackedMipDesc->StartTileIndexInOverallResource = hasMipTail
+        ? pageTable->getSubresourceProperties(properties.pagedMipCount).pageIndex
+        : 0u;
+    }
+
+    if (pStandardTileShapeForNonPackedMips) {
+      pStandardTileShapeForNonPackedMips->WidthInTexels  = properties.pageRegionExtent.width;
+      pStandardTileShapeForNonPackedMips->HeightInTexels = properties.pageRegionExtent.height;
+      pStandardTileShapeForNonPackedMips->DepthInTexels  = properties.pageRegionExtent.depth;
+    }
 
     if (pNumSubresourceTilings) {
-      if (pSubresourceTilingsForNonPackedMips) {
-        for (uint32_t i = 0; i < *pNumSubresourceTilings; i++)
-          pSubresourceTilingsForNonPackedMips[i] = D3D11_SUBRESOURCE_TILING();
+      uint32_t subresourceCount = pageTable->getSubresourceCount();
+      uint32_t tilingCount = 0;
+
+      if (FirstSubresourceTilingToGet < subresourceCount)
+        tilingCount = std::min(*pNumSubresourceTilings, subresourceCount - FirstSubresourceTilingToGet);
+
+      for (uint32_t i = 0; i < tilingCount && pSubresourceTilingsForNonPackedMips; i++) {
+        auto subresource = pageTable->getSubresourceProperties(FirstSubresourceTilingToGet + i);
+        auto& tiling = pSubresourceTilingsForNonPackedMips[i];
+
+        if (subresource.isMipTail) {
+          tiling.WidthInTiles = 0;
+          tiling.HeightInTiles = 0;
+          tiling.DepthInTiles = 0;
+          tiling.StartTileIndexInOverallResource = D3D11_PACKED_TILE;
+        } else {
+          tiling.WidthInTiles = subresource.pageCount.width;
+          tiling.HeightInTiles = uint16_t(subresource.pageCount.height);
+          tiling.DepthInTiles = uint16_t(subresource.pageCount.depth);
+          tiling.StartTileIndexInOverallResource = subresource.pageIndex;
+        }
       }
 
-      *pNumSubresourceTilings = 0;
+      *pNumSubresourceTilings = tilingCount;
     }
   }
   
@@ -1968,6 +2078,10 @@ namespace dxvk {
     }
     
     if (featureLevel >= D3D_FEATURE_LEVEL_11_0) {
+      enabled.core.features.sparseBinding                         = supported.core.features.sparseBinding;
+      enabled.core.features.sparseResidencyBuffer                 = supported.core.features.sparseResidencyBuffer;
+      enabled.core.features.sparseResidencyImage2D                = supported.core.features.sparseResidencyImage2D;
+      enabled.core.features.sparseResidencyAliased                = supported.core.features.sparseResidencyAliased;
       enabled.core.features.drawIndirectFirstInstance             = VK_TRUE;
       enabled.core.features.fragmentStoresAndAtomics              = VK_TRUE;
       enabled.core.features.multiDrawIndirect                     = VK_TRUE;
@@ -1996,17 +2110,36 @@ namespace dxvk {
     if (pClassLinkage != nullptr)
       Logger::warn("D3D11Device::CreateShaderModule: Class linkage not supported");
 
+    // Shaders that export stencil reference values or viewport and layer
+    // indices from vertex stages must be validated against the device
+    // features, which requires the compiled shader. Stream output info
+    // is owned by the caller, so those shaders are translated right away.
+    bool needsValidation = !m_dxvkDevice->extensions().extShaderStencilExport
+      || !m_dxvkDevice->features().vk12.shaderOutputViewportIndex
+      || !m_dxvkDevice->features().vk12.shaderOutputLayer;
+
+    bool async = m_d3d11Options.asyncShaderTranslation
+      && !needsValidation && !pModuleInfo->xfb;
+
     D3D11CommonShader commonShader;
 
     HRESULT hr = m_shaderModules.GetShaderModule(this,
       &ShaderKey, pModuleInfo, pShaderBytecode, BytecodeLength,
-      &commonShader);
+      async, &commonShader);
 
     if (FAILED(hr))
       return hr;
 
+    if (async) {
+      *pShaderModule = std::move(commonShader);
+      return S_OK;
+    }
+
     auto shader = commonShader.GetShader();
 
+    if (shader == nullptr)
+      return E_INVALIDARG;
+
     if (shader->flags().test(DxvkShaderFlag::ExportsStencilRef)
      && !m_dxvkDevice->extensions().extShaderStencilExport)
       return E_INVALIDARG;
@@ -2417,6 +2550,26 @@ namespace dxvk {
   }
 
 
+  D3D11_TILED_RESOURCES_TIER D3D11Device::DetermineTiledResourcesTier() const {
+    const auto& features = m_dxvkDevice->features().core.features;
+    const auto& properties = m_dxvkDevice->properties().core.properties.sparseProperties;
+
+    // Sparse features are only enabled on feature level 11_0
+    // and up, and only if the graphics queue supports binding.
+    // We need the standard block shape so that the tile shapes
+    // match what D3D applications expect. Higher tiers would
+    // require defined behaviour for unmapped tiles and more.
+    if (!features.sparseBinding
+     || !features.sparseResidencyBuffer
+     || !features.sparseResidencyImage2D
+     || !features.sparseResidencyAliased
+     || !properties.residencyStandard2DBlockShape)
+      return D3D11_TILED_RESOURCES_NOT_SUPPORTED;
+
+    return D3D11_TILED_RESOURCES_TIER_1;
+  }
+
+
   D3D_FEATURE_LEVEL D3D11Device::GetMaxFeatureLevel(const Rc<DxvkInstance>& pInstance) {
     static const std::array<std::pair<std::string, D3D_FEATURE_LEVEL>, 9> s_featureLevels = {{
       { "12_1", D3D_FEATURE_LEVEL_12_1 },
@@ -442,6 +442,8 @@ namespace dxvk {
     const DXGIVkFormatTable         m_d3d11Formats;
     const D3D11Options              m_d3d11Options;
     const DxbcOptions               m_dxbcOptions;
+
+    D3D11_TILED_RESOURCES_TIER      m_tiledResourcesTier;
     
     DxvkCsChunkPool                 m_csChunkPool;
     
@@ -491,6 +493,8 @@ namespace dxvk {
             UINT                        Subresource,
       const D3D11_BOX*                  pBox);
     
+    D3D11_TILED_RESOURCES_TIER DetermineTiledResourcesTier() const;
+
     static D3D_FEATURE_LEVEL GetMaxFeatureLevel(
       const Rc<DxvkInstance>&           pInstance);
     
@@ -30,6 +30,11 @@ namespace dxvk {
   void D3D11Initializer::InitBuffer(
           D3D11Buffer*                pBuffer,
     const D3D11_SUBRESOURCE_DATA*     pInitialData) {
+    // Tiled buffers have no memory bound initially,
+    // and tile pools do not have a buffer at all
+    if (pBuffer->Desc()->MiscFlags & (D3D11_RESOURCE_MISC_TILED | D3D11_RESOURCE_MISC_TILE_POOL))
+      return;
+
     VkMemoryPropertyFlags memFlags = pBuffer->GetBuffer()->memFlags();
 
     (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
@@ -41,9 +46,12 @@ namespace dxvk {
   void D3D11Initializer::InitTexture(
           D3D11CommonTexture*         pTexture,
     const D3D11_SUBRESOURCE_DATA*     pInitialData) {
-    (pTexture->GetMapMode() == D3D11_COMMON_TEXTURE_MAP_MODE_DIRECT)
-      ? InitHostVisibleTexture(pTexture, pInitialData)
-      : InitDeviceLocalTexture(pTexture, pInitialData);
+    if (pTexture->Desc()->MiscFlags & D3D11_RESOURCE_MISC_TILED)
+      InitTiledTexture(pTexture);
+    else if (pTexture->GetMapMode() == D3D11_COMMON_TEXTURE_MAP_MODE_DIRECT)
+      InitHostVisibleTexture(pTexture, pInitialData);
+    else
+      InitDeviceLocalTexture(pTexture, pInitialData);
   }
 
 
@@ -56,6 +64,7 @@ namespace dxvk {
 
     std::lock_guard<dxvk::mutex> lock(m_mutex);
     m_transferCommands += 1;
+    m_resourceCount    += 1;
 
     const uint32_t zero = 0;
     m_context->updateBuffer(
@@ -72,6 +81,7 @@ namespace dxvk {
     std::lock_guard<dxvk::mutex> lock(m_mutex);
 
     DxvkBufferSlice bufferSlice = pBuffer->GetBufferSlice();
+    m_resourceCount += 1;
 
     if (pInitialData != nullptr && pInitialData->pSysMem != nullptr) {
       m_transferMemory   += bufferSlice.length();
@@ -125,6 +135,8 @@ namespace dxvk {
     VkFormat packedFormat = m_parent->LookupPackedFormat(desc->Format, pTexture->GetFormatMode()).Format;
     auto formatInfo = lookupFormatInfo(packedFormat);
 
+    m_resourceCount += 1;
+
     if (pInitialData != nullptr && pInitialData->pSysMem != nullptr) {
       // pInitialData is an array that stores an entry for
       // every single subresource. Since we will define all
@@ -201,6 +213,21 @@ namespace dxvk {
   }
 
 
+  void D3D11Initializer::InitTiledTexture(
+          D3D11CommonTexture*         pTexture) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    // No memory is bound to the image yet, so we
+    // can only transition it to its default layout
+    m_context->initSparseImage(pTexture->GetImage());
+
+    m_transferCommands += 1;
+    m_resourceCount    += 1;
+
+    FlushImplicit();
+  }
+
+
   void D3D11Initializer::InitHostVisibleTexture(
           D3D11CommonTexture*         pTexture,
     const D3D11_SUBRESOURCE_DATA*     pInitialData) {
@@ -249,6 +276,7 @@ namespace dxvk {
     m_context->initImage(image, subresources, VK_IMAGE_LAYOUT_PREINITIALIZED);
 
     m_transferCommands += 1;
+    m_resourceCount    += 1;
     FlushImplicit();
   }
 
@@ -261,10 +289,17 @@ namespace dxvk {
 
 
   void D3D11Initializer::FlushInternal() {
+    // Buffer zero-fills and uploads as well as image uploads
+    // are recorded into the context's transfer command buffer,
+    // with one set of barriers for the entire batch.
     m_context->flushCommandList();
+
+    Logger::debug(str::format("D3D11: Initialized ", m_resourceCount,
+      " resources (", m_transferMemory >> 10, " kB) in one batch"));
     
     m_transferCommands = 0;
     m_transferMemory   = 0;
+    m_resourceCount    = 0;
   }
 
 }
\ No newline at end of file
@@ -48,6 +48,7 @@ namespace dxvk {
 
     size_t            m_transferCommands  = 0;
     size_t            m_transferMemory    = 0;
+    size_t            m_resourceCount     = 0;
 
     void InitDeviceLocalBuffer(
             D3D11Buffer*                pBuffer,
@@ -64,6 +65,9 @@ namespace dxvk {
     void InitHostVisibleTexture(
             D3D11CommonTexture*         pTexture,
       const D3D11_SUBRESOURCE_DATA*     pInitialData);
+
+    void InitTiledTexture(
+            D3D11CommonTexture*         pTexture);
     
     void FlushImplicit();
     void FlushInternal();
@@ -103,6 +103,11 @@ namespace dxvk {
     /// for a single window that may interfere with each other.
     bool deferSurfaceCreation;
 
+    /// Translates shaders on worker threads rather than on the
+    /// thread that creates them. Shaders that are used before
+    /// translation has finished get translated on first use.
+    bool asyncShaderTranslation;
+
     /// Forces the sample count of all textures to be 1, and
     /// performs the required shader and resolve fixups.
     bool disableMsaa;
@@ -3,6 +3,122 @@
 
 namespace dxvk {
   
+  D3D11ShaderModule::D3D11ShaderModule(
+    const Rc<DxvkDevice>&       device,
+    const DxvkShaderKey&        shaderKey,
+    const DxbcModuleInfo&       moduleInfo,
+    const DxbcModule&           module,
+          bool                  passthrough)
+  : m_device      (device),
+    m_key         (shaderKey),
+    m_info        (moduleInfo),
+    m_module      (module),
+    m_passthrough (passthrough) {
+    // Tessellation info is owned by the caller, so we need
+    // to copy it in case translation happens asynchronously
+    if (moduleInfo.tess) {
+      m_tess = *moduleInfo.tess;
+      m_info.tess = &m_tess;
+    }
+  }
+
+
+  D3D11ShaderModule::~D3D11ShaderModule() {
+
+  }
+
+
+  bool D3D11ShaderModule::Translate() {
+    D3D11ShaderModuleStatus expected = D3D11ShaderModuleStatus::Pending;
+
+    if (!m_status.compare_exchange_strong(expected,
+        D3D11ShaderModuleStatus::Translating, std::memory_order_acquire))
+      return false;
+
+    try {
+      CreateShader();
+    } catch (const DxvkError& e) {
+      Logger::err(e.message());
+
+      m_shader = nullptr;
+      m_buffer = nullptr;
+    }
+
+    // The DXBC module is no longer needed at this point
+    m_module.reset();
+    m_info.xfb = nullptr;
+
+    { std::unique_lock<dxvk::mutex> lock(m_mutex);
+      m_status.store(D3D11ShaderModuleStatus::Translated, std::memory_order_release);
+    }
+
+    m_cond.notify_all();
+    return true;
+  }
+
+
+  void D3D11ShaderModule::WaitForTranslation() {
+    if (likely(IsTranslated()))
+      return;
+
+    // Translate the shader ourselves if no worker has
+    // started yet, rather than waiting for the queue
+    if (Translate())
+      return;
+
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+    m_cond.wait(lock, [this] {
+      return IsTranslated();
+    });
+  }
+
+
+  void D3D11ShaderModule::CreateShader() {
+    const std::string name = m_key.toString();
+    Logger::debug(str::format("Compiling shader ", name));
+
+    m_shader = m_passthrough
+      ? m_module->compilePassthroughShader(m_info, name)
+      : m_module->compile                 (m_info, name);
+    m_shader->setShaderKey(m_key);
+    
+    // If requested by the user, dump the compiled SPIR-V module
+    const std::string dumpPath = env::getEnvVar("DXVK_SHADER_DUMP_PATH");
+
+    if (dumpPath.size() != 0) {
+      std::ofstream dumpStream(
+        str::topath(str::format(dumpPath, "/", name, ".spv").c_str()).c_str(),
+        std::ios_base::binary | std::ios_base::trunc);
+      
+      m_shader->dump(dumpStream);
+    }
+    
+    // Create shader constant buffer if necessary
+    const DxvkShaderCreateInfo& shaderInfo = m_shader->info();
+
+    if (shaderInfo.uniformSize) {
+      DxvkBufferCreateInfo info;
+      info.size   = shaderInfo.uniformSize;
+      info.usage  = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+      info.stages = util::pipelineStages(shaderInfo.stage);
+      info.access = VK_ACCESS_UNIFORM_READ_BIT;
+      
+      VkMemoryPropertyFlags memFlags
+        = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+        | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+      
+      m_buffer = m_device->createBuffer(info, memFlags);
+      std::memcpy(m_buffer->mapPtr(0), shaderInfo.uniformData, shaderInfo.uniformSize);
+    }
+
+    // Registering the shader kicks off the pipeline library
+    // compile, so do this as soon as translation is done
+    m_device->registerShader(m_shader);
+  }
+
+
   D3D11CommonShader:: D3D11CommonShader() { }
   D3D11CommonShader::~D3D11CommonShader() { }
   
@@ -14,16 +130,16 @@ namespace dxvk {
     const void*           pShaderBytecode,
           size_t          BytecodeLength) {
     const std::string name = pShaderKey->toString();
-    Logger::debug(str::format("Compiling shader ", name));
     
     DxbcReader reader(
       reinterpret_cast<const char*>(pShaderBytecode),
       BytecodeLength);
     
     DxbcModule module(reader);
+    module.validate();
     
-    // If requested by the user, dump both the raw DXBC
-    // shader and the compiled SPIR-V module to a file.
+    // If requested by the user, dump the raw DXBC shader to a
+    // file. The SPIR-V module gets dumped after translation.
     const std::string dumpPath = env::getEnvVar("DXVK_SHADER_DUMP_PATH");
     
     if (dumpPath.size() != 0) {
@@ -40,44 +156,19 @@ namespace dxvk {
     if (module.programInfo().shaderStage() != pShaderKey->type() && !passthroughShader)
       throw DxvkError("Mismatching shader type.");
 
-    m_shader = passthroughShader
-      ? module.compilePassthroughShader(*pDxbcModuleInfo, name)
-      : module.compile                 (*pDxbcModuleInfo, name);
-    m_shader->setShaderKey(*pShaderKey);
-    
-    if (dumpPath.size() != 0) {
-      std::ofstream dumpStream(
-        str::topath(str::format(dumpPath, "/", name, ".spv").c_str()).c_str(),
-        std::ios_base::binary | std::ios_base::trunc);
-      
-      m_shader->dump(dumpStream);
-    }
-    
-    // Create shader constant buffer if necessary
-    const DxvkShaderCreateInfo& shaderInfo = m_shader->info();
+    m_module = new D3D11ShaderModule(pDevice->GetDXVKDevice(),
+      *pShaderKey, *pDxbcModuleInfo, module, passthroughShader);
+  }
 
-    if (shaderInfo.uniformSize) {
-      DxvkBufferCreateInfo info;
-      info.size   = shaderInfo.uniformSize;
-      info.usage  = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-      info.stages = util::pipelineStages(shaderInfo.stage);
-      info.access = VK_ACCESS_UNIFORM_READ_BIT;
-      
-      VkMemoryPropertyFlags memFlags
-        = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-        | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-        | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-      
-      m_buffer = pDevice->GetDXVKDevice()->createBuffer(info, memFlags);
-      std::memcpy(m_buffer->mapPtr(0), shaderInfo.uniformData, shaderInfo.uniformSize);
-    }
+  
+  D3D11ShaderModuleSet::D3D11ShaderModuleSet() {
 
-    pDevice->GetDXVKDevice()->registerShader(m_shader);
   }
 
-  
-  D3D11ShaderModuleSet:: D3D11ShaderModuleSet() { }
-  D3D11ShaderModuleSet::~D3D11ShaderModuleSet() { }
+
+  D3D11ShaderModuleSet::~D3D11ShaderModuleSet() {
+    StopWorkers();
+  }
   
   
   HRESULT D3D11ShaderModuleSet::GetShaderModule(
@@ -86,6 +177,7 @@ namespace dxvk {
     const DxbcModuleInfo*     pDxbcModuleInfo,
     const void*               pShaderBytecode,
           size_t              BytecodeLength,
+          bool                Async,
           D3D11CommonShader*  pShader) {
     // Use the shader's unique key for the lookup
     { std::unique_lock<dxvk::mutex> lock(m_mutex);
@@ -108,6 +200,12 @@ namespace dxvk {
       Logger::err(e.message());
       return E_INVALIDARG;
     }
+
+    // Translate synchronously if the caller needs to validate the
+    // compiled shader. Otherwise, translation errors are logged by
+    // the worker and the shader will fail to bind later on.
+    if (!Async && module.GetShader() == nullptr)
+      return E_INVALIDARG;
     
     // Insert the new module into the lookup table. If another thread
     // has compiled the same shader in the meantime, we should return
@@ -121,8 +219,87 @@ namespace dxvk {
       }
     }
     
+    if (Async)
+      QueueTranslation(module.GetModule());
+
     *pShader = std::move(module);
     return S_OK;
   }
+
+
+  void D3D11ShaderModuleSet::QueueTranslation(
+    const Rc<D3D11ShaderModule>&      module) {
+    std::unique_lock<dxvk::mutex> lock(m_queueLock);
+    StartWorkers();
+
+    m_queue.push(module);
+    m_queueCond.notify_one();
+  }
+
+
+  void D3D11ShaderModuleSet::StartWorkers() {
+    if (m_workersRunning)
+      return;
+
+    // Translation is fairly cheap compared to pipeline compilation,
+    // so leave some room for the application and pipeline workers
+    uint32_t workerCount = dxvk::thread::hardware_concurrency() / 2;
+
+    if (workerCount < 1) workerCount = 1;
+    if (workerCount > 8) workerCount = 8;
+
+    Logger::info(str::format("D3D11: Using ", workerCount, " shader translation threads"));
+
+    m_workersRunning = true;
+    m_workers.resize(workerCount);
+
+    for (size_t i = 0; i < m_workers.size(); i++)
+      m_workers[i] = dxvk::thread([this] { RunWorker(); });
+  }
+
+
+  void D3D11ShaderModuleSet::StopWorkers() {
+    { std::unique_lock<dxvk::mutex> lock(m_queueLock);
+
+      if (!m_workersRunning)
+        return;
+
+      m_workersRunning = false;
+      m_queueCond.notify_all();
+    }
+
+    for (auto& worker : m_workers)
+      worker.join();
+
+    m_workers.clear();
+  }
+
+
+  void D3D11ShaderModuleSet::RunWorker() {
+    env::setThreadName("dxvk-dxbc");
+
+    while (true) {
+      Rc<D3D11ShaderModule> module;
+
+      { std::unique_lock<dxvk::mutex> lock(m_queueLock);
+
+        m_queueCond.wait(lock, [this] {
+          return !m_workersRunning || !m_queue.empty();
+        });
+
+        // Any shaders left in the queue will
+        // be translated on first use instead
+        if (!m_workersRunning)
+          break;
+
+        module = std::move(m_queue.front());
+        m_queue.pop();
+      }
+
+      // Does nothing if the shader has already
+      // been translated by the thread using it
+      module->Translate();
+    }
+  }
   
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
+#include <optional>
+#include <queue>
 #include <unordered_map>
 
 #include "../dxbc/dxbc_module.h"
@@ -10,6 +13,7 @@
 
 #include "../util/sha1/sha1_util.h"
 
+#include "../util/thread.h"
 #include "../util/util_env.h"
 
 #include "d3d11_device_child.h"
@@ -19,11 +23,115 @@ namespace dxvk {
   
   class D3D11Device;
   
+  /**
+   * \brief Shader module translation status
+   */
+  enum class D3D11ShaderModuleStatus : uint32_t {
+    Pending     = 0,
+    Translating = 1,
+    Translated  = 2,
+  };
+
+
+  /**
+   * \brief Shader module
+   *
+   * Stores a parsed DXBC module until it gets translated
+   * to SPIR-V. Translation is performed either by a shader
+   * translation worker, or by the first thread that needs
+   * the compiled shader, whichever comes first.
+   */
+  class D3D11ShaderModule : public RcObject {
+
+  public:
+
+    D3D11ShaderModule(
+      const Rc<DxvkDevice>&       device,
+      const DxvkShaderKey&        shaderKey,
+      const DxbcModuleInfo&       moduleInfo,
+      const DxbcModule&           module,
+            bool                  passthrough);
+
+    ~D3D11ShaderModule();
+
+    /**
+     * \brief Checks whether translation has finished
+     *
+     * If this returns \c true, the compiled shader
+     * can be queried without blocking.
+     * \returns \c true if the shader is translated
+     */
+    bool IsTranslated() const {
+      return m_status.load(std::memory_order_acquire)
+          == D3D11ShaderModuleStatus::Translated;
+    }
+
+    /**
+     * \brief Translates the shader
+     *
+     * Does nothing if another thread has already
+     * started translating the shader. Stream output
+     * info, if any, must remain valid until this
+     * has been called.
+     * \returns \c true if this call translated the shader
+     */
+    bool Translate();
+
+    /**
+     * \brief Retrieves compiled shader
+     *
+     * Translates the shader on the calling thread if no
+     * worker has picked it up yet, or waits for the
+     * worker to finish otherwise.
+     * \returns Compiled shader, or \c nullptr if
+     *    the shader failed to compile.
+     */
+    Rc<DxvkShader> GetShader() {
+      WaitForTranslation();
+      return m_shader;
+    }
+
+    /**
+     * \brief Retrieves immediate constant buffer
+     * \returns Immediate constant buffer, if any
+     */
+    DxvkBufferSlice GetIcb() {
+      WaitForTranslation();
+
+      return m_buffer != nullptr
+        ? DxvkBufferSlice(m_buffer)
+        : DxvkBufferSlice();
+    }
+
+  private:
+
+    Rc<DxvkDevice>                        m_device;
+    DxvkShaderKey                         m_key;
+    DxbcModuleInfo                        m_info;
+    DxbcTessInfo                          m_tess;
+    std::optional<DxbcModule>             m_module;
+    bool                                  m_passthrough;
+
+    std::atomic<D3D11ShaderModuleStatus>  m_status = { D3D11ShaderModuleStatus::Pending };
+
+    dxvk::mutex                           m_mutex;
+    dxvk::condition_variable              m_cond;
+
+    Rc<DxvkShader>                        m_shader;
+    Rc<DxvkBuffer>                        m_buffer;
+
+    void WaitForTranslation();
+
+    void CreateShader();
+
+  };
+
+
   /**
    * \brief Common shader object
    * 
-   * Stores the compiled SPIR-V shader and the SHA-1
-   * hash of the original DXBC shader, which can be
+   * Stores the shader module and the SHA-1 hash
+   * of the original DXBC shader, which can be
    * used to identify the shader.
    */
   class D3D11CommonShader {
@@ -39,24 +147,25 @@ namespace dxvk {
             size_t          BytecodeLength);
     ~D3D11CommonShader();
 
+    Rc<D3D11ShaderModule> GetModule() const {
+      return m_module;
+    }
+
+    bool IsTranslated() const {
+      return m_module->IsTranslated();
+    }
+
     Rc<DxvkShader> GetShader() const {
-      return m_shader;
+      return m_module->GetShader();
     }
 
     DxvkBufferSlice GetIcb() const {
-      return m_buffer != nullptr
-        ? DxvkBufferSlice(m_buffer)
-        : DxvkBufferSlice();
-    }
-    
-    std::string GetName() const {
-      return m_shader->debugName();
+      return m_module->GetIcb();
     }
     
   private:
     
-    Rc<DxvkShader> m_shader;
-    Rc<DxvkBuffer> m_buffer;
+    Rc<D3D11ShaderModule> m_module;
     
   };
   
@@ -130,6 +239,11 @@ namespace dxvk {
    * times, so we should cache the resulting shader modules
    * and reuse them rather than creating new ones. This
    * class is thread-safe.
+   *
+   * Shaders can optionally be translated asynchronously on
+   * a set of worker threads, so that applications creating
+   * large numbers of shaders at load time do not have to
+   * wait for the DXBC to SPIR-V translation to finish.
    */
   class D3D11ShaderModuleSet {
     
@@ -144,6 +258,7 @@ namespace dxvk {
       const DxbcModuleInfo*     pDxbcModuleInfo,
       const void*               pShaderBytecode,
             size_t              BytecodeLength,
+            bool                Async,
             D3D11CommonShader*  pShader);
     
   private:
@@ -154,6 +269,22 @@ namespace dxvk {
       DxvkShaderKey,
       D3D11CommonShader,
       DxvkHash, DxvkEq> m_modules;
+
+    dxvk::mutex                         m_queueLock;
+    dxvk::condition_variable            m_queueCond;
+    std::queue<Rc<D3D11ShaderModule>>   m_queue;
+
+    bool                                m_workersRunning = false;
+    std::vector<dxvk::thread>           m_workers;
+
+    void QueueTranslation(
+      const Rc<D3D11ShaderModule>&      module);
+
+    void StartWorkers();
+
+    void StopWorkers();
+
+    void RunWorker();
     
   };
   
@@ -557,6 +557,16 @@ namespace dxvk {
         ReleaseSemaphore(cFrameLatencyEvent, 1, nullptr);
       });
     }
+
+    // Delay the next frame so that it does not queue up behind
+    // previous frames on the GPU. The present is submitted from
+    // the CS thread, so wait for it to reach the submission queue
+    // first, otherwise the estimate would not include this frame.
+    // Errors are handled by SynchronizePresent on the next present.
+    if (m_device->config().latencyPacing) {
+      m_device->waitForSubmission(&m_presentStatus);
+      m_presenter->delayFrameStart(m_device->getLatencyStats().idleTime);
+    }
   }
 
 
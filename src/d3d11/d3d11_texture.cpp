@@ -139,6 +139,15 @@ namespace dxvk {
     if (Dimension == D3D11_RESOURCE_DIMENSION_TEXTURE3D &&
         (m_desc.BindFlags & D3D11_BIND_RENDER_TARGET))
       imageInfo.flags |= VK_IMAGE_CREATE_2D_ARRAY_COMPATIBLE_BIT;
+
+    // Memory for tiled textures is provided by tile pools. Sparse
+    // images require optimal tiling, so creation will fail below
+    // if the format does not support that.
+    if (m_desc.MiscFlags & D3D11_RESOURCE_MISC_TILED) {
+      imageInfo.flags |= VK_IMAGE_CREATE_SPARSE_BINDING_BIT
+                      |  VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT
+                      |  VK_IMAGE_CREATE_SPARSE_ALIASED_BIT;
+    }
     
     // Swap chain back buffers need to be shader readable
     if (DxgiUsage & DXGI_USAGE_BACK_BUFFER) {
@@ -190,6 +199,18 @@ namespace dxvk {
     // render target capabilities if available, but these
     // should in no way affect the default image layout
     imageInfo.usage |= EnableMetaCopyUsage(imageInfo.format, imageInfo.tiling);
+
+    // Enable storage usage for images that need mip generation if
+    // requested, so that all levels can be generated in one dispatch
+    if (m_desc.MiscFlags & D3D11_RESOURCE_MISC_GENERATE_MIPS) {
+      VkImageUsageFlags mipGenUsage = DxvkMetaMipGenComputePass::getImageUsage(
+        m_device->GetDXVKDevice().ptr(), imageInfo.format, imageInfo.tiling);
+
+      if (mipGenUsage && (imageInfo.flags & VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT))
+        imageInfo.flags |= VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+
+      imageInfo.usage |= mipGenUsage;
+    }
     imageInfo.usage |= EnableMetaPackUsage(imageInfo.format, m_desc.CPUAccessFlags);
     
     // Check if we can actually create the image
@@ -415,8 +436,21 @@ namespace dxvk {
                          != (D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET))
       return E_INVALIDARG;
 
-    // TILE_POOL is invalid, but we don't support TILED either
-    if (pDesc->MiscFlags & (D3D11_RESOURCE_MISC_TILE_POOL | D3D11_RESOURCE_MISC_TILED))
+    // TILE_POOL is only valid for buffers
+    if (pDesc->MiscFlags & D3D11_RESOURCE_MISC_TILE_POOL)
+      return E_INVALIDARG;
+
+    // Tiled textures must be default textures without
+    // CPU access, and cannot be shared or multisampled
+    if ((pDesc->MiscFlags & D3D11_RESOURCE_MISC_TILED)
+     && ((pDesc->Usage != D3D11_USAGE_DEFAULT)
+      || (pDesc->CPUAccessFlags)
+      || (pDesc->SampleDesc.Count != 1)
+      || (pDesc->MiscFlags & (D3D11_RESOURCE_MISC_GENERATE_MIPS
+                            | D3D11_RESOURCE_MISC_SHARED
+                            | D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX
+                            | D3D11_RESOURCE_MISC_SHARED_NTHANDLE
+                            | D3D11_RESOURCE_MISC_GDI_COMPATIBLE))))
       return E_INVALIDARG;
 
     // Use the maximum possible mip level count if the supplied
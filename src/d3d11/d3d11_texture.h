@@ -410,7 +410,7 @@ namespace dxvk {
     VkImageUsageFlags EnableMetaCopyUsage(
             VkFormat              Format,
             VkImageTiling         Tiling) const;
-    
+
     VkImageUsageFlags EnableMetaPackUsage(
             VkFormat              Format,
             UINT                  CpuAccess) const;
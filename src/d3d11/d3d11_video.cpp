@@ -3,6 +3,7 @@
 #include "d3d11_context_imm.h"
 #include "d3d11_video.h"
 
+#include <d3d11_video_blit_comp.h>
 #include <d3d11_video_blit_frag.h>
 #include <d3d11_video_blit_vert.h>
 
@@ -147,7 +148,7 @@ namespace dxvk {
       DxvkImageCreateInfo info = dxvkImage->info();
       info.flags  = VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
       info.usage  = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-      info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+      info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
       info.access = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
       info.tiling = VK_IMAGE_TILING_OPTIMAL;
       info.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -281,8 +282,25 @@ namespace dxvk {
         throw DxvkError("Invalid view dimension");
     }
 
-    m_view = pDevice->GetDXVKDevice()->createImageView(
-      GetCommonTexture(pResource)->GetImage(), viewInfo);
+    Rc<DxvkImage> dxvkImage = GetCommonTexture(pResource)->GetImage();
+    m_view = pDevice->GetDXVKDevice()->createImageView(dxvkImage, viewInfo);
+
+    // If the output image can be used as a storage image, create an
+    // additional view for it so that the video processor can write
+    // it with a compute shader rather than having to use a render
+    // pass. Like the render target path, this only writes one layer.
+    DxvkFormatFeatures formatFeatures = pDevice->GetDXVKDevice()->getFormatFeatures(viewInfo.format);
+
+    if ((dxvkImage->info().usage & VK_IMAGE_USAGE_STORAGE_BIT)
+     && (dxvkImage->info().tiling == VK_IMAGE_TILING_OPTIMAL)
+     && (formatFeatures.optimal & VK_FORMAT_FEATURE_2_STORAGE_IMAGE_BIT)) {
+      viewInfo.type      = VK_IMAGE_VIEW_TYPE_2D;
+      viewInfo.numLayers = 1;
+      viewInfo.swizzle   = VkComponentMapping();
+      viewInfo.usage     = VK_IMAGE_USAGE_STORAGE_BIT;
+
+      m_storageView = pDevice->GetDXVKDevice()->createImageView(dxvkImage, viewInfo);
+    }
   }
 
 
@@ -327,6 +345,7 @@ namespace dxvk {
   : m_ctx(pContext) {
     SpirvCodeBuffer vsCode(d3d11_video_blit_vert);
     SpirvCodeBuffer fsCode(d3d11_video_blit_frag);
+    SpirvCodeBuffer csCode(d3d11_video_blit_comp);
 
     const std::array<DxvkBindingInfo, 4> fsBindings = {{
       { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, VK_IMAGE_VIEW_TYPE_MAX_ENUM, VK_SHADER_STAGE_FRAGMENT_BIT, VK_ACCESS_UNIFORM_READ_BIT },
@@ -348,6 +367,22 @@ namespace dxvk {
     fsInfo.outputMask = 0x1;
     m_fs = new DxvkShader(fsInfo, std::move(fsCode));
 
+    const std::array<DxvkBindingInfo, 5> csBindings = {{
+      { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, VK_IMAGE_VIEW_TYPE_MAX_ENUM, VK_SHADER_STAGE_COMPUTE_BIT, VK_ACCESS_UNIFORM_READ_BIT },
+      { VK_DESCRIPTOR_TYPE_SAMPLER,        1, VK_IMAGE_VIEW_TYPE_MAX_ENUM, VK_SHADER_STAGE_COMPUTE_BIT, 0 },
+      { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,  2, VK_IMAGE_VIEW_TYPE_2D,       VK_SHADER_STAGE_COMPUTE_BIT, VK_ACCESS_SHADER_READ_BIT },
+      { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,  3, VK_IMAGE_VIEW_TYPE_2D,       VK_SHADER_STAGE_COMPUTE_BIT, VK_ACCESS_SHADER_READ_BIT },
+      { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,  4, VK_IMAGE_VIEW_TYPE_2D,       VK_SHADER_STAGE_COMPUTE_BIT, VK_ACCESS_SHADER_WRITE_BIT },
+    }};
+
+    DxvkShaderCreateInfo csInfo;
+    csInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    csInfo.bindingCount = csBindings.size();
+    csInfo.bindings = csBindings.data();
+    csInfo.pushConstOffset = 0;
+    csInfo.pushConstSize = sizeof(ComputePushConstants);
+    m_cs = new DxvkShader(csInfo, std::move(csCode));
+
     DxvkSamplerCreateInfo samplerInfo;
     samplerInfo.magFilter       = VK_FILTER_LINEAR;
     samplerInfo.minFilter       = VK_FILTER_LINEAR;
@@ -370,7 +405,7 @@ namespace dxvk {
     DxvkBufferCreateInfo bufferInfo;
     bufferInfo.size = sizeof(UboData);
     bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    bufferInfo.stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    bufferInfo.stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
     bufferInfo.access = VK_ACCESS_UNIFORM_READ_BIT;
     m_ubo = Device->createBuffer(bufferInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
   }
@@ -1191,24 +1226,40 @@ namespace dxvk {
 
   void D3D11VideoContext::BindOutputView(
           ID3D11VideoProcessorOutputView* pOutputView) {
-    auto dxvkView = static_cast<D3D11VideoProcessorOutputView*>(pOutputView)->GetView();
-
-    m_ctx->EmitCs([this, cView = dxvkView] (DxvkContext* ctx) {
-      DxvkRenderTargets rt;
-      rt.color[0].view = cView;
-      rt.color[0].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-      ctx->bindRenderTargets(std::move(rt), 0u);
-      ctx->bindShader<VK_SHADER_STAGE_VERTEX_BIT>(Rc<DxvkShader>(m_vs));
-      ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(Rc<DxvkShader>(m_fs));
-      ctx->bindResourceBuffer(VK_SHADER_STAGE_FRAGMENT_BIT, 0, DxvkBufferSlice(m_ubo));
-
-      DxvkInputAssemblyState iaState;
-      iaState.primitiveTopology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-      iaState.primitiveRestart = VK_FALSE;
-      iaState.patchVertexCount = 0;
-      ctx->setInputAssemblyState(iaState);
-    });
+    auto outputView = static_cast<D3D11VideoProcessorOutputView*>(pOutputView);
+
+    auto dxvkView = outputView->GetView();
+    auto storageView = outputView->GetStorageView();
+
+    // Prefer writing the output with a compute shader, which
+    // does not require any render pass setup or transitions
+    // to and from the color attachment layout.
+    m_dstIsStorage = storageView != nullptr;
+
+    if (m_dstIsStorage) {
+      m_ctx->EmitCs([this, cView = storageView] (DxvkContext* ctx) {
+        ctx->bindShader<VK_SHADER_STAGE_COMPUTE_BIT>(Rc<DxvkShader>(m_cs));
+        ctx->bindResourceBuffer(VK_SHADER_STAGE_COMPUTE_BIT, 0, DxvkBufferSlice(m_ubo));
+        ctx->bindResourceImageView(VK_SHADER_STAGE_COMPUTE_BIT, 4, Rc<DxvkImageView>(cView));
+      });
+    } else {
+      m_ctx->EmitCs([this, cView = dxvkView] (DxvkContext* ctx) {
+        DxvkRenderTargets rt;
+        rt.color[0].view = cView;
+        rt.color[0].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        ctx->bindRenderTargets(std::move(rt), 0u);
+        ctx->bindShader<VK_SHADER_STAGE_VERTEX_BIT>(Rc<DxvkShader>(m_vs));
+        ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(Rc<DxvkShader>(m_fs));
+        ctx->bindResourceBuffer(VK_SHADER_STAGE_FRAGMENT_BIT, 0, DxvkBufferSlice(m_ubo));
+
+        DxvkInputAssemblyState iaState;
+        iaState.primitiveTopology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        iaState.primitiveRestart = VK_FALSE;
+        iaState.patchVertexCount = 0;
+        ctx->setInputAssemblyState(iaState);
+      });
+    }
 
     VkExtent3D viewExtent = dxvkView->mipLevelExtent(0);
     m_dstExtent = { viewExtent.width, viewExtent.height };
@@ -1251,25 +1302,17 @@ namespace dxvk {
     m_ctx->EmitCs([this,
       cStreamState  = *pStreamState,
       cViews        = view->GetViews(),
-      cIsYCbCr      = view->IsYCbCr()
+      cIsYCbCr      = view->IsYCbCr(),
+      cIsStorage    = m_dstIsStorage
     ] (DxvkContext* ctx) {
-      VkViewport viewport;
-      viewport.x        = 0.0f;
-      viewport.y        = 0.0f;
-      viewport.width    = float(m_dstExtent.width);
-      viewport.height   = float(m_dstExtent.height);
-      viewport.minDepth = 0.0f;
-      viewport.maxDepth = 1.0f;
-
-      VkRect2D scissor;
-      scissor.offset = { 0, 0 };
-      scissor.extent = m_dstExtent;
+      VkOffset2D dstOffset = { 0, 0 };
+      VkExtent2D dstExtent = m_dstExtent;
 
       if (cStreamState.dstRectEnabled) {
-        viewport.x      = float(cStreamState.dstRect.left);
-        viewport.y      = float(cStreamState.dstRect.top);
-        viewport.width  = float(cStreamState.dstRect.right) - viewport.x;
-        viewport.height = float(cStreamState.dstRect.bottom) - viewport.y;
+        dstOffset.x      = cStreamState.dstRect.left;
+        dstOffset.y      = cStreamState.dstRect.top;
+        dstExtent.width  = uint32_t(std::max<LONG>(cStreamState.dstRect.right - cStreamState.dstRect.left, 0));
+        dstExtent.height = uint32_t(std::max<LONG>(cStreamState.dstRect.bottom - cStreamState.dstRect.top, 0));
       }
 
       UboData uboData = { };
@@ -1294,30 +1337,78 @@ namespace dxvk {
       memcpy(uboSlice.mapPtr, &uboData, sizeof(uboData));
 
       ctx->invalidateBuffer(m_ubo, uboSlice);
-      ctx->setViewports(1, &viewport, &scissor);
-      ctx->bindResourceSampler(VK_SHADER_STAGE_FRAGMENT_BIT, 1, Rc<DxvkSampler>(m_sampler));
 
-      for (uint32_t i = 0; i < cViews.size(); i++)
-        ctx->bindResourceImageView(VK_SHADER_STAGE_FRAGMENT_BIT, 2 + i, Rc<DxvkImageView>(cViews[i]));
+      VkShaderStageFlagBits stage = cIsStorage
+        ? VK_SHADER_STAGE_COMPUTE_BIT
+        : VK_SHADER_STAGE_FRAGMENT_BIT;
 
-      ctx->draw(3, 1, 0, 0);
+      ctx->bindResourceSampler(stage, 1, Rc<DxvkSampler>(m_sampler));
+
+      for (uint32_t i = 0; i < cViews.size(); i++)
+        ctx->bindResourceImageView(stage, 2 + i, Rc<DxvkImageView>(cViews[i]));
+
+      if (cIsStorage) {
+        // Only write the part of the destination
+        // rectangle that lies within the output image
+        int32_t clipMinX = std::max<int32_t>(dstOffset.x, 0);
+        int32_t clipMinY = std::max<int32_t>(dstOffset.y, 0);
+        int32_t clipMaxX = std::min<int32_t>(dstOffset.x + int32_t(dstExtent.width),  int32_t(m_dstExtent.width));
+        int32_t clipMaxY = std::min<int32_t>(dstOffset.y + int32_t(dstExtent.height), int32_t(m_dstExtent.height));
+
+        if (clipMinX < clipMaxX && clipMinY < clipMaxY) {
+          ComputePushConstants pc;
+          pc.dstOffset  = dstOffset;
+          pc.dstExtent  = dstExtent;
+          pc.clipOffset = VkOffset2D { clipMinX, clipMinY };
+          pc.clipExtent = VkExtent2D { uint32_t(clipMaxX - clipMinX), uint32_t(clipMaxY - clipMinY) };
+
+          ctx->pushConstants(0, sizeof(pc), &pc);
+          ctx->dispatch(
+            (pc.clipExtent.width  + 7) / 8,
+            (pc.clipExtent.height + 7) / 8, 1);
+        }
+      } else if (dstExtent.width && dstExtent.height) {
+        VkViewport viewport;
+        viewport.x        = float(dstOffset.x);
+        viewport.y        = float(dstOffset.y);
+        viewport.width    = float(dstExtent.width);
+        viewport.height   = float(dstExtent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+
+        VkRect2D scissor;
+        scissor.offset = { 0, 0 };
+        scissor.extent = m_dstExtent;
+
+        ctx->setViewports(1, &viewport, &scissor);
+        ctx->draw(3, 1, 0, 0);
+      }
 
-      ctx->bindResourceSampler(VK_SHADER_STAGE_FRAGMENT_BIT, 1, nullptr);
+      ctx->bindResourceSampler(stage, 1, nullptr);
 
       for (uint32_t i = 0; i < cViews.size(); i++)
-        ctx->bindResourceImageView(VK_SHADER_STAGE_FRAGMENT_BIT, 2 + i, nullptr);
+        ctx->bindResourceImageView(stage, 2 + i, nullptr);
     });
   }
 
 
   void D3D11VideoContext::UnbindResources() {
-    m_ctx->EmitCs([this] (DxvkContext* ctx) {
-      ctx->bindRenderTargets(DxvkRenderTargets(), 0u);
+    m_ctx->EmitCs([this,
+      cIsStorage = m_dstIsStorage
+    ] (DxvkContext* ctx) {
+      if (cIsStorage) {
+        ctx->bindShader<VK_SHADER_STAGE_COMPUTE_BIT>(nullptr);
 
-      ctx->bindShader<VK_SHADER_STAGE_VERTEX_BIT>(nullptr);
-      ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(nullptr);
+        ctx->bindResourceBuffer(VK_SHADER_STAGE_COMPUTE_BIT, 0, DxvkBufferSlice());
+        ctx->bindResourceImageView(VK_SHADER_STAGE_COMPUTE_BIT, 4, nullptr);
+      } else {
+        ctx->bindRenderTargets(DxvkRenderTargets(), 0u);
 
-      ctx->bindResourceBuffer(VK_SHADER_STAGE_FRAGMENT_BIT, 0, DxvkBufferSlice());
+        ctx->bindShader<VK_SHADER_STAGE_VERTEX_BIT>(nullptr);
+        ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(nullptr);
+
+        ctx->bindResourceBuffer(VK_SHADER_STAGE_FRAGMENT_BIT, 0, DxvkBufferSlice());
+      }
     });
   }
 
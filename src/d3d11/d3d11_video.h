@@ -198,11 +198,16 @@ namespace dxvk {
       return m_view;
     }
 
+    Rc<DxvkImageView> GetStorageView() const {
+      return m_storageView;
+    }
+
   private:
 
     Com<ID3D11Resource>                     m_resource;
     D3D11_VIDEO_PROCESSOR_OUTPUT_VIEW_DESC  m_desc;
     Rc<DxvkImageView>                       m_view;
+    Rc<DxvkImageView>                       m_storageView;
 
   };
 
@@ -588,14 +593,23 @@ namespace dxvk {
       VkBool32 isPlanar;
     };
 
+    struct ComputePushConstants {
+      VkOffset2D dstOffset;
+      VkExtent2D dstExtent;
+      VkOffset2D clipOffset;
+      VkExtent2D clipExtent;
+    };
+
     D3D11ImmediateContext* m_ctx;
 
     Rc<DxvkSampler> m_sampler;
     Rc<DxvkShader> m_vs;
     Rc<DxvkShader> m_fs;
+    Rc<DxvkShader> m_cs;
     Rc<DxvkBuffer> m_ubo;
 
     VkExtent2D m_dstExtent = { 0u, 0u };
+    bool       m_dstIsStorage = false;
 
     void ApplyColorMatrix(float pDst[3][4], const float pSrc[3][4]);
 
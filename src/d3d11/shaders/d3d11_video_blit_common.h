@@ -0,0 +1,51 @@
+// Can't use matrix types here since even a two-row
+// matrix will be padded to 16 bytes per column for
+// absolutely no reason
+layout(std140, set = 0, binding = 0)
+uniform ubo_t {
+  vec4 color_matrix_r1;
+  vec4 color_matrix_r2;
+  vec4 color_matrix_r3;
+  vec2 coord_matrix_c1;
+  vec2 coord_matrix_c2;
+  vec2 coord_matrix_c3;
+  float y_min;
+  float y_max;
+  bool is_planar;
+};
+
+layout(set = 0, binding = 1) uniform sampler s_sampler;
+layout(set = 0, binding = 2) uniform texture2D s_inputY;
+layout(set = 0, binding = 3) uniform texture2D s_inputCbCr;
+
+vec4 blit_color(vec2 texcoord) {
+  // Transform input texture coordinates to
+  // account for rotation and source rectangle
+  mat3x2 coord_matrix = mat3x2(
+    coord_matrix_c1,
+    coord_matrix_c2,
+    coord_matrix_c3);
+
+  vec2 coord = coord_matrix * vec3(texcoord, 1.0f);
+
+  // Fetch source image color. The input views only
+  // have one mip level, so use explicit LOD in order
+  // to be able to use this in compute shaders.
+  vec4 color = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+  if (is_planar) {
+    color.g  = textureLod(sampler2D(s_inputY,    s_sampler), coord, 0.0f).r;
+    color.rb = textureLod(sampler2D(s_inputCbCr, s_sampler), coord, 0.0f).gr;
+    color.g  = clamp((color.g - y_min) / (y_max - y_min), 0.0f, 1.0f);
+  } else {
+    color = textureLod(sampler2D(s_inputY, s_sampler), coord, 0.0f);
+  }
+
+  // Color space transformation
+  mat3x4 color_matrix = mat3x4(
+    color_matrix_r1,
+    color_matrix_r2,
+    color_matrix_r3);
+
+  return vec4(vec4(color.rgb, 1.0f) * color_matrix, color.a);
+}
@@ -342,6 +342,18 @@ namespace dxvk {
     // in no way affect the default image layout
     imageInfo.usage |= EnableMetaCopyUsage(imageInfo.format, imageInfo.tiling);
 
+    // Enable storage usage for images that need mip generation if
+    // requested, so that all levels can be generated in one dispatch
+    if (isAutoGen) {
+      VkImageUsageFlags mipGenUsage = DxvkMetaMipGenComputePass::getImageUsage(
+        m_device->GetDXVKDevice().ptr(), imageInfo.format, imageInfo.tiling);
+
+      if (mipGenUsage && (imageInfo.flags & VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT))
+        imageInfo.flags |= VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+
+      imageInfo.usage |= mipGenUsage;
+    }
+
     // Check if we can actually create the image
     if (!CheckImageSupport(&imageInfo, imageInfo.tiling)) {
       throw DxvkError(str::format(
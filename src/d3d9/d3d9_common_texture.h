@@ -236,6 +236,19 @@ namespace dxvk {
       }
     }
 
+    /**
+     * \brief Compresses unmapped data in the background
+     *
+     * The data gets decompressed on demand the
+     * next time the subresource is mapped.
+     */
+    void CompressData() {
+      const uint32_t subresources = CountSubresources();
+      for (uint32_t i = 0; i < subresources; i++) {
+        m_data[i].Compress();
+      }
+    }
+
     /**
      * \brief Destroys a buffer
      * Destroys mapping and staging buffers for a given subresource
@@ -44,11 +44,55 @@ namespace dxvk {
     D3D9ConstantBuffer        boolBuffer;
   };
 
+  /**
+   * \brief Dirty register range
+   *
+   * Tracks the range of registers of a given constant
+   * type that have been changed since the last upload.
+   */
+  struct D3D9ConstantDirtyRange {
+    uint32_t min = 0;
+    uint32_t max = 0;
+
+    bool IsEmpty() const {
+      return min >= max;
+    }
+
+    bool Intersects(uint32_t count) const {
+      return !IsEmpty() && min < count;
+    }
+
+    void Add(uint32_t start, uint32_t count) {
+      if (IsEmpty()) {
+        min = start;
+        max = start + count;
+      } else {
+        min = std::min(min, start);
+        max = std::max(max, start + count);
+      }
+    }
+
+    void Clear() {
+      min = 0;
+      max = 0;
+    }
+  };
+
   struct D3D9ConstantSets {
     D3D9SwvpConstantBuffers   swvp;
     D3D9ConstantBuffer        buffer;
     DxsoShaderMetaInfo        meta  = {};
     bool                      dirty = true;
+    D3D9ConstantDirtyRange    dirtyF;
+    D3D9ConstantDirtyRange    dirtyI;
+    D3D9ConstantDirtyRange    dirtyB;
+
+    void ClearDirty() {
+      dirty = false;
+      dirtyF.Clear();
+      dirtyI.Clear();
+      dirtyB.Clear();
+    }
   };
 
 }
\ No newline at end of file
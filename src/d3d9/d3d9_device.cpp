@@ -48,10 +48,11 @@ namespace dxvk {
     , m_dxvkDevice      ( dxvkDevice )
     , m_memoryAllocator ( )
     , m_shaderAllocator ( )
+    , m_ffModules       ( dxvkDevice )
     , m_shaderModules   ( new D3D9ShaderModuleSet )
     , m_stagingBuffer   ( dxvkDevice, StagingBufferSize )
     , m_d3d9Options     ( dxvkDevice, pParent->GetInstance()->config() )
-    , m_multithread     ( BehaviorFlags & D3DCREATE_MULTITHREADED )
+    , m_multithread     ( BehaviorFlags & D3DCREATE_MULTITHREADED, m_d3d9Options.lockElision )
     , m_isSWVP          ( (BehaviorFlags & D3DCREATE_SOFTWARE_VERTEXPROCESSING) ? true : false )
     , m_csThread        ( dxvkDevice, dxvkDevice->createContext(DxvkContextType::Primary) )
     , m_csChunk         ( AllocCsChunk() ) {
@@ -153,6 +154,8 @@ namespace dxvk {
     m_flags.set(D3D9DeviceFlag::DirtyPointScale);
 
     m_flags.set(D3D9DeviceFlag::DirtySpecializationEntries);
+
+    m_ffModules.Prewarm(this);
   }
 
 
@@ -162,6 +165,8 @@ namespace dxvk {
     if (this_thread::isInModuleDetachment())
       return;
 
+    m_ffModules.StopPrewarm();
+
     Flush();
     SynchronizeCsThread(DxvkCsThread::SynchronizeAll);
 
@@ -1278,11 +1283,13 @@ namespace dxvk {
         m_flags.set(D3D9DeviceFlag::DirtyPointScale);
         m_flags.set(D3D9DeviceFlag::DirtyViewportScissor);
         m_state.viewport = viewport;
+        BumpStateGeneration(D3D9CapturedStateFlag::Viewport);
       }
 
       if (m_state.scissorRect != scissorRect) {
         m_flags.set(D3D9DeviceFlag::DirtyViewportScissor);
         m_state.scissorRect = scissorRect;
+        BumpStateGeneration(D3D9CapturedStateFlag::ScissorRect);
       }
 
       m_flags.set(D3D9DeviceFlag::DirtyAlphaTestState);
@@ -1616,6 +1623,7 @@ namespace dxvk {
       return m_recorder->MultiplyStateTransform(idx, pMatrix);
 
     m_state.transforms[idx] = m_state.transforms[idx] * ConvertMatrix(pMatrix);
+    BumpStateGeneration(D3D9CapturedStateFlag::Transforms);
 
     m_flags.set(D3D9DeviceFlag::DirtyFFVertexData);
 
@@ -1636,6 +1644,7 @@ namespace dxvk {
       return D3D_OK;
 
     m_state.viewport = *pViewport;
+    BumpStateGeneration(D3D9CapturedStateFlag::Viewport);
 
     m_flags.set(D3D9DeviceFlag::DirtyViewportScissor);
     m_flags.set(D3D9DeviceFlag::DirtyFFViewport);
@@ -1667,6 +1676,7 @@ namespace dxvk {
       return m_recorder->SetMaterial(pMaterial);
 
     m_state.material = *pMaterial;
+    BumpStateGeneration(D3D9CapturedStateFlag::Material);
     m_flags.set(D3D9DeviceFlag::DirtyFFVertexData);
 
     return D3D_OK;
@@ -1785,6 +1795,9 @@ namespace dxvk {
       m_state.clipPlanes[Index].coeff[i] = pPlane[i];
     }
 
+    if (dirty)
+      BumpStateGeneration(D3D9CapturedStateFlag::ClipPlanes);
+
     bool enabled = m_state.renderStates[D3DRS_CLIPPLANEENABLE] & (1u << Index);
     dirty &= enabled;
 
@@ -1834,6 +1847,7 @@ namespace dxvk {
       const bool oldAlphaTest = IsAlphaTestEnabled();
 
       states[State] = Value;
+      BumpStateGeneration(D3D9CapturedStateFlag::RenderStates);
 
       // AMD's driver hack for ATOC and RESZ
       if (unlikely(State == D3DRS_POINTSIZE)) {
@@ -2361,6 +2375,7 @@ namespace dxvk {
       return D3D_OK;
 
     m_state.scissorRect = *pRect;
+    BumpStateGeneration(D3D9CapturedStateFlag::ScissorRect);
 
     m_flags.set(D3D9DeviceFlag::DirtyViewportScissor);
 
@@ -2493,37 +2508,37 @@ namespace dxvk {
     if (unlikely(!PrimitiveCount))
       return S_OK;
 
-    PrepareDraw(PrimitiveType);
+    PrepareDraw(PrimitiveType, true);
 
     auto drawInfo = GenerateDrawInfo(PrimitiveType, PrimitiveCount, 0);
 
     const uint32_t dataSize = GetUPDataSize(drawInfo.vertexCount, VertexStreamZeroStride);
     const uint32_t bufferSize = GetUPBufferSize(drawInfo.vertexCount, VertexStreamZeroStride);
 
-    auto upSlice = AllocUPBuffer(bufferSize);
+    auto upSlice = AllocUPBuffer(bufferSize, GetUPBufferAlignment(VertexStreamZeroStride));
     FillUPVertexBuffer(upSlice.mapPtr, pVertexStreamZeroData, dataSize, bufferSize);
 
+    const uint32_t firstVertex = BindUPVertexBuffer(upSlice.slice, VertexStreamZeroStride);
+
     EmitCs([this,
-      cBufferSlice  = std::move(upSlice.slice),
+      cFirstVertex  = firstVertex,
       cPrimType     = PrimitiveType,
       cPrimCount    = PrimitiveCount,
-      cInstanceCount = GetInstanceCount(),
-      cStride       = VertexStreamZeroStride
-    ](DxvkContext* ctx) mutable {
+      cInstanceCount = GetInstanceCount()
+    ](DxvkContext* ctx) {
       auto drawInfo = GenerateDrawInfo(cPrimType, cPrimCount, cInstanceCount);
 
       ApplyPrimitiveType(ctx, cPrimType);
 
-      ctx->bindVertexBuffer(0, std::move(cBufferSlice), cStride);
       ctx->draw(
         drawInfo.vertexCount, drawInfo.instanceCount,
-        0, 0);
-      ctx->bindVertexBuffer(0, DxvkBufferSlice(), 0);
+        cFirstVertex, 0);
     });
 
     m_state.vertexBuffers[0].vertexBuffer = nullptr;
     m_state.vertexBuffers[0].offset       = 0;
     m_state.vertexBuffers[0].stride       = 0;
+    BumpStateGeneration(D3D9CapturedStateFlag::VertexBuffers);
 
     return D3D_OK;
   }
@@ -2546,7 +2561,7 @@ namespace dxvk {
     if (unlikely(!PrimitiveCount))
       return S_OK;
 
-    PrepareDraw(PrimitiveType);
+    PrepareDraw(PrimitiveType, true);
 
     auto drawInfo = GenerateDrawInfo(PrimitiveType, PrimitiveCount, 0);
 
@@ -2556,42 +2571,46 @@ namespace dxvk {
     const uint32_t indexSize = IndexDataFormat == D3DFMT_INDEX16 ? 2 : 4;
     const uint32_t indicesSize = drawInfo.vertexCount * indexSize;
 
-    const uint32_t upSize = vertexBufferSize + indicesSize;
+    const uint32_t indexOffset = align(vertexBufferSize, 4);
+    const uint32_t upSize = indexOffset + indicesSize;
 
-    auto upSlice = AllocUPBuffer(upSize);
+    auto upSlice = AllocUPBuffer(upSize, GetUPBufferAlignment(VertexStreamZeroStride));
     uint8_t* data = reinterpret_cast<uint8_t*>(upSlice.mapPtr);
     FillUPVertexBuffer(data, pVertexStreamZeroData, vertexDataSize, vertexBufferSize);
-    std::memcpy(data + vertexBufferSize, pIndexData, indicesSize);
+    std::memcpy(data + indexOffset, pIndexData, indicesSize);
+
+    const uint32_t vertexOffset = BindUPVertexBuffer(
+      upSlice.slice.subSlice(0, vertexBufferSize),
+      VertexStreamZeroStride);
+
+    const uint32_t firstIndex = BindUPIndexBuffer(
+      upSlice.slice.subSlice(indexOffset, indicesSize),
+      DecodeIndexType(static_cast<D3D9Format>(IndexDataFormat)));
 
     EmitCs([this,
-      cVertexSize   = vertexBufferSize,
-      cBufferSlice  = std::move(upSlice.slice),
+      cFirstIndex   = firstIndex,
+      cVertexOffset = vertexOffset,
       cPrimType     = PrimitiveType,
       cPrimCount    = PrimitiveCount,
-      cStride       = VertexStreamZeroStride,
-      cInstanceCount = GetInstanceCount(),
-      cIndexType    = DecodeIndexType(
-                        static_cast<D3D9Format>(IndexDataFormat))
+      cInstanceCount = GetInstanceCount()
     ](DxvkContext* ctx) {
       auto drawInfo = GenerateDrawInfo(cPrimType, cPrimCount, cInstanceCount);
 
       ApplyPrimitiveType(ctx, cPrimType);
 
-      ctx->bindVertexBuffer(0, cBufferSlice.subSlice(0, cVertexSize), cStride);
-      ctx->bindIndexBuffer(cBufferSlice.subSlice(cVertexSize, cBufferSlice.length() - cVertexSize), cIndexType);
       ctx->drawIndexed(
         drawInfo.vertexCount, drawInfo.instanceCount,
-        0,
-        0, 0);
-      ctx->bindVertexBuffer(0, DxvkBufferSlice(), 0);
-      ctx->bindIndexBuffer(DxvkBufferSlice(), VK_INDEX_TYPE_UINT32);
+        cFirstIndex,
+        int32_t(cVertexOffset), 0);
     });
 
     m_state.vertexBuffers[0].vertexBuffer = nullptr;
     m_state.vertexBuffers[0].offset       = 0;
     m_state.vertexBuffers[0].stride       = 0;
+    BumpStateGeneration(D3D9CapturedStateFlag::VertexBuffers);
 
     m_state.indices = nullptr;
+    BumpStateGeneration(D3D9CapturedStateFlag::Indices);
 
     return D3D_OK;
   }
@@ -2606,7 +2625,13 @@ namespace dxvk {
           DWORD                        Flags) {
     D3D9DeviceLock lock = LockDevice();
 
-    if (unlikely(pDestBuffer == nullptr || pVertexDecl == nullptr))
+    if (unlikely(pDestBuffer == nullptr))
+      return D3DERR_INVALIDCALL;
+
+    // Shader model 3 vertex shaders have no fixed output layout,
+    // so we can only derive one from the FVF for older shaders
+    if (unlikely(pVertexDecl == nullptr && m_state.vertexShader != nullptr
+     && GetCommonShader(m_state.vertexShader)->GetInfo().majorVersion() >= 3))
       return D3DERR_INVALIDCALL;
 
     if (!SupportsSWVP()) {
@@ -2624,6 +2649,9 @@ namespace dxvk {
     D3D9CommonBuffer* dst  = static_cast<D3D9VertexBuffer*>(pDestBuffer)->GetCommonBuffer();
     D3D9VertexDecl*   decl = static_cast<D3D9VertexDecl*>  (pVertexDecl);
 
+    if (unlikely(decl == nullptr && !dst->Desc()->FVF))
+      return D3DERR_INVALIDCALL;
+
     PrepareDraw(D3DPT_FORCE_DWORD);
 
     if (decl == nullptr) {
@@ -2639,6 +2667,14 @@ namespace dxvk {
         decl = iter->second.ptr();
     }
 
+    // With D3DPV_DONOTCOPYDATA, only write elements that the
+    // vertex shader actually outputs. The fixed function vertex
+    // shader is treated as writing all of them.
+    uint32_t outputMask = ~0u;
+
+    if ((Flags & D3DPV_DONOTCOPYDATA) && m_state.vertexShader != nullptr)
+      outputMask = GetCommonShader(m_state.vertexShader)->GetShader()->info().outputMask;
+
     uint32_t offset = DestIndex * decl->GetSize();
 
     auto slice = dst->GetBufferSlice<D3D9_COMMON_BUFFER_TYPE_REAL>();
@@ -2646,13 +2682,14 @@ namespace dxvk {
 
     EmitCs([this,
       cDecl          = ref(decl),
+      cOutputMask    = outputMask,
       cVertexCount   = VertexCount,
       cStartIndex    = SrcStartIndex,
       cInstanceCount = GetInstanceCount(),
       cBufferSlice   = slice,
       cIndexed       = m_state.indices != nullptr
     ](DxvkContext* ctx) mutable {
-      Rc<DxvkShader> shader = m_swvpEmulator.GetShaderModule(this, cDecl);
+      Rc<DxvkShader> shader = m_swvpEmulator.GetShaderModule(this, cDecl, cOutputMask);
 
       auto drawInfo = GenerateDrawInfo(D3DPT_POINTLIST, cVertexCount, cInstanceCount);
 
@@ -2752,6 +2789,7 @@ namespace dxvk {
       m_flags.set(D3D9DeviceFlag::DirtyFFVertexShader);
 
     m_state.vertexDecl = decl;
+    BumpStateGeneration(D3D9CapturedStateFlag::VertexDecl);
 
     m_flags.set(D3D9DeviceFlag::DirtyInputLayout);
 
@@ -2867,10 +2905,12 @@ namespace dxvk {
       m_consts[DxsoProgramTypes::VertexShader].dirty
         |= newShader->GetMeta().maxConstIndexF > oldShader->GetMeta().maxConstIndexF
         || newShader->GetMeta().maxConstIndexI > oldShader->GetMeta().maxConstIndexI
-        || newShader->GetMeta().maxConstIndexB > oldShader->GetMeta().maxConstIndexB;
+        || newShader->GetMeta().maxConstIndexB > oldShader->GetMeta().maxConstIndexB
+        || newShader->GetConstantRanges() != oldShader->GetConstantRanges();
     }
 
     m_state.vertexShader = shader;
+    BumpStateGeneration(D3D9CapturedStateFlag::VertexShader);
 
     if (shader != nullptr) {
       m_flags.clr(D3D9DeviceFlag::DirtyProgVertexShader);
@@ -3025,8 +3065,10 @@ namespace dxvk {
       vbo.stride = Stride;
     }
 
-    if (needsUpdate)
+    if (needsUpdate) {
       BindVertexBuffer(StreamNumber, buffer, OffsetInBytes, Stride);
+      BumpStateGeneration(D3D9CapturedStateFlag::VertexBuffers);
+    }
 
     return D3D_OK;
   }
@@ -3088,6 +3130,7 @@ namespace dxvk {
       return D3D_OK;
 
     m_state.streamFreq[StreamNumber] = Setting;
+    BumpStateGeneration(D3D9CapturedStateFlag::StreamFreq);
 
     if (instanced)
       m_instancedData |=   1u << StreamNumber;
@@ -3127,6 +3170,7 @@ namespace dxvk {
       return D3D_OK;
 
     m_state.indices = buffer;
+    BumpStateGeneration(D3D9CapturedStateFlag::Indices);
 
     BindIndices();
 
@@ -3202,10 +3246,12 @@ namespace dxvk {
       m_consts[DxsoProgramTypes::PixelShader].dirty
         |= newShader->GetMeta().maxConstIndexF > oldShader->GetMeta().maxConstIndexF
         || newShader->GetMeta().maxConstIndexI > oldShader->GetMeta().maxConstIndexI
-        || newShader->GetMeta().maxConstIndexB > oldShader->GetMeta().maxConstIndexB;
+        || newShader->GetMeta().maxConstIndexB > oldShader->GetMeta().maxConstIndexB
+        || newShader->GetConstantRanges() != oldShader->GetConstantRanges();
     }
 
     m_state.pixelShader = shader;
+    BumpStateGeneration(D3D9CapturedStateFlag::PixelShader);
 
     if (shader != nullptr) {
       m_flags.set(D3D9DeviceFlag::DirtyFFPixelShader);
@@ -3695,6 +3741,7 @@ namespace dxvk {
       return D3D_OK;
 
     state[StateSampler][Type] = Value;
+    BumpStateGeneration(D3D9CapturedStateFlag::SamplerStates);
 
     const uint32_t samplerBit = 1u << StateSampler;
 
@@ -3765,6 +3812,7 @@ namespace dxvk {
     DWORD newUsage = newTexture != nullptr ? newTexture->Desc()->Usage : 0;
     DWORD combinedUsage = oldUsage | newUsage;
     TextureChangePrivate(m_state.textures[StateSampler], pTexture);
+    BumpStateGeneration(D3D9CapturedStateFlag::Textures);
     m_dirtyTextures |= 1u << StateSampler;
     UpdateActiveTextures(StateSampler, combinedUsage);
 
@@ -3798,6 +3846,7 @@ namespace dxvk {
       return m_recorder->SetStateTransform(idx, pMatrix);
 
     m_state.transforms[idx] = ConvertMatrix(pMatrix);
+    BumpStateGeneration(D3D9CapturedStateFlag::Transforms);
 
     m_flags.set(D3D9DeviceFlag::DirtyFFVertexData);
 
@@ -3825,6 +3874,7 @@ namespace dxvk {
 
     if (likely(m_state.textureStages[Stage][Type] != Value)) {
       m_state.textureStages[Stage][Type] = Value;
+      BumpStateGeneration(D3D9CapturedStateFlag::TextureStages);
 
       switch (Type) {
         case DXVK_TSS_COLOROP:
@@ -3963,59 +4013,158 @@ namespace dxvk {
   }
 
 
-  D3D9BufferSlice D3D9DeviceEx::AllocUPBuffer(VkDeviceSize size) {
-    constexpr VkDeviceSize UPBufferSize = 1 << 20;
+  D3D9BufferSlice D3D9DeviceEx::AllocUPBuffer(VkDeviceSize size, VkDeviceSize alignment) {
+    m_stats.upBytesAllocated += size;
+
+    if (unlikely(size > UPBufferSegmentSize)) {
+      // Temporary buffer
+      Rc<DxvkBuffer> buffer = CreateUPBuffer(size);
 
-    if (unlikely(m_upBuffer == nullptr || size > UPBufferSize)) {
-      VkMemoryPropertyFlags memoryFlags
-        = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-        | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+      D3D9BufferSlice result;
+      result.mapPtr = buffer->mapPtr(0);
+      result.slice = DxvkBufferSlice(std::move(buffer), 0, size);
+      return result;
+    }
 
-      DxvkBufferCreateInfo info;
-      info.size   = std::max(UPBufferSize, size);
-      info.usage  = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
-                  | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-      info.access = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
-                  | VK_ACCESS_INDEX_READ_BIT;
-      info.stages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    // The alignment is not necessarily a power of two
+    VkDeviceSize offset = align(m_upBufferOffset, CACHE_LINE_SIZE);
+    offset = ((offset + alignment - 1) / alignment) * alignment;
 
-      Rc<DxvkBuffer> buffer = m_dxvkDevice->createBuffer(info, memoryFlags);
+    if (unlikely(m_upSegments.empty() || offset + size > UPBufferSegmentSize)) {
+      NextUPBufferSegment();
+      offset = 0;
+    }
+
+    const auto& segment = m_upSegments[m_upSegmentIndex];
+
+    D3D9BufferSlice result;
+    result.slice = DxvkBufferSlice(segment.buffer, offset, size);
+    result.mapPtr = reinterpret_cast<char*>(segment.mapPtr) + offset;
 
-      if (size <= UPBufferSize) {
-        m_upBuffer = std::move(buffer);
-        m_upBufferMapPtr = m_upBuffer->mapPtr(0);
+    m_upBufferOffset = offset + size;
+    return result;
+  }
+
+
+  Rc<DxvkBuffer> D3D9DeviceEx::CreateUPBuffer(VkDeviceSize size) {
+    VkMemoryPropertyFlags memoryFlags
+      = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+      | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+      | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    DxvkBufferCreateInfo info;
+    info.size   = size;
+    info.usage  = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+                | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+    info.access = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+                | VK_ACCESS_INDEX_READ_BIT;
+    info.stages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+
+    return m_dxvkDevice->createBuffer(info, memoryFlags);
+  }
+
+
+  void D3D9DeviceEx::NextUPBufferSegment() {
+    if (!m_upSegments.empty()) {
+      // Remember the last CS chunk that can use the retired segment
+      m_upSegments[m_upSegmentIndex].sequenceNumber = GetCurrentSequenceNumber();
+      m_upSegmentIndex = (m_upSegmentIndex + 1) % m_upSegments.size();
+    }
+
+    m_upBufferOffset = 0;
+
+    if (m_upSegments.empty() || IsUPBufferSegmentBusy(m_upSegments[m_upSegmentIndex])) {
+      if (m_upSegments.size() < MaxUPBufferSegments) {
+        // Grow the ring in front of the oldest segment, so
+        // that segments are still recycled in retire order
+        D3D9UPBufferSegment segment;
+        segment.buffer = CreateUPBuffer(UPBufferSegmentSize);
+        segment.mapPtr = segment.buffer->mapPtr(0);
+
+        m_upSegments.insert(m_upSegments.begin() + m_upSegmentIndex, std::move(segment));
       } else {
-        // Temporary buffer
-        D3D9BufferSlice result;
-        result.slice = DxvkBufferSlice(std::move(buffer), 0, size);
-        result.mapPtr = buffer->mapPtr(0);
-        return result;
+        // All segments are in flight, so we have no
+        // choice but to wait for the oldest one
+        const auto& segment = m_upSegments[m_upSegmentIndex];
+
+        m_stats.upSegmentStalls += 1;
+        WaitForResource(segment.buffer, segment.sequenceNumber, 0);
       }
     }
+  }
+
 
-    VkDeviceSize alignedSize = align(size, CACHE_LINE_SIZE);
+  bool D3D9DeviceEx::IsUPBufferSegmentBusy(const D3D9UPBufferSegment& segment) {
+    return segment.sequenceNumber > m_csThread.lastSequenceNumber()
+        || segment.buffer->isInUse(DxvkAccess::Read);
+  }
 
-    if (unlikely(m_upBufferOffset + alignedSize > UPBufferSize)) {
-      auto sliceHandle = m_upBuffer->allocSlice();
 
-      m_upBufferOffset = 0;
-      m_upBufferMapPtr = sliceHandle.mapPtr;
+  uint32_t D3D9DeviceEx::BindUPVertexBuffer(const DxvkBufferSlice& slice, uint32_t stride) {
+    // Bind the entire buffer and address the vertex data via the first
+    // vertex index, so that consecutive UP draws that use the same ring
+    // segment and stride do not need to rebind the vertex buffer.
+    DxvkBufferSlice binding = slice;
+    uint32_t firstVertex = 0;
+
+    if (stride) {
+      binding = DxvkBufferSlice(slice.buffer());
+      firstVertex = slice.offset() / stride;
+    }
+
+    if (!m_upBinding.vertexSlice.matches(binding) || m_upBinding.vertexStride != stride) {
+      m_upBinding.vertexSlice = binding;
+      m_upBinding.vertexStride = stride;
 
       EmitCs([
-        cBuffer = m_upBuffer,
-        cSlice  = sliceHandle
-      ] (DxvkContext* ctx) {
-        ctx->invalidateBuffer(cBuffer, cSlice);
+        cBufferSlice  = std::move(binding),
+        cStride       = stride
+      ] (DxvkContext* ctx) mutable {
+        ctx->bindVertexBuffer(0, std::move(cBufferSlice), cStride);
       });
     }
 
-    D3D9BufferSlice result;
-    result.slice = DxvkBufferSlice(m_upBuffer, m_upBufferOffset, size);
-    result.mapPtr = reinterpret_cast<char*>(m_upBufferMapPtr) + m_upBufferOffset;
+    return firstVertex;
+  }
 
-    m_upBufferOffset += alignedSize;
-    return result;
+
+  uint32_t D3D9DeviceEx::BindUPIndexBuffer(const DxvkBufferSlice& slice, VkIndexType indexType) {
+    DxvkBufferSlice binding = DxvkBufferSlice(slice.buffer());
+    uint32_t indexSize = indexType == VK_INDEX_TYPE_UINT16 ? 2 : 4;
+
+    if (!m_upBinding.indexSlice.matches(binding) || m_upBinding.indexType != indexType) {
+      m_upBinding.indexSlice = binding;
+      m_upBinding.indexType = indexType;
+
+      EmitCs([
+        cBufferSlice  = std::move(binding),
+        cIndexType    = indexType
+      ] (DxvkContext* ctx) mutable {
+        ctx->bindIndexBuffer(std::move(cBufferSlice), cIndexType);
+      });
+    }
+
+    return slice.offset() / indexSize;
+  }
+
+
+  void D3D9DeviceEx::UnbindUPBuffers() {
+    // UP draws leave their buffers bound in order to avoid redundant
+    // binding updates, so we need to restore the actual D3D9 state
+    // before any regular draw. Slot 0 and the index buffer are both
+    // unbound after a UP draw as far as D3D9 is concerned.
+    if (m_upBinding.vertexSlice.defined()) {
+      m_upBinding.vertexSlice = DxvkBufferSlice();
+      m_upBinding.vertexStride = 0;
+
+      BindVertexBuffer(0, nullptr, 0, 0);
+    }
+
+    if (m_upBinding.indexSlice.defined()) {
+      m_upBinding.indexSlice = DxvkBufferSlice();
+
+      BindIndices();
+    }
   }
 
 
@@ -4600,6 +4749,35 @@ namespace dxvk {
         return;
       }
 
+      if (D3D9FormatHelper::CanConvertOnHost(convertFormat, dstTexLevelExtent)) {
+        // Small images get converted while writing the staging buffer,
+        // this way we do not need to synchronize with the CS thread.
+        VkDeviceSize pitch = align(srcTexLevelExtentBlockCount.width * formatInfo->elementSize, 4);
+        D3D9BufferSlice slice = AllocStagingBuffer(
+          D3D9FormatHelper::GetHostConversionSize(convertFormat, dstTexLevelExtent));
+
+        D3D9FormatHelper::ConvertFormatOnHost(
+          convertFormat, slice.mapPtr, mapPtr, dstTexLevelExtent,
+          pitch, pitch * srcTexLevelExtentBlockCount.height);
+
+        EmitCs([
+          cSrcSlice       = slice.slice,
+          cDstImage       = image,
+          cDstLayers      = dstLayers,
+          cDstLevelExtent = dstTexLevelExtent
+        ] (DxvkContext* ctx) {
+          ctx->copyBufferToImage(
+            cDstImage,  cDstLayers,
+            VkOffset3D { 0, 0, 0 }, cDstLevelExtent,
+            cSrcSlice.buffer(), cSrcSlice.offset(),
+            1, 1);
+        });
+
+        UnmapTextures();
+        FlushImplicit(false);
+        return;
+      }
+
       // the converter can not handle the 4 aligned pitch so we always repack into a staging buffer
       D3D9BufferSlice slice = AllocStagingBuffer(pSrcTexture->GetMipSize(SrcSubresource));
       VkDeviceSize pitch = align(srcTexLevelExtentBlockCount.width * formatInfo->elementSize, 4);
@@ -4973,10 +5151,16 @@ namespace dxvk {
 
     D3D9ConstantSets& constSet = m_consts[DxsoProgramType::VertexShader];
 
-    if (!constSet.dirty)
-      return;
+    // Each constant type lives in its own buffer, so only re-upload the
+    // types whose dirty register range is actually used by the shader
+    bool uploadF = constSet.dirty || constSet.dirtyF.Intersects(constSet.meta.maxConstIndexF);
+    bool uploadI = constSet.dirty || constSet.dirtyI.Intersects(constSet.meta.maxConstIndexI);
+    bool uploadB = constSet.dirty || constSet.dirtyB.Intersects(constSet.meta.maxConstIndexB);
+
+    constSet.ClearDirty();
 
-    constSet.dirty = false;
+    if (!uploadF && !uploadI && !uploadB)
+      return;
 
     uint32_t floatCount = m_vsFloatConstsCount;
     if (constSet.meta.needsConstantCopies) {
@@ -4991,7 +5175,7 @@ namespace dxvk {
 
     // Max copy source size is 8192 * 16 => always aligned to any plausible value
     // => we won't copy out of bounds
-    if (likely(constSet.meta.maxConstIndexF != 0)) {
+    if (likely(constSet.meta.maxConstIndexF != 0 && uploadF)) {
       auto mapPtr = CopySoftwareConstants(constSet.buffer, Src.fConsts, floatDataSize);
 
       if (constSet.meta.needsConstantCopies) {
@@ -5008,10 +5192,10 @@ namespace dxvk {
 
     // Max copy source size is 2048 * 16 => always aligned to any plausible value
     // => we won't copy out of bounds
-    if (likely(constSet.meta.maxConstIndexI != 0))
+    if (likely(constSet.meta.maxConstIndexI != 0 && uploadI))
       CopySoftwareConstants(constSet.swvp.intBuffer, Src.iConsts, intDataSize);
 
-    if (likely(constSet.meta.maxConstIndexB != 0))
+    if (likely(constSet.meta.maxConstIndexB != 0 && uploadB))
       CopySoftwareConstants(constSet.swvp.boolBuffer, Src.bConsts, boolDataSize);
   }
 
@@ -5023,6 +5207,8 @@ namespace dxvk {
 
     auto mapPtr = dstBuffer.Alloc(size);
     std::memcpy(mapPtr, src, size);
+
+    m_stats.constantBytesUploaded += size;
     return mapPtr;
   }
 
@@ -5035,10 +5221,17 @@ namespace dxvk {
     */
     D3D9ConstantSets& constSet = m_consts[ShaderStage];
 
-    if (!constSet.dirty)
-      return;
+    // Integer and float constants share one buffer here, so any used
+    // dirty register requires a full upload. Dirty registers outside
+    // the range accessed by the current shader can be ignored.
+    bool upload = constSet.dirty
+      || constSet.dirtyF.Intersects(constSet.meta.maxConstIndexF)
+      || constSet.dirtyI.Intersects(constSet.meta.maxConstIndexI);
 
-    constSet.dirty = false;
+    constSet.ClearDirty();
+
+    if (!upload)
+      return;
 
     uint32_t floatCount = ShaderStage == DxsoProgramType::VertexShader ? m_vsFloatConstsCount : m_psFloatConstsCount;
     if (constSet.meta.needsConstantCopies) {
@@ -5047,6 +5240,11 @@ namespace dxvk {
     }
     floatCount = std::min(constSet.meta.maxConstIndexF, floatCount);
 
+    // Shaders without relative addressing read a packed subset of
+    // registers, which may include ones never set by the app.
+    if (constSet.meta.packedConstCountF)
+      floatCount = constSet.meta.packedConstCountF;
+
     const uint32_t intRange = caps::MaxOtherConstants * sizeof(Vector4i);
     const uint32_t intDataSize = constSet.meta.maxConstIndexI * sizeof(Vector4i);
     uint32_t floatDataSize = floatCount * sizeof(Vector4);
@@ -5057,10 +5255,20 @@ namespace dxvk {
     void* mapPtr = constSet.buffer.Alloc(bufferSize);
     auto* dst = reinterpret_cast<HardwareLayoutType*>(mapPtr);
 
+    m_stats.constantBytesUploaded += bufferSize;
+
     if (constSet.meta.maxConstIndexI != 0)
       std::memcpy(dst->iConsts, Src.iConsts, intDataSize);
-    if (constSet.meta.maxConstIndexF != 0)
+    if (constSet.meta.packedConstCountF) {
+      Vector4* data = reinterpret_cast<Vector4*>(dst->fConsts);
+
+      for (const auto& range : GetCommonShader(Shader)->GetConstantRanges()) {
+        std::memcpy(data, &Src.fConsts[range.first], range.count * sizeof(Vector4));
+        data += range.count;
+      }
+    } else if (constSet.meta.maxConstIndexF != 0) {
       std::memcpy(dst->fConsts, Src.fConsts, floatDataSize);
+    }
 
     if (constSet.meta.needsConstantCopies) {
       Vector4* data = reinterpret_cast<Vector4*>(dst->fConsts);
@@ -5663,6 +5871,9 @@ namespace dxvk {
       : 0xffffffff;
     msState.enableAlphaToCoverage = IsAlphaToCoverageEnabled();
 
+    if (!FilterBoundState(m_boundState.multiSample, msState, D3D9BoundStateGroup::MultiSample))
+      return;
+
     EmitCs([
       cState = msState
     ] (DxvkContext* ctx) {
@@ -5707,14 +5918,20 @@ namespace dxvk {
 
     mode.writeMask = state[ColorWriteIndex(0)];
 
-    std::array<VkColorComponentFlags, 3> extraWriteMasks;
+    D3D9BoundBlendState blendState;
+    blendState.mode            = mode;
+    blendState.alphaSwizzleRTs = m_alphaSwizzleRTs;
+
     for (uint32_t i = 0; i < 3; i++)
-      extraWriteMasks[i] = state[ColorWriteIndex(i + 1)];
+      blendState.writeMasks[i] = state[ColorWriteIndex(i + 1)];
+
+    if (!FilterBoundState(m_boundState.blend, blendState, D3D9BoundStateGroup::Blend))
+      return;
 
     EmitCs([
-      cMode       = mode,
-      cWriteMasks = extraWriteMasks,
-      cAlphaMasks = m_alphaSwizzleRTs
+      cMode       = blendState.mode,
+      cWriteMasks = blendState.writeMasks,
+      cAlphaMasks = blendState.alphaSwizzleRTs
     ](DxvkContext* ctx) {
       for (uint32_t i = 0; i < 4; i++) {
         DxvkBlendMode mode = cMode;
@@ -5797,6 +6014,9 @@ namespace dxvk {
     else
       state.stencilOpBack = state.stencilOpFront;
 
+    if (!FilterBoundState(m_boundState.depthStencil, state, D3D9BoundStateGroup::DepthStencil))
+      return;
+
     EmitCs([
       cState = state
     ](DxvkContext* ctx) {
@@ -5818,6 +6038,9 @@ namespace dxvk {
     state.polygonMode     = DecodeFillMode(D3DFILLMODE(rs[D3DRS_FILLMODE]));
     state.flatShading     = m_state.renderStates[D3DRS_SHADEMODE] == D3DSHADE_FLAT;
 
+    if (!FilterBoundState(m_boundState.rasterizer, state, D3D9BoundStateGroup::Rasterizer))
+      return;
+
     EmitCs([
       cState  = state
     ](DxvkContext* ctx) {
@@ -5839,6 +6062,9 @@ namespace dxvk {
     biases.depthBiasSlope    = slopeScaledDepthBias;
     biases.depthBiasClamp    = 0.0f;
 
+    if (!FilterBoundState(m_boundState.depthBias, biases, D3D9BoundStateGroup::DepthBias))
+      return;
+
     EmitCs([
       cBiases = biases
     ](DxvkContext* ctx) {
@@ -5939,6 +6165,20 @@ namespace dxvk {
 
     NormalizeSamplerKey(key);
 
+    // Samplers are only ever bound here, so the slot
+    // still holds the sampler for an identical key
+    const uint32_t samplerBit = 1u << Sampler;
+
+    if ((m_boundState.validSamplers & samplerBit)
+     && D3D9SamplerKeyEq()(m_boundState.samplers[Sampler], key)) {
+      m_stats.statesSkipped += 1;
+      return;
+    }
+
+    m_boundState.samplers[Sampler] = key;
+    m_boundState.validSamplers |= samplerBit;
+    m_stats.statesBound += 1;
+
     auto samplerInfo = RemapStateSamplerShader(Sampler);
 
     const uint32_t slot = computeResourceSlotId(
@@ -6094,7 +6334,10 @@ namespace dxvk {
   }
 
 
-  void D3D9DeviceEx::PrepareDraw(D3DPRIMITIVETYPE PrimitiveType) {
+  void D3D9DeviceEx::PrepareDraw(D3DPRIMITIVETYPE PrimitiveType, bool UpDraw) {
+    if (!UpDraw)
+      UnbindUPBuffers();
+
     if (unlikely(m_activeHazardsRT != 0))
       MarkRenderHazards();
 
@@ -6387,6 +6630,9 @@ namespace dxvk {
         D3D9VertexBuffer*                 pBuffer,
         UINT                              Offset,
         UINT                              Stride) {
+    if (Slot == 0)
+      m_upBinding.vertexSlice = DxvkBufferSlice();
+
     EmitCs([
       cSlotId       = Slot,
       cBufferSlice  = pBuffer != nullptr ?
@@ -6399,6 +6645,8 @@ namespace dxvk {
   }
 
   void D3D9DeviceEx::BindIndices() {
+    m_upBinding.indexSlice = DxvkBufferSlice();
+
     D3D9CommonBuffer* buffer = GetCommonBuffer(m_state.indices);
 
     D3D9Format format = buffer != nullptr
@@ -6446,6 +6694,7 @@ namespace dxvk {
   void D3D9DeviceEx::SetVertexBoolBitfield(uint32_t idx, uint32_t mask, uint32_t bits) {
     m_state.vsConsts.bConsts[idx] &= ~mask;
     m_state.vsConsts.bConsts[idx] |= bits & mask;
+    BumpStateGeneration(D3D9CapturedStateFlag::VsConstants);
 
     m_consts[DxsoProgramTypes::VertexShader].dirty = true;
   }
@@ -6454,6 +6703,7 @@ namespace dxvk {
   void D3D9DeviceEx::SetPixelBoolBitfield(uint32_t idx, uint32_t mask, uint32_t bits) {
     m_state.psConsts.bConsts[idx] &= ~mask;
     m_state.psConsts.bConsts[idx] |= bits & mask;
+    BumpStateGeneration(D3D9CapturedStateFlag::PsConstants);
 
     m_consts[DxsoProgramTypes::PixelShader].dirty = true;
   }
@@ -6523,16 +6773,20 @@ namespace dxvk {
       }
     }
 
-    if constexpr (ConstantType != D3D9ConstantType::Bool) {
-      uint32_t maxCount = ConstantType == D3D9ConstantType::Float
-        ? m_consts[ProgramType].meta.maxConstIndexF
-        : m_consts[ProgramType].meta.maxConstIndexI;
+    // Games frequently set the same constants for every draw, so
+    // skip marking them as dirty if nothing actually changed. With
+    // float emulation, the stored values may differ from the input,
+    // which only means that we conservatively upload them again.
+    if (CompareStateConstants<ProgramType, ConstantType, T>(&m_state, StartRegister, pConstantData, Count))
+      return D3D_OK;
 
-      m_consts[ProgramType].dirty |= StartRegister < maxCount;
+    if constexpr (ConstantType == D3D9ConstantType::Float) {
+      m_consts[ProgramType].dirtyF.Add(StartRegister, Count);
+    } else if constexpr (ConstantType == D3D9ConstantType::Int) {
+      m_consts[ProgramType].dirtyI.Add(StartRegister, Count);
     } else if constexpr (ProgramType == DxsoProgramType::VertexShader) {
-      if (unlikely(CanSWVP())) {
-        m_consts[DxsoProgramType::VertexShader].dirty |= StartRegister < m_consts[ProgramType].meta.maxConstIndexB;
-      }
+      if (unlikely(CanSWVP()))
+        m_consts[DxsoProgramType::VertexShader].dirtyB.Add(StartRegister, Count);
     }
 
     UpdateStateConstants<ProgramType, ConstantType, T>(
@@ -6542,6 +6796,10 @@ namespace dxvk {
       Count,
       m_d3d9Options.d3d9FloatEmulation == D3D9FloatEmulation::Enabled);
 
+    BumpStateGeneration(ProgramType == DxsoProgramType::VertexShader
+      ? D3D9CapturedStateFlag::VsConstants
+      : D3D9CapturedStateFlag::PsConstants);
+
     return D3D_OK;
   }
 
@@ -7217,6 +7475,10 @@ namespace dxvk {
     UpdatePixelBoolSpec(0u);
     UpdateCommonSamplerSpec(0u, 0u);
 
+    // Invalidate everything that state blocks may have seen
+    for (uint32_t i = 0; i < D3D9CapturedStateFlagCount; i++)
+      BumpStateGeneration(D3D9CapturedStateFlag(i));
+
     return D3D_OK;
   }
 
@@ -7369,6 +7631,9 @@ namespace dxvk {
       }
       (*iter)->UnmapData();
 
+      if (m_d3d9Options.compressTextureMemory)
+        (*iter)->CompressData();
+
       iter = m_mappedTextures.remove(iter);
     }
 #endif
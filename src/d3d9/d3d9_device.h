@@ -32,6 +32,7 @@
 #include <vector>
 #include <type_traits>
 #include <unordered_map>
+#include <numeric>
 
 #include "../util/util_lru.h"
 
@@ -96,6 +97,67 @@ namespace dxvk {
     void*           mapPtr = nullptr;
   };
 
+  struct D3D9UPBufferSegment {
+    Rc<DxvkBuffer>  buffer;
+    void*           mapPtr = nullptr;
+    uint64_t        sequenceNumber = 0ull;
+  };
+
+  struct D3D9UPBufferBinding {
+    DxvkBufferSlice vertexSlice;
+    uint32_t        vertexStride = 0;
+    DxvkBufferSlice indexSlice;
+    VkIndexType     indexType = VK_INDEX_TYPE_UINT32;
+  };
+
+  /**
+   * \brief Device statistics
+   *
+   * Accumulated on the application thread while the device
+   * lock is held, and published once per frame for the HUD.
+   */
+  struct D3D9DeviceStats {
+    uint64_t        upBytesAllocated      = 0ull;
+    uint64_t        upSegmentStalls       = 0ull;
+    uint64_t        constantBytesUploaded = 0ull;
+    uint64_t        sbGroupsCopied        = 0ull;
+    uint64_t        sbGroupsSkipped       = 0ull;
+    uint64_t        statesBound           = 0ull;
+    uint64_t        statesSkipped         = 0ull;
+  };
+
+  enum class D3D9BoundStateGroup : uint32_t {
+    Blend,
+    DepthStencil,
+    Rasterizer,
+    DepthBias,
+    MultiSample,
+  };
+
+  struct D3D9BoundBlendState {
+    DxvkBlendMode                        mode;
+    std::array<VkColorComponentFlags, 3> writeMasks;
+    uint32_t                             alphaSwizzleRTs;
+  };
+
+  /**
+   * \brief Translated state last sent to the backend
+   *
+   * Dirty state groups are compared against this before
+   * emitting a CS command, so that groups which were changed
+   * and then restored between two draws are not re-emitted.
+   */
+  struct D3D9BoundState {
+    D3D9BoundBlendState                  blend         = { };
+    DxvkDepthStencilState                depthStencil  = { };
+    DxvkRasterizerState                  rasterizer    = { };
+    DxvkDepthBias                        depthBias     = { };
+    DxvkMultisampleState                 multiSample   = { };
+    std::array<D3D9SamplerKey, SamplerCount> samplers  = { };
+    uint32_t                             validGroups   = 0u;
+    uint32_t                             validSamplers = 0u;
+  };
+
   struct D3D9StagingBufferMarkerPayload {
     uint64_t        sequenceNumber;
     VkDeviceSize    allocated;
@@ -115,6 +177,9 @@ namespace dxvk {
 
     constexpr static VkDeviceSize StagingBufferSize = 4ull << 20;
 
+    constexpr static VkDeviceSize UPBufferSegmentSize = 1ull << 20;
+    constexpr static uint32_t     MaxUPBufferSegments = 8;
+
     friend class D3D9SwapChainEx;
     friend class D3D9ConstantBuffer;
     friend class D3D9UserDefinedAnnotation;
@@ -873,7 +938,7 @@ namespace dxvk {
     
     uint32_t GetInstanceCount() const;
 
-    void PrepareDraw(D3DPRIMITIVETYPE PrimitiveType);
+    void PrepareDraw(D3DPRIMITIVETYPE PrimitiveType, bool UpDraw = false);
 
     template <DxsoProgramType ShaderStage>
     void BindShader(
@@ -940,6 +1005,57 @@ namespace dxvk {
       return m_samplerCount.load();
     }
 
+    /**
+     * \brief Retrieves device statistics
+     *
+     * Returns the statistics as of the last call to
+     * \ref PublishStats. Safe to call from any thread.
+     * \returns Published device statistics
+     */
+    D3D9DeviceStats GetStats() {
+      std::lock_guard<dxvk::mutex> lock(m_statsMutex);
+      return m_publishedStats;
+    }
+
+    /**
+     * \brief Publishes device statistics
+     *
+     * Called once per frame on the application thread.
+     */
+    void PublishStats() {
+      std::lock_guard<dxvk::mutex> lock(m_statsMutex);
+      m_publishedStats = m_stats;
+    }
+
+    /**
+     * \brief Adds state block group counts to the statistics
+     *
+     * \param [in] Copied Number of state groups copied
+     * \param [in] Skipped Number of state groups skipped
+     */
+    void AddStateBlockStats(uint32_t Copied, uint32_t Skipped) {
+      m_stats.sbGroupsCopied  += Copied;
+      m_stats.sbGroupsSkipped += Skipped;
+    }
+
+    /**
+     * \brief Queries generation of a device state group
+     *
+     * The generation changes whenever device state that belongs
+     * to the given group is modified, which allows state blocks
+     * to skip capturing or applying state that is known to
+     * already match the current device state.
+     * \param [in] Group State group
+     * \returns Current generation of the group
+     */
+    uint64_t GetStateGeneration(D3D9CapturedStateFlag Group) const {
+      return m_stateGenerations[uint32_t(Group)];
+    }
+
+    bool IsRecording() const {
+      return m_recorder != nullptr;
+    }
+
     D3D9MemoryAllocator* GetAllocator() {
       return &m_memoryAllocator;
     }
@@ -980,7 +1096,19 @@ namespace dxvk {
 
     void DetermineConstantLayouts(bool canSWVP);
 
-    D3D9BufferSlice AllocUPBuffer(VkDeviceSize size);
+    D3D9BufferSlice AllocUPBuffer(VkDeviceSize size, VkDeviceSize alignment);
+
+    Rc<DxvkBuffer> CreateUPBuffer(VkDeviceSize size);
+
+    void NextUPBufferSegment();
+
+    bool IsUPBufferSegmentBusy(const D3D9UPBufferSegment& segment);
+
+    uint32_t BindUPVertexBuffer(const DxvkBufferSlice& slice, uint32_t stride);
+
+    uint32_t BindUPIndexBuffer(const DxvkBufferSlice& slice, VkIndexType indexType);
+
+    void UnbindUPBuffers();
 
     D3D9BufferSlice AllocStagingBuffer(VkDeviceSize size);
 
@@ -990,6 +1118,53 @@ namespace dxvk {
 
     bool ShouldRecord();
 
+    void BumpStateGeneration(D3D9CapturedStateFlag Group) {
+      m_stateGenerations[uint32_t(Group)] += 1;
+    }
+
+    /**
+     * \brief Compares translated state
+     *
+     * Plain integer state is compared bytewise, which is
+     * only valid as long as it contains no padding. State
+     * with floating point members is compared by value.
+     */
+    template<typename T>
+    static bool IsBoundStateEqual(const T& A, const T& B) {
+      static_assert(std::has_unique_object_representations_v<T>,
+        "Bound state must not contain padding bytes");
+      return !std::memcmp(&A, &B, sizeof(T));
+    }
+
+    static bool IsBoundStateEqual(const DxvkDepthBias& A, const DxvkDepthBias& B) {
+      return A == B;
+    }
+
+    /**
+     * \brief Checks whether translated state needs to be emitted
+     *
+     * Updates the state last sent to the backend for the given
+     * group and accounts for it in the filter statistics.
+     * \param [in,out] Bound State last sent to the backend
+     * \param [in] State Newly translated state
+     * \param [in] Group State group
+     * \returns \c true if the state differs from the bound state
+     */
+    template<typename T>
+    bool FilterBoundState(T& Bound, const T& State, D3D9BoundStateGroup Group) {
+      const uint32_t bit = 1u << uint32_t(Group);
+
+      if ((m_boundState.validGroups & bit) && IsBoundStateEqual(Bound, State)) {
+        m_stats.statesSkipped += 1;
+        return false;
+      }
+
+      Bound = State;
+      m_boundState.validGroups |= bit;
+      m_stats.statesBound += 1;
+      return true;
+    }
+
     HRESULT               CreateShaderModule(
             D3D9CommonShader*     pShaderModule,
             uint32_t*             pLength,
@@ -1001,6 +1176,13 @@ namespace dxvk {
       return vertexCount * stride;
     }
 
+    inline VkDeviceSize GetUPBufferAlignment(uint32_t stride) {
+      // Vertex data must start at a multiple of the stride so that we can
+      // address it via the first vertex index, and index data placed right
+      // behind the vertex data relies on a four-byte aligned start offset
+      return stride ? std::lcm<VkDeviceSize, VkDeviceSize>(stride, 4) : 4;
+    }
+
     inline uint32_t GetUPBufferSize(uint32_t vertexCount, uint32_t stride) {
       return (vertexCount - 1) * stride + std::max(m_state.vertexDecl->GetSize(), stride);
     }
@@ -1196,9 +1378,13 @@ namespace dxvk {
     D3D9ConstantBuffer              m_psShared;
     D3D9ConstantBuffer              m_specBuffer;
 
-    Rc<DxvkBuffer>                  m_upBuffer;
+    std::vector<D3D9UPBufferSegment> m_upSegments;
+    uint32_t                        m_upSegmentIndex  = 0u;
     VkDeviceSize                    m_upBufferOffset  = 0ull;
-    void*                           m_upBufferMapPtr  = nullptr;
+    D3D9UPBufferBinding             m_upBinding;
+    D3D9BoundState                  m_boundState;
+
+    std::array<uint64_t, D3D9CapturedStateFlagCount> m_stateGenerations = { };
 
     DxvkStagingBuffer               m_stagingBuffer;
     VkDeviceSize                    m_stagingBufferAllocated      = 0ull;
@@ -1311,6 +1497,11 @@ namespace dxvk {
     std::atomic<int64_t>            m_availableMemory = { 0 };
     std::atomic<int32_t>            m_samplerCount    = { 0 };
 
+    D3D9DeviceStats                 m_stats;
+
+    dxvk::mutex                     m_statsMutex;
+    D3D9DeviceStats                 m_publishedStats;
+
     Direct3DState9                  m_state;
 
 #ifdef D3D9_ALLOW_UNMAPPING
@@ -2409,7 +2409,6 @@ namespace dxvk {
     Dump(Key, name);
 
     m_shader->setShaderKey(shaderKey);
-    pDevice->GetDXVKDevice()->registerShader(m_shader);
   }
 
 
@@ -2432,7 +2431,6 @@ namespace dxvk {
     Dump(Key, name);
 
     m_shader->setShaderKey(shaderKey);
-    pDevice->GetDXVKDevice()->registerShader(m_shader);
   }
 
   template <typename T>
@@ -2449,37 +2447,257 @@ namespace dxvk {
   }
 
 
-  D3D9FFShader D3D9FFShaderModuleSet::GetShaderModule(
+  struct D3D9FFShaderKeyCacheHeader {
+    char     magic[4]   = { 'D', 'F', 'F', 'K' };
+    uint32_t version    = 1;
+    uint32_t vsKeySize  = sizeof(D3D9FFShaderKeyVS);
+    uint32_t fsKeySize  = sizeof(D3D9FFShaderKeyFS);
+  };
+
+
+  D3D9FFShaderKeyCache::D3D9FFShaderKeyCache(
+    const Rc<DxvkDevice>&       Device) {
+    // Follow the state cache settings, since pre-compiled
+    // shaders are mostly useful together with its pipelines
+    std::string useStateCache = env::getEnvVar("DXVK_STATE_CACHE");
+    m_enable = useStateCache != "0" && useStateCache != "disable" &&
+      Device->config().enableStateCache;
+    m_reset  = useStateCache == "reset";
+  }
+
+
+  void D3D9FFShaderKeyCache::ReadKeys(
+          std::vector<D3D9FFShaderKeyVS>& VsKeys,
+          std::vector<D3D9FFShaderKeyFS>& FsKeys) {
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+    if (!m_enable)
+      return;
+
+    std::ifstream file(GetCacheFileName().c_str(), std::ios_base::binary);
+
+    D3D9FFShaderKeyCacheHeader expected;
+    D3D9FFShaderKeyCacheHeader actual;
+
+    bool valid = !m_reset
+      && bool(file.read(reinterpret_cast<char*>(&actual), sizeof(actual)))
+      && std::memcmp(&actual, &expected, sizeof(actual)) == 0;
+
+    while (valid) {
+      uint32_t stage = 0;
+
+      if (!file.read(reinterpret_cast<char*>(&stage), sizeof(stage)))
+        break;
+
+      if (stage == VK_SHADER_STAGE_VERTEX_BIT) {
+        D3D9FFShaderKeyVS key;
+
+        if (!file.read(reinterpret_cast<char*>(&key), sizeof(key)))
+          valid = false;
+        else if (m_vsKeys.insert(key).second)
+          VsKeys.push_back(key);
+      } else if (stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
+        D3D9FFShaderKeyFS key;
+
+        if (!file.read(reinterpret_cast<char*>(&key), sizeof(key)))
+          valid = false;
+        else if (m_fsKeys.insert(key).second)
+          FsKeys.push_back(key);
+      } else {
+        valid = false;
+      }
+    }
+
+    file.close();
+
+    // Start over with the keys we could read if the
+    // file is missing, outdated or otherwise invalid
+    bool newFile = !valid;
+
+    if (newFile) {
+      m_file.open(GetCacheFileName().c_str(), std::ios_base::binary | std::ios_base::trunc);
+
+      if (!m_file && env::createDirectory(GetCacheDir()))
+        m_file.open(GetCacheFileName().c_str(), std::ios_base::binary | std::ios_base::trunc);
+
+      D3D9FFShaderKeyCacheHeader header;
+      m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+      for (const auto& key : VsKeys)
+        WriteKey(VK_SHADER_STAGE_VERTEX_BIT, &key, sizeof(key));
+
+      for (const auto& key : FsKeys)
+        WriteKey(VK_SHADER_STAGE_FRAGMENT_BIT, &key, sizeof(key));
+    } else {
+      m_file.open(GetCacheFileName().c_str(), std::ios_base::binary | std::ios_base::app);
+    }
+
+    m_file.flush();
+
+    if (!m_file) {
+      Logger::warn("D3D9FFShaderKeyCache: Failed to open cache file");
+      m_enable = false;
+    }
+  }
+
+
+  void D3D9FFShaderKeyCache::AddKey(const D3D9FFShaderKeyVS& Key) {
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+    if (m_enable && m_vsKeys.insert(Key).second) {
+      WriteKey(VK_SHADER_STAGE_VERTEX_BIT, &Key, sizeof(Key));
+      m_file.flush();
+    }
+  }
+
+
+  void D3D9FFShaderKeyCache::AddKey(const D3D9FFShaderKeyFS& Key) {
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+    if (m_enable && m_fsKeys.insert(Key).second) {
+      WriteKey(VK_SHADER_STAGE_FRAGMENT_BIT, &Key, sizeof(Key));
+      m_file.flush();
+    }
+  }
+
+
+  void D3D9FFShaderKeyCache::WriteKey(
+          VkShaderStageFlagBits Stage,
+    const void*                 pKey,
+          size_t                KeySize) {
+    uint32_t stage = uint32_t(Stage);
+
+    m_file.write(reinterpret_cast<const char*>(&stage), sizeof(stage));
+    m_file.write(reinterpret_cast<const char*>(pKey), KeySize);
+  }
+
+
+  str::path_string D3D9FFShaderKeyCache::GetCacheFileName() const {
+    std::string path = GetCacheDir();
+
+    if (!path.empty() && *path.rbegin() != '/')
+      path += '/';
+
+    std::string exeName = env::getExeBaseName();
+    path += exeName + ".dxvk-ffcache";
+    return str::topath(path.c_str());
+  }
+
+
+  std::string D3D9FFShaderKeyCache::GetCacheDir() const {
+    return env::getEnvVar("DXVK_STATE_CACHE_PATH");
+  }
+
+
+  D3D9FFShaderModuleSet::D3D9FFShaderModuleSet(
+    const Rc<DxvkDevice>&       Device)
+  : m_keyCache(Device) {
+
+  }
+
+
+  D3D9FFShaderModuleSet::~D3D9FFShaderModuleSet() {
+    StopPrewarm();
+  }
+
+
+  template<typename Key, typename Map>
+  D3D9FFShader D3D9FFShaderModuleSet::GetOrCreateModule(
           D3D9DeviceEx*         pDevice,
-    const D3D9FFShaderKeyVS&    ShaderKey) {
+          Map&                  Modules,
+    const Key&                  ShaderKey) {
     // Use the shader's unique key for the lookup
-    auto entry = m_vsModules.find(ShaderKey);
-    if (entry != m_vsModules.end())
-      return entry->second;
-    
+    { std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+      auto entry = Modules.find(ShaderKey);
+      if (entry != Modules.end())
+        return entry->second;
+    }
+
+    // The shader may be compiled on the prewarm thread
+    // and the CS thread at the same time, so don't hold
+    // the lock while compiling. If another thread wins
+    // the race, discard our shader before registering it.
     D3D9FFShader shader(
       pDevice, ShaderKey);
 
-    m_vsModules.insert({ShaderKey, shader});
+    { std::unique_lock<dxvk::mutex> lock(m_mutex);
 
+      auto status = Modules.insert({ ShaderKey, shader });
+      if (!status.second)
+        return status.first->second;
+
+      // Register under the lock so that no other thread can
+      // look up the shader before the device knows about it
+      pDevice->GetDXVKDevice()->registerShader(shader.GetShader());
+    }
+
+    m_keyCache.AddKey(ShaderKey);
     return shader;
   }
 
 
+  D3D9FFShader D3D9FFShaderModuleSet::GetShaderModule(
+          D3D9DeviceEx*         pDevice,
+    const D3D9FFShaderKeyVS&    ShaderKey) {
+    return GetOrCreateModule(pDevice, m_vsModules, ShaderKey);
+  }
+
+
   D3D9FFShader D3D9FFShaderModuleSet::GetShaderModule(
           D3D9DeviceEx*         pDevice,
     const D3D9FFShaderKeyFS&    ShaderKey) {
-    // Use the shader's unique key for the lookup
-    auto entry = m_fsModules.find(ShaderKey);
-    if (entry != m_fsModules.end())
-      return entry->second;
-    
-    D3D9FFShader shader(
-      pDevice, ShaderKey);
+    return GetOrCreateModule(pDevice, m_fsModules, ShaderKey);
+  }
 
-    m_fsModules.insert({ShaderKey, shader});
 
-    return shader;
+  void D3D9FFShaderModuleSet::Prewarm(
+          D3D9DeviceEx*         pDevice) {
+    // Read keys up front so that any shader compiled by the
+    // application in the meantime is recorded correctly
+    std::vector<D3D9FFShaderKeyVS> vsKeys;
+    std::vector<D3D9FFShaderKeyFS> fsKeys;
+
+    m_keyCache.ReadKeys(vsKeys, fsKeys);
+
+    if (vsKeys.empty() && fsKeys.empty())
+      return;
+
+    Logger::info(str::format("D3D9: Compiling ", vsKeys.size(), " fixed function vertex shaders and ",
+      fsKeys.size(), " fixed function pixel shaders from cache"));
+
+    m_prewarmThread = dxvk::thread([
+      this,
+      pDevice,
+      cVsKeys = std::move(vsKeys),
+      cFsKeys = std::move(fsKeys)
+    ] () {
+      env::setThreadName("dxvk-d3d9-ff");
+
+      for (const auto& key : cVsKeys) {
+        if (m_stopPrewarm.load())
+          return;
+
+        GetShaderModule(pDevice, key);
+      }
+
+      for (const auto& key : cFsKeys) {
+        if (m_stopPrewarm.load())
+          return;
+
+        GetShaderModule(pDevice, key);
+      }
+    });
+
+    m_prewarmThread.set_priority(ThreadPriority::Lowest);
+  }
+
+
+  void D3D9FFShaderModuleSet::StopPrewarm() {
+    m_stopPrewarm.store(true);
+
+    if (m_prewarmThread.joinable())
+      m_prewarmThread.join();
   }
 
 
@@ -8,12 +8,18 @@
 
 #include "../dxso/dxso_isgn.h"
 
+#include "../util/thread.h"
+
+#include <atomic>
+#include <fstream>
 #include <unordered_map>
+#include <unordered_set>
 #include <bitset>
 
 namespace dxvk {
 
   class D3D9DeviceEx;
+  class DxvkDevice;
   class SpirvModule;
 
   struct D3D9Options;
@@ -232,10 +238,78 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Fixed function shader key cache
+   *
+   * Records every fixed function shader key that an
+   * application uses into a per-executable file next to
+   * the DXVK state cache, so that the corresponding shaders
+   * can be compiled ahead of time on subsequent runs.
+   */
+  class D3D9FFShaderKeyCache {
+
+  public:
+
+    D3D9FFShaderKeyCache(
+      const Rc<DxvkDevice>&       Device);
+
+    /**
+     * \brief Reads keys from the cache file
+     *
+     * All keys that were read are considered to be
+     * known and will not be written to the file again.
+     * \param [out] VsKeys Vertex shader keys
+     * \param [out] FsKeys Pixel shader keys
+     */
+    void ReadKeys(
+            std::vector<D3D9FFShaderKeyVS>& VsKeys,
+            std::vector<D3D9FFShaderKeyFS>& FsKeys);
+
+    /**
+     * \brief Adds a key to the cache file
+     *
+     * Does nothing if the key is already known.
+     * \param [in] Key Shader key
+     */
+    void AddKey(const D3D9FFShaderKeyVS& Key);
+    void AddKey(const D3D9FFShaderKeyFS& Key);
+
+  private:
+
+    dxvk::mutex   m_mutex;
+    bool          m_enable = false;
+    bool          m_reset  = false;
+    std::ofstream m_file;
+
+    std::unordered_set<
+      D3D9FFShaderKeyVS,
+      D3D9FFShaderKeyHash, D3D9FFShaderKeyEq> m_vsKeys;
+
+    std::unordered_set<
+      D3D9FFShaderKeyFS,
+      D3D9FFShaderKeyHash, D3D9FFShaderKeyEq> m_fsKeys;
+
+    void WriteKey(
+            VkShaderStageFlagBits Stage,
+      const void*                 pKey,
+            size_t                KeySize);
+
+    str::path_string GetCacheFileName() const;
+
+    std::string GetCacheDir() const;
+
+  };
+
+
   class D3D9FFShaderModuleSet : public RcObject {
 
   public:
 
+    D3D9FFShaderModuleSet(
+      const Rc<DxvkDevice>&       Device);
+
+    ~D3D9FFShaderModuleSet();
+
     D3D9FFShader GetShaderModule(
             D3D9DeviceEx*         pDevice,
       const D3D9FFShaderKeyVS&    ShaderKey);
@@ -244,8 +318,29 @@ namespace dxvk {
             D3D9DeviceEx*         pDevice,
       const D3D9FFShaderKeyFS&    ShaderKey);
 
+    /**
+     * \brief Starts compiling cached shader variants
+     *
+     * Compiles all shaders recorded in the key cache on a
+     * background thread. Registering the shaders with the
+     * DXVK device also compiles any state cache pipelines
+     * that use them.
+     * \param [in] pDevice The device
+     */
+    void Prewarm(
+            D3D9DeviceEx*         pDevice);
+
+    /**
+     * \brief Stops compiling cached shader variants
+     *
+     * Must be called before the device is destroyed.
+     */
+    void StopPrewarm();
+
   private:
 
+    dxvk::mutex           m_mutex;
+
     std::unordered_map<
       D3D9FFShaderKeyVS,
       D3D9FFShader,
@@ -256,6 +351,17 @@ namespace dxvk {
       D3D9FFShader,
       D3D9FFShaderKeyHash, D3D9FFShaderKeyEq> m_fsModules;
 
+    D3D9FFShaderKeyCache  m_keyCache;
+
+    std::atomic<bool>     m_stopPrewarm = { false };
+    dxvk::thread          m_prewarmThread;
+
+    template<typename Key, typename Map>
+    D3D9FFShader GetOrCreateModule(
+            D3D9DeviceEx*         pDevice,
+            Map&                  Modules,
+      const Key&                  ShaderKey);
+
   };
 
 
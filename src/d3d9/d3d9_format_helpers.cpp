@@ -7,8 +7,126 @@
 #include <d3d9_convert_nv12.h>
 #include <d3d9_convert_yv12.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace dxvk {
 
+  // Images up to this many pixels are converted on the CPU
+  constexpr uint32_t MaxHostConversionPixels = 256 * 256;
+
+
+  static uint16_t FloatToHalf(float value) {
+    uint32_t bits = bit::cast<uint32_t>(value);
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    int32_t  exp  = int32_t((bits >> 23) & 0xffu) - 127 + 15;
+    uint32_t mant = bits & 0x7fffffu;
+
+    // Normalized values never exceed 1.0, no need
+    // to care about infinities or NaN
+    if (exp <= 0) {
+      if (exp < -10)
+        return uint16_t(sign);
+
+      uint32_t shift = uint32_t(14 - exp);
+      uint32_t half  = (mant | 0x800000u) >> shift;
+      uint32_t rem   = (mant | 0x800000u) & ((1u << shift) - 1u);
+      uint32_t mid   = 1u << (shift - 1u);
+
+      if (rem > mid || (rem == mid && (half & 1u)))
+        half += 1;
+
+      return uint16_t(sign | half);
+    }
+
+    uint32_t half = (uint32_t(exp) << 10) | (mant >> 13);
+    uint32_t rem  = mant & 0x1fffu;
+
+    // Round to nearest even, a carry into the
+    // exponent produces the correct result
+    if (rem > 0x1000u || (rem == 0x1000u && (half & 1u)))
+      half += 1;
+
+    return uint16_t(sign | half);
+  }
+
+
+  /**
+   * \brief Half-float lookup tables for packed formats
+   *
+   * Stores the result of the \c snormalize and \c unormalize
+   * shader functions for every possible raw component value.
+   */
+  struct D3D9HostConversionTables {
+    std::array<uint16_t, 32>   snorm5;
+    std::array<uint16_t, 256>  snorm8;
+    std::array<uint16_t, 1024> snorm10;
+    std::array<uint16_t, 4>    unorm2;
+    std::array<uint16_t, 64>   unorm6;
+    std::array<uint16_t, 256>  unorm8;
+    uint16_t                   one;
+
+    D3D9HostConversionTables() {
+      InitSnorm(snorm5.data(),  5);
+      InitSnorm(snorm8.data(),  8);
+      InitSnorm(snorm10.data(), 10);
+      InitUnorm(unorm2.data(),  2);
+      InitUnorm(unorm6.data(),  6);
+      InitUnorm(unorm8.data(),  8);
+      one = FloatToHalf(1.0f);
+    }
+
+    static void InitSnorm(uint16_t* table, uint32_t bits) {
+      const int32_t range = (1 << (bits - 1)) - 1;
+
+      for (uint32_t i = 0; i < (1u << bits); i++) {
+        int32_t value = i < (1u << (bits - 1))
+          ? int32_t(i) : int32_t(i) - int32_t(1u << bits);
+        table[i] = FloatToHalf(std::max(float(value) / float(range), -1.0f));
+      }
+    }
+
+    static void InitUnorm(uint16_t* table, uint32_t bits) {
+      const int32_t range = (1 << bits) - 1;
+
+      for (uint32_t i = 0; i < (1u << bits); i++)
+        table[i] = FloatToHalf(float(i) / float(range));
+    }
+  };
+
+
+  static const D3D9HostConversionTables& GetHostConversionTables() {
+    static const D3D9HostConversionTables s_tables;
+    return s_tables;
+  }
+
+
+  template<typename T, typename Fn>
+  static void ConvertRows(
+          void*                         dst,
+    const void*                         src,
+          VkExtent3D                    extent,
+          VkDeviceSize                  srcRowPitch,
+          VkDeviceSize                  srcSlicePitch,
+    const Fn&                           fn) {
+    auto dstPixels = reinterpret_cast<uint16_t*>(dst);
+
+    for (uint32_t z = 0; z < extent.depth; z++) {
+      for (uint32_t y = 0; y < extent.height; y++) {
+        auto srcRow = reinterpret_cast<const uint8_t*>(src)
+                    + z * srcSlicePitch + y * srcRowPitch;
+
+        for (uint32_t x = 0; x < extent.width; x++) {
+          T value;
+          std::memcpy(&value, srcRow + x * sizeof(T), sizeof(T));
+          fn(value, dstPixels);
+          dstPixels += 4;
+        }
+      }
+    }
+  }
+
+
   D3D9FormatHelper::D3D9FormatHelper(const Rc<DxvkDevice>& device)
     : m_device(device), m_context(m_device->createContext(DxvkContextType::Supplementary)) {
     m_context->beginRecording(
@@ -63,6 +181,76 @@ namespace dxvk {
   }
 
 
+  bool D3D9FormatHelper::CanConvertOnHost(
+          D3D9_CONVERSION_FORMAT_INFO   conversionFormat,
+          VkExtent3D                    extent) {
+    switch (conversionFormat.FormatType) {
+      case D3D9ConversionFormat_L6V5U5:
+      case D3D9ConversionFormat_X8L8V8U8:
+      case D3D9ConversionFormat_A2W10V10U10:
+        return uint64_t(extent.width) * extent.height * extent.depth <= MaxHostConversionPixels;
+
+      default:
+        return false;
+    }
+  }
+
+
+  VkDeviceSize D3D9FormatHelper::GetHostConversionSize(
+          D3D9_CONVERSION_FORMAT_INFO   conversionFormat,
+          VkExtent3D                    extent) {
+    // All formats supported on the host convert to RGBA16F
+    return VkDeviceSize(extent.width) * extent.height * extent.depth * 4 * sizeof(uint16_t);
+  }
+
+
+  void D3D9FormatHelper::ConvertFormatOnHost(
+          D3D9_CONVERSION_FORMAT_INFO   conversionFormat,
+          void*                         dst,
+    const void*                         src,
+          VkExtent3D                    extent,
+          VkDeviceSize                  srcRowPitch,
+          VkDeviceSize                  srcSlicePitch) {
+    const auto& tables = GetHostConversionTables();
+
+    switch (conversionFormat.FormatType) {
+      case D3D9ConversionFormat_L6V5U5:
+        ConvertRows<uint16_t>(dst, src, extent, srcRowPitch, srcSlicePitch,
+          [&tables] (uint16_t value, uint16_t* pixel) {
+            pixel[0] = tables.snorm5[(value >>  0) & 0x1f];
+            pixel[1] = tables.snorm5[(value >>  5) & 0x1f];
+            pixel[2] = tables.unorm6[(value >> 10) & 0x3f];
+            pixel[3] = tables.one;
+          });
+        break;
+
+      case D3D9ConversionFormat_X8L8V8U8:
+        ConvertRows<uint32_t>(dst, src, extent, srcRowPitch, srcSlicePitch,
+          [&tables] (uint32_t value, uint16_t* pixel) {
+            pixel[0] = tables.snorm8[(value >>  0) & 0xff];
+            pixel[1] = tables.snorm8[(value >>  8) & 0xff];
+            pixel[2] = tables.unorm8[(value >> 16) & 0xff];
+            pixel[3] = tables.one;
+          });
+        break;
+
+      case D3D9ConversionFormat_A2W10V10U10:
+        ConvertRows<uint32_t>(dst, src, extent, srcRowPitch, srcSlicePitch,
+          [&tables] (uint32_t value, uint16_t* pixel) {
+            pixel[0] = tables.snorm10[(value >>  0) & 0x3ff];
+            pixel[1] = tables.snorm10[(value >> 10) & 0x3ff];
+            pixel[2] = tables.snorm10[(value >> 20) & 0x3ff];
+            pixel[3] = tables.unorm2 [(value >> 30) & 0x3];
+          });
+        break;
+
+      default:
+        // Callers only get here for formats accepted by CanConvertOnHost
+        break;
+    }
+  }
+
+
   void D3D9FormatHelper::ConvertGenericFormat(
           D3D9_CONVERSION_FORMAT_INFO   videoFormat,
     const Rc<DxvkImage>&                dstImage,
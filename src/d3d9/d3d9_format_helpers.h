@@ -21,6 +21,51 @@ namespace dxvk {
             VkImageSubresourceLayers      dstSubresource,
       const DxvkBufferSlice&              srcSlice);
 
+    /**
+     * \brief Checks whether a conversion can run on the CPU
+     *
+     * Small images in one of the packed signed formats are
+     * cheaper to convert while writing the staging buffer
+     * than to synchronize with the CS thread for a dispatch.
+     * \param [in] conversionFormat Conversion format
+     * \param [in] extent Image extent, in pixels
+     * \returns \c true if \ref ConvertFormatOnHost can be used
+     */
+    static bool CanConvertOnHost(
+            D3D9_CONVERSION_FORMAT_INFO   conversionFormat,
+            VkExtent3D                    extent);
+
+    /**
+     * \brief Computes size of CPU-converted image data
+     *
+     * \param [in] conversionFormat Conversion format
+     * \param [in] extent Image extent, in pixels
+     * \returns Tightly packed size of the converted data
+     */
+    static VkDeviceSize GetHostConversionSize(
+            D3D9_CONVERSION_FORMAT_INFO   conversionFormat,
+            VkExtent3D                    extent);
+
+    /**
+     * \brief Converts image data on the CPU
+     *
+     * Produces the same values as the conversion shaders and
+     * writes them tightly packed in the image's Vulkan format.
+     * \param [in] conversionFormat Conversion format
+     * \param [out] dst Destination data
+     * \param [in] src Source data in the D3D9 format
+     * \param [in] extent Image extent, in pixels
+     * \param [in] srcRowPitch Source row pitch
+     * \param [in] srcSlicePitch Source slice pitch
+     */
+    static void ConvertFormatOnHost(
+            D3D9_CONVERSION_FORMAT_INFO   conversionFormat,
+            void*                         dst,
+      const void*                         src,
+            VkExtent3D                    extent,
+            VkDeviceSize                  srcRowPitch,
+            VkDeviceSize                  srcSlicePitch);
+
   private:
 
     void ConvertGenericFormat(
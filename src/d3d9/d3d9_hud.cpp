@@ -33,10 +33,90 @@ namespace dxvk::hud {
     return position;
   }
 
+
+  HudD3D9Stats::HudD3D9Stats(D3D9DeviceEx* device)
+    : m_device    (device)
+    , m_prevStats (device->GetStats()) {
+
+  }
+
+
+  void HudD3D9Stats::update(dxvk::high_resolution_clock::time_point time) {
+    m_frameCount += 1;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate);
+
+    if (elapsed.count() < UpdateInterval)
+      return;
+
+    D3D9DeviceStats stats = m_device->GetStats();
+
+    uint64_t upBytes       = stats.upBytesAllocated      - m_prevStats.upBytesAllocated;
+    uint64_t upStalls      = stats.upSegmentStalls       - m_prevStats.upSegmentStalls;
+    uint64_t constBytes    = stats.constantBytesUploaded - m_prevStats.constantBytesUploaded;
+    uint64_t sbCopied      = stats.sbGroupsCopied        - m_prevStats.sbGroupsCopied;
+    uint64_t sbSkipped     = stats.sbGroupsSkipped       - m_prevStats.sbGroupsSkipped;
+    uint64_t statesBound   = stats.statesBound           - m_prevStats.statesBound;
+    uint64_t statesSkipped = stats.statesSkipped         - m_prevStats.statesSkipped;
+
+    m_upBytesString     = str::format((upBytes    / m_frameCount) >> 10, " kB / frame");
+    m_upStallString     = str::format(upStalls);
+    m_constBytesString  = str::format((constBytes / m_frameCount) >> 10, " kB / frame");
+    m_sbCopiedString    = str::format(sbCopied      / m_frameCount, " / frame");
+    m_sbSkippedString   = str::format(sbSkipped     / m_frameCount, " / frame");
+    m_statesBoundString = str::format(statesBound   / m_frameCount, " / frame");
+    m_statesSkipString  = str::format(statesSkipped / m_frameCount, " / frame");
+
+    m_prevStats  = stats;
+    m_frameCount = 0;
+    m_lastUpdate = time;
+  }
+
+
+  HudPos HudD3D9Stats::render(
+          HudRenderer&      renderer,
+          HudPos            position) {
+    position = drawLine(renderer, position, "UP data:",       m_upBytesString);
+    position = drawLine(renderer, position, "UP stalls:",     m_upStallString);
+    position = drawLine(renderer, position, "Constants:",     m_constBytesString);
+    position = drawLine(renderer, position, "SB copied:",     m_sbCopiedString);
+    position = drawLine(renderer, position, "SB skipped:",    m_sbSkippedString);
+    position = drawLine(renderer, position, "States bound:",  m_statesBoundString);
+    position = drawLine(renderer, position, "States skipped:", m_statesSkipString);
+
+    position.y += 8.0f;
+    return position;
+  }
+
+
+  HudPos HudD3D9Stats::drawLine(
+          HudRenderer&      renderer,
+          HudPos            position,
+    const char*             label,
+    const std::string&      value) {
+    position.y += 20.0f;
+
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.0f, 1.0f, 0.75f, 1.0f },
+      label);
+
+    renderer.drawText(16.0f,
+      { position.x + 150.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      value);
+
+    return position;
+  }
+
+
   HudTextureMemory::HudTextureMemory(D3D9DeviceEx* device)
           : m_device          (device)
+          , m_showCompression (device->GetOptions()->compressTextureMemory)
+          , m_prevCompression (device->GetAllocator()->CompressionStats())
           , m_allocatedString ("")
-          , m_mappedString    ("") {}
+          , m_mappedString    ("")
+          , m_compressedString("") {}
 
 
   void HudTextureMemory::update(dxvk::high_resolution_clock::time_point time) {
@@ -53,6 +133,20 @@ namespace dxvk::hud {
 
     m_allocatedString = str::format(m_maxAllocated >> 20, " MB (Used: ", m_maxUsed >> 20, " MB)");
     m_mappedString = str::format(m_maxMapped >> 20, " MB");
+
+    if (m_showCompression) {
+      D3D9MemoryCompressionStats compression = allocator->CompressionStats();
+
+      uint64_t decompressCount = compression.decompressCount - m_prevCompression.decompressCount;
+      uint64_t decompressTime  = compression.decompressTime  - m_prevCompression.decompressTime;
+
+      m_compressedString = str::format(compression.uncompressedSize >> 20, " MB -> ",
+        compression.compressedSize >> 20, " MB (Decompress: ",
+        decompressCount ? decompressTime / decompressCount : 0, " us)");
+
+      m_prevCompression = compression;
+    }
+
     m_maxAllocated = 0;
     m_maxUsed = 0;
     m_maxMapped = 0;
@@ -87,6 +181,20 @@ namespace dxvk::hud {
                       { 1.0f, 1.0f, 1.0f, 1.0f },
                       m_mappedString);
 
+    if (m_showCompression) {
+      position.y += 24.0f;
+
+      renderer.drawText(16.0f,
+                        { position.x, position.y },
+                        { 0.0f, 1.0f, 0.75f, 1.0f },
+                        "Compressed:");
+
+      renderer.drawText(16.0f,
+                        { position.x + 120.0f, position.y },
+                        { 1.0f, 1.0f, 1.0f, 1.0f },
+                        m_compressedString);
+    }
+
     position.y += 8.0f;
 
     return position;
@@ -26,6 +26,52 @@ namespace dxvk::hud {
 
     std::string m_samplerCount;
 
+  };
+
+  /**
+   * \brief HUD item to display device statistics
+   *
+   * Shows UP draw data, constant uploads, state block
+   * groups and filtered states, averaged per frame over
+   * the update interval.
+   */
+  class HudD3D9Stats : public HudItem {
+    constexpr static int64_t UpdateInterval = 500'000;
+
+  public:
+
+    HudD3D9Stats(D3D9DeviceEx* device);
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+            HudRenderer&      renderer,
+            HudPos            position);
+
+  private:
+
+    D3D9DeviceEx*   m_device;
+
+    D3D9DeviceStats m_prevStats;
+    uint64_t        m_frameCount = 0;
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+    std::string m_upBytesString     = "0 kB";
+    std::string m_upStallString     = "0";
+    std::string m_constBytesString  = "0 kB";
+    std::string m_sbCopiedString    = "0";
+    std::string m_sbSkippedString   = "0";
+    std::string m_statesBoundString = "0";
+    std::string m_statesSkipString  = "0";
+
+    HudPos drawLine(
+            HudRenderer&      renderer,
+            HudPos            position,
+      const char*             label,
+      const std::string&      value);
+
   };
 
     /**
@@ -48,15 +94,20 @@ namespace dxvk::hud {
 
         D3D9DeviceEx* m_device;
 
+        bool m_showCompression;
+
         uint32_t m_maxAllocated = 0;
         uint32_t m_maxUsed      = 0;
         uint32_t m_maxMapped    = 0;
 
+        D3D9MemoryCompressionStats m_prevCompression;
+
         dxvk::high_resolution_clock::time_point m_lastUpdate
           = dxvk::high_resolution_clock::now();
 
         std::string m_allocatedString;
         std::string m_mappedString;
+        std::string m_compressedString;
 
     };
 
@@ -3,11 +3,21 @@
 #include "../util/util_math.h"
 #include "../util/log/log.h"
 #include "../util/util_likely.h"
+#include "../util/util_env.h"
+#include "../util/util_lz.h"
+#include "../util/util_time.h"
 #include <utility>
 
 #ifdef D3D9_ALLOW_UNMAPPING
+#ifdef _WIN32
 #include <sysinfoapi.h>
 #else
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#else
 #include <stdlib.h>
 #endif
 
@@ -15,9 +25,26 @@ namespace dxvk {
 
 #ifdef D3D9_ALLOW_UNMAPPING
   D3D9MemoryAllocator::D3D9MemoryAllocator() {
+#ifdef _WIN32
     SYSTEM_INFO sysInfo;
     GetSystemInfo(&sysInfo);
     m_allocationGranularity = sysInfo.dwAllocationGranularity;
+#else
+    // mmap only requires page alignment, but use the same granularity
+    // as Windows in order to keep the number of mappings low, since
+    // those count towards vm.max_map_count.
+    m_allocationGranularity = std::max<uint32_t>(sysconf(_SC_PAGESIZE), 64u << 10);
+#endif
+  }
+
+  D3D9MemoryAllocator::~D3D9MemoryAllocator() {
+    { std::lock_guard<dxvk::mutex> lock(m_compressionMutex);
+      m_compressionStopped = true;
+      m_compressionCond.notify_one();
+    }
+
+    if (m_compressionThread.joinable())
+      m_compressionThread.join();
   }
 
   D3D9Memory D3D9MemoryAllocator::Alloc(uint32_t Size) {
@@ -33,10 +60,10 @@ namespace dxvk {
     }
 
     uint32_t chunkSize = std::max(D3D9ChunkSize, alignedSize);
-    m_allocatedMemory += chunkSize;
 
     D3D9MemoryChunk* chunk = new D3D9MemoryChunk(this, chunkSize);
     std::unique_ptr<D3D9MemoryChunk> uniqueChunk(chunk);
+    m_allocatedMemory += chunkSize;
     D3D9Memory memory = uniqueChunk->Alloc(alignedSize);
     m_usedMemory += memory.GetSize();
 
@@ -44,14 +71,29 @@ namespace dxvk {
     return memory;
   }
 
-  void D3D9MemoryAllocator::FreeChunk(D3D9MemoryChunk *Chunk) {
+  void D3D9MemoryAllocator::Free(D3D9MemoryChunk* Chunk, uint32_t Offset, uint32_t Size) {
     std::lock_guard<dxvk::mutex> lock(m_mutex);
 
-    m_allocatedMemory -= Chunk->Size();
+    // The compression worker frees memory concurrently with
+    // the application, so freeing the range, checking whether
+    // the chunk is empty and destroying it must happen under
+    // the same lock. Otherwise, two threads freeing the last
+    // two ranges of a chunk could both try to destroy it.
+    auto entry = std::find_if(m_chunks.begin(), m_chunks.end(), [&](auto& item) {
+      return item.get() == Chunk;
+    });
+
+    if (unlikely(entry == m_chunks.end())) {
+      Logger::err("D3D9MemoryAllocator: Freeing memory from destroyed chunk");
+      return;
+    }
+
+    Chunk->Free(Offset, Size);
 
-    m_chunks.erase(std::remove_if(m_chunks.begin(), m_chunks.end(), [&](auto& item) {
-        return item.get() == Chunk;
-    }), m_chunks.end());
+    if (Chunk->IsEmpty()) {
+      m_allocatedMemory -= Chunk->Size();
+      m_chunks.erase(entry);
+    }
   }
 
   void D3D9MemoryAllocator::NotifyMapped(uint32_t Size) {
@@ -66,6 +108,94 @@ namespace dxvk {
     m_usedMemory -= Size;
   }
 
+  void D3D9MemoryAllocator::NotifyDecompressed(uint32_t Size, uint32_t CompressedSize, uint64_t Time) {
+    m_uncompressedMemory -= Size;
+    m_compressedMemory -= CompressedSize;
+
+    if (Time) {
+      m_decompressCount += 1;
+      m_decompressTime += Time;
+    }
+  }
+
+  void D3D9MemoryAllocator::QueueCompression(const Rc<D3D9CompressionJob>& Job) {
+    std::lock_guard<dxvk::mutex> lock(m_compressionMutex);
+
+    if (unlikely(!m_compressionThread.joinable())) {
+      m_compressionThread = dxvk::thread([this] () { RunCompression(); });
+      m_compressionThread.set_priority(ThreadPriority::Lowest);
+    }
+
+    m_compressionQueue.push(Job);
+    m_compressionCond.notify_one();
+  }
+
+  D3D9MemoryCompressionStats D3D9MemoryAllocator::CompressionStats() {
+    D3D9MemoryCompressionStats stats;
+    stats.uncompressedSize = m_uncompressedMemory.load();
+    stats.compressedSize = m_compressedMemory.load();
+    stats.decompressCount = m_decompressCount.load();
+    stats.decompressTime = m_decompressTime.load();
+    return stats;
+  }
+
+  void D3D9MemoryAllocator::RunCompression() {
+    env::setThreadName("dxvk-d3d9-compress");
+
+    while (true) {
+      Rc<D3D9CompressionJob> job;
+
+      { std::unique_lock<dxvk::mutex> lock(m_compressionMutex);
+
+        m_compressionCond.wait(lock, [this] {
+          return m_compressionStopped || !m_compressionQueue.empty();
+        });
+
+        if (m_compressionStopped)
+          return;
+
+        job = std::move(m_compressionQueue.front());
+        m_compressionQueue.pop();
+      }
+
+      CompressJob(*job);
+    }
+  }
+
+  void D3D9MemoryAllocator::CompressJob(D3D9CompressionJob& Job) {
+    // The owning allocation waits for the job lock before it
+    // accesses or frees its memory, so the chunk stays valid.
+    std::lock_guard<dxvk::mutex> lock(Job.mutex);
+
+    if (Job.state != D3D9CompressionState::Pending)
+      return;
+
+    void* ptr = Job.chunk->Map(Job.offset, Job.size);
+
+    if (unlikely(ptr == nullptr)) {
+      Job.state = D3D9CompressionState::Incompressible;
+      return;
+    }
+
+    bool compressed = lz::compress(ptr, Job.size, Job.data);
+    Job.chunk->Unmap(ptr, Job.offset, Job.size);
+
+    if (!compressed) {
+      Job.data = std::vector<uint8_t>();
+      Job.state = D3D9CompressionState::Incompressible;
+      return;
+    }
+
+    Job.data.shrink_to_fit();
+    Job.state = D3D9CompressionState::Compressed;
+
+    m_uncompressedMemory += Job.size;
+    m_compressedMemory += Job.data.size();
+
+    Free(Job.chunk, Job.offset, Job.size);
+    Job.chunk = nullptr;
+  }
+
   uint32_t D3D9MemoryAllocator::MappedMemory() {
     return m_mappedMemory.load();
   }
@@ -80,7 +210,23 @@ namespace dxvk {
 
   D3D9MemoryChunk::D3D9MemoryChunk(D3D9MemoryAllocator* Allocator, uint32_t Size)
     : m_allocator(Allocator), m_size(Size), m_mappingGranularity(m_allocator->MemoryGranularity() * 16) {
+#ifdef _WIN32
     m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE | SEC_COMMIT, 0, Size, nullptr);
+#else
+    // Pad the file to the mapping granularity since we always map
+    // entire mapping ranges, and accessing pages past the end of
+    // the file would raise SIGBUS. The memfd is sparse regardless.
+    m_fd = memfd_create("d3d9_memory", MFD_CLOEXEC);
+
+    if (unlikely(m_fd < 0 || ftruncate(m_fd, align(Size, m_mappingGranularity)) != 0)) {
+      std::string error = std::strerror(errno);
+
+      if (m_fd >= 0)
+        close(m_fd);
+
+      throw DxvkError(str::format("Creating memfd for D3D9 memory chunk failed: ", error));
+    }
+#endif
     m_freeRanges.push_back({ 0, Size });
     m_mappingRanges.resize(((Size + m_mappingGranularity - 1) / m_mappingGranularity));
   }
@@ -88,74 +234,98 @@ namespace dxvk {
   D3D9MemoryChunk::~D3D9MemoryChunk() {
     std::lock_guard<dxvk::mutex> lock(m_mutex);
 
+#ifdef _WIN32
     CloseHandle(m_mapping);
+#else
+    if (m_fd >= 0)
+      close(m_fd);
+#endif
+  }
+
+  void* D3D9MemoryChunk::MapView(uint32_t Offset, uint32_t Size) {
+#ifdef _WIN32
+    void* ptr = MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, Offset, Size);
+    if (unlikely(ptr == nullptr)) {
+      DWORD error = GetLastError();
+      LPTSTR buffer = nullptr;
+      FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM, nullptr, error, MAKELANGID(LANG_NEUTRAL, SUBLANG_NEUTRAL), (LPTSTR)&buffer, 0, nullptr);
+      Logger::err(str::format("Mapping non-persisted file failed: ", error, ", Mapped memory: ", m_allocator->MappedMemory(), ", Msg: ", buffer));
+      if (buffer) {
+        LocalFree(buffer);
+      }
+    }
+    return ptr;
+#else
+    void* ptr = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, Offset);
+    if (unlikely(ptr == MAP_FAILED)) {
+      Logger::err(str::format("Mapping non-persisted memfd failed: ", std::strerror(errno), ", Mapped memory: ", m_allocator->MappedMemory()));
+      return nullptr;
+    }
+    return ptr;
+#endif
+  }
+
+  void D3D9MemoryChunk::UnmapView(void* Ptr, uint32_t Size) {
+#ifdef _WIN32
+    UnmapViewOfFile(Ptr);
+#else
+    munmap(Ptr, Size);
+#endif
   }
 
-  void* D3D9MemoryChunk::Map(D3D9Memory* memory) {
+  void* D3D9MemoryChunk::Map(uint32_t Offset, uint32_t Size) {
     std::lock_guard<dxvk::mutex> lock(m_mutex);
 
-    uint32_t alignedOffset = alignDown(memory->GetOffset(), m_mappingGranularity);
-    uint32_t alignmentDelta = memory->GetOffset() - alignedOffset;
-    uint32_t alignedSize = memory->GetSize() + alignmentDelta;
+    uint32_t alignedOffset = alignDown(Offset, m_mappingGranularity);
+    uint32_t alignmentDelta = Offset - alignedOffset;
+    uint32_t alignedSize = Size + alignmentDelta;
     if (alignedSize > m_mappingGranularity) {
       // The allocation crosses the boundary of the internal mapping page it's a part of
       // so we map it on it's own.
-      alignedOffset = alignDown(memory->GetOffset(), m_allocator->MemoryGranularity());
-      alignmentDelta = memory->GetOffset() - alignedOffset;
-      alignedSize = memory->GetSize() + alignmentDelta;
+      alignedOffset = alignDown(Offset, m_allocator->MemoryGranularity());
+      alignmentDelta = Offset - alignedOffset;
+      alignedSize = Size + alignmentDelta;
 
       m_allocator->NotifyMapped(alignedSize);
-      uint8_t* basePtr = static_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, alignedOffset, alignedSize));
-      if (unlikely(basePtr == nullptr)) {
-        DWORD error = GetLastError();
-        Logger::err(str::format("Mapping non-persisted file failed: ", error, ", Mapped memory: ", m_allocator->MappedMemory()));
+      uint8_t* basePtr = static_cast<uint8_t*>(MapView(alignedOffset, alignedSize));
+      if (unlikely(basePtr == nullptr))
         return nullptr;
-      }
       return basePtr + alignmentDelta;
     }
 
     // For small allocations we map the entire mapping page to minimize the overhead from having the align the offset to 65k bytes.
     // This should hopefully also reduce the amount of MapViewOfFile calls we do for tiny allocations.
-    auto& mappingRange = m_mappingRanges[memory->GetOffset() /  m_mappingGranularity];
+    auto& mappingRange = m_mappingRanges[Offset /  m_mappingGranularity];
     if (unlikely(mappingRange.refCount == 0)) {
       m_allocator->NotifyMapped(m_mappingGranularity);
-      mappingRange.ptr = static_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, alignedOffset, m_mappingGranularity));
-      if (unlikely(mappingRange.ptr == nullptr)) {
-        DWORD error = GetLastError();
-        LPTSTR buffer = nullptr;
-        FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM, nullptr, error, MAKELANGID(LANG_NEUTRAL, SUBLANG_NEUTRAL), (LPTSTR)&buffer, 0, nullptr);
-        Logger::err(str::format("Mapping non-persisted file failed: ", error, ", Mapped memory: ", m_allocator->MappedMemory(), ", Msg: ", buffer));
-        if (buffer) {
-          LocalFree(buffer);
-        }
-      }
+      mappingRange.ptr = MapView(alignedOffset, m_mappingGranularity);
     }
     mappingRange.refCount++;
     uint8_t* basePtr = static_cast<uint8_t*>(mappingRange.ptr);
     return basePtr + alignmentDelta;
   }
 
-  void D3D9MemoryChunk::Unmap(D3D9Memory* memory) {
+  void D3D9MemoryChunk::Unmap(void* Ptr, uint32_t Offset, uint32_t Size) {
     std::lock_guard<dxvk::mutex> lock(m_mutex);
 
-    uint32_t alignedOffset = alignDown(memory->GetOffset(), m_mappingGranularity);
-    uint32_t alignmentDelta = memory->GetOffset() - alignedOffset;
-    uint32_t alignedSize = memory->GetSize() + alignmentDelta;
+    uint32_t alignedOffset = alignDown(Offset, m_mappingGranularity);
+    uint32_t alignmentDelta = Offset - alignedOffset;
+    uint32_t alignedSize = Size + alignmentDelta;
     if (alignedSize > m_mappingGranularity) {
       // Single use mapping
-      alignedOffset = alignDown(memory->GetOffset(), m_allocator->MemoryGranularity());
-      alignmentDelta = memory->GetOffset() - alignedOffset;
-      alignedSize = memory->GetSize() + alignmentDelta;
+      alignedOffset = alignDown(Offset, m_allocator->MemoryGranularity());
+      alignmentDelta = Offset - alignedOffset;
+      alignedSize = Size + alignmentDelta;
 
-      uint8_t* basePtr = static_cast<uint8_t*>(memory->Ptr()) - alignmentDelta;
-      UnmapViewOfFile(basePtr);
+      uint8_t* basePtr = static_cast<uint8_t*>(Ptr) - alignmentDelta;
+      UnmapView(basePtr, alignedSize);
       m_allocator->NotifyUnmapped(alignedSize);
       return;
     }
-    auto& mappingRange = m_mappingRanges[memory->GetOffset() /  m_mappingGranularity];
+    auto& mappingRange = m_mappingRanges[Offset /  m_mappingGranularity];
     mappingRange.refCount--;
     if (unlikely(mappingRange.refCount == 0)) {
-      UnmapViewOfFile(mappingRange.ptr);
+      UnmapView(mappingRange.ptr, m_mappingGranularity);
       mappingRange.ptr = nullptr;
       m_allocator->NotifyUnmapped(m_mappingGranularity);
     }
@@ -187,11 +357,11 @@ namespace dxvk {
     return {};
   }
 
-  void D3D9MemoryChunk::Free(D3D9Memory *Memory) {
+  void D3D9MemoryChunk::Free(uint32_t Offset, uint32_t Size) {
     std::lock_guard<dxvk::mutex> lock(m_mutex);
 
-    uint32_t offset = Memory->GetOffset();
-    uint32_t size = Memory->GetSize();
+    uint32_t offset = Offset;
+    uint32_t size = Size;
 
     auto curr = m_freeRanges.begin();
 
@@ -210,7 +380,7 @@ namespace dxvk {
     }
 
     m_freeRanges.push_back({ offset, size });
-    m_allocator->NotifyFreed(Memory->GetSize());
+    m_allocator->NotifyFreed(Size);
   }
 
   bool D3D9MemoryChunk::IsEmpty() {
@@ -224,10 +394,6 @@ namespace dxvk {
     return m_allocator;
   }
 
-  HANDLE D3D9MemoryChunk::FileHandle() const {
-    return m_mapping;
-  }
-
 
   D3D9Memory::D3D9Memory(D3D9MemoryChunk* Chunk, size_t Offset, size_t Size)
     : m_chunk(Chunk), m_offset(Offset), m_size(Size) {}
@@ -236,7 +402,8 @@ namespace dxvk {
     : m_chunk(std::exchange(other.m_chunk, nullptr)),
       m_ptr(std::exchange(other.m_ptr, nullptr)),
       m_offset(std::exchange(other.m_offset, 0)),
-      m_size(std::exchange(other.m_size, 0)) {}
+      m_size(std::exchange(other.m_size, 0)),
+      m_compression(std::move(other.m_compression)) {}
 
   D3D9Memory::~D3D9Memory() {
     this->Free();
@@ -249,6 +416,7 @@ namespace dxvk {
     m_ptr = std::exchange(other.m_ptr, nullptr);
     m_offset = std::exchange(other.m_offset, 0);
     m_size = std::exchange(other.m_size, 0);
+    m_compression = std::move(other.m_compression);
     return *this;
   }
 
@@ -259,11 +427,16 @@ namespace dxvk {
     if (m_ptr != nullptr)
       Unmap();
 
-    m_chunk->Free(this);
-    if (m_chunk->IsEmpty()) {
-      D3D9MemoryAllocator* allocator = m_chunk->Allocator();
-      allocator->FreeChunk(m_chunk);
+    if (unlikely(m_compression != nullptr && !CancelCompression())) {
+      // The chunk range was already freed by the compression worker
+      m_compression->allocator->NotifyDecompressed(m_size, m_compression->data.size(), 0);
+
+      m_compression = nullptr;
+      m_chunk = nullptr;
+      return;
     }
+
+    m_chunk->Allocator()->Free(m_chunk, m_offset, m_size);
     m_chunk = nullptr;
   }
 
@@ -274,17 +447,70 @@ namespace dxvk {
     if (unlikely(m_chunk == nullptr))
       return;
 
-    m_ptr = m_chunk->Map(this);
+    if (unlikely(m_compression != nullptr && !CancelCompression())) {
+      // Move the data back into a regular chunk range. The
+      // old chunk may have been destroyed at this point.
+      auto t0 = dxvk::high_resolution_clock::now();
+
+      D3D9MemoryAllocator* allocator = m_compression->allocator;
+      D3D9Memory memory = allocator->Alloc(m_size);
+
+      m_chunk = std::exchange(memory.m_chunk, nullptr);
+      m_offset = memory.m_offset;
+      m_ptr = m_chunk->Map(m_offset, m_size);
+
+      if (likely(m_ptr != nullptr)) {
+        if (unlikely(!lz::decompress(m_compression->data.data(), m_compression->data.size(), m_ptr, m_size)))
+          Logger::err("D3D9Memory: Failed to decompress data");
+      }
+
+      auto t1 = dxvk::high_resolution_clock::now();
+      auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+
+      allocator->NotifyDecompressed(m_size, m_compression->data.size(), std::max<uint64_t>(us.count(), 1));
+      m_compression = nullptr;
+      return;
+    }
+
+    m_ptr = m_chunk->Map(m_offset, m_size);
   }
 
   void D3D9Memory::Unmap() {
     if (unlikely(m_ptr == nullptr))
       return;
 
-    m_chunk->Unmap(this);
+    m_chunk->Unmap(m_ptr, m_offset, m_size);
     m_ptr = nullptr;
   }
 
+  void D3D9Memory::Compress() {
+    if (unlikely(m_chunk == nullptr || m_ptr != nullptr || m_compression != nullptr))
+      return;
+
+    m_compression = new D3D9CompressionJob();
+    m_compression->allocator = m_chunk->Allocator();
+    m_compression->chunk = m_chunk;
+    m_compression->offset = m_offset;
+    m_compression->size = m_size;
+
+    m_chunk->Allocator()->QueueCompression(m_compression);
+  }
+
+  bool D3D9Memory::CancelCompression() {
+    // Waits for the worker if it is currently processing the job.
+    // Returns false if the data has been compressed, in which case
+    // the original chunk range no longer belongs to this object.
+    Rc<D3D9CompressionJob> job = m_compression;
+    std::lock_guard<dxvk::mutex> lock(job->mutex);
+
+    if (job->state == D3D9CompressionState::Compressed)
+      return false;
+
+    job->state = D3D9CompressionState::Cancelled;
+    m_compression = nullptr;
+    return true;
+  }
+
   void* D3D9Memory::Ptr() {
     return m_ptr;
   }
@@ -2,16 +2,21 @@
 #pragma once
 
 #include "../util/thread.h"
+#include "../util/rc/util_rc.h"
+#include "../util/rc/util_rc_ptr.h"
 
 #if defined(_WIN32) && !defined(_WIN64)
   #define D3D9_ALLOW_UNMAPPING
+#elif defined(__linux__) && !defined(__LP64__)
+  #define D3D9_ALLOW_UNMAPPING
 #endif
 
-#ifdef D3D9_ALLOW_UNMAPPING
+#if defined(D3D9_ALLOW_UNMAPPING) && defined(_WIN32)
   #define WIN32_LEAN_AND_MEAN
   #include <winbase.h>
 #endif
 
+#include <queue>
 #include <vector>
 
 namespace dxvk {
@@ -19,6 +24,16 @@ namespace dxvk {
   class D3D9MemoryAllocator;
   class D3D9Memory;
 
+  /**
+   * \brief Compression statistics
+   */
+  struct D3D9MemoryCompressionStats {
+    uint64_t uncompressedSize = 0;
+    uint64_t compressedSize = 0;
+    uint64_t decompressCount = 0;
+    uint64_t decompressTime = 0;
+  };
+
 #ifdef D3D9_ALLOW_UNMAPPING
 
   class D3D9MemoryChunk;
@@ -35,6 +50,31 @@ namespace dxvk {
     void* ptr = nullptr;
   };
 
+  enum class D3D9CompressionState : uint32_t {
+    Pending,
+    Compressed,
+    Incompressible,
+    Cancelled,
+  };
+
+  /**
+   * \brief Compression job
+   *
+   * Shared between a memory allocation and the compression
+   * worker. Once the data is compressed, the worker frees
+   * the original chunk range, and the allocation needs to
+   * be decompressed into a new range before it can be mapped.
+   */
+  struct D3D9CompressionJob : public RcObject {
+    dxvk::mutex           mutex;
+    D3D9CompressionState  state = D3D9CompressionState::Pending;
+    D3D9MemoryAllocator*  allocator = nullptr;
+    D3D9MemoryChunk*      chunk = nullptr;
+    uint32_t              offset = 0;
+    uint32_t              size = 0;
+    std::vector<uint8_t>  data;
+  };
+
   class D3D9MemoryChunk {
     friend D3D9MemoryAllocator;
 
@@ -48,20 +88,26 @@ namespace dxvk {
       D3D9MemoryChunk& operator = (D3D9MemoryChunk&& other) = delete;
 
       D3D9Memory Alloc(uint32_t Size);
-      void Free(D3D9Memory* Memory);
+      void Free(uint32_t Offset, uint32_t Size);
       bool IsEmpty();
       uint32_t Size() const { return m_size; }
       D3D9MemoryAllocator* Allocator() const;
-      HANDLE FileHandle() const;
-      void* Map(D3D9Memory* memory);
-      void Unmap(D3D9Memory* memory);
+      void* Map(uint32_t Offset, uint32_t Size);
+      void Unmap(void* Ptr, uint32_t Offset, uint32_t Size);
 
     private:
       D3D9MemoryChunk(D3D9MemoryAllocator* Allocator, uint32_t Size);
 
+      void* MapView(uint32_t Offset, uint32_t Size);
+      void UnmapView(void* Ptr, uint32_t Size);
+
       dxvk::mutex m_mutex;
       D3D9MemoryAllocator* m_allocator;
+#ifdef _WIN32
       HANDLE m_mapping;
+#else
+      int m_fd;
+#endif
       uint32_t m_size;
       uint32_t m_mappingGranularity;
       std::vector<D3D9MemoryRange> m_freeRanges;
@@ -85,6 +131,7 @@ namespace dxvk {
 
       void Map();
       void Unmap();
+      void Compress();
       void* Ptr();
       D3D9MemoryChunk* GetChunk() const { return m_chunk; }
       size_t GetOffset() const { return m_offset; }
@@ -93,11 +140,14 @@ namespace dxvk {
     private:
       D3D9Memory(D3D9MemoryChunk* Chunk, size_t Offset, size_t Size);
       void Free();
+      bool CancelCompression();
 
       D3D9MemoryChunk* m_chunk = nullptr;
       void* m_ptr              = nullptr;
       size_t m_offset          = 0;
       size_t m_size            = 0;
+
+      Rc<D3D9CompressionJob> m_compression;
   };
 
   class D3D9MemoryAllocator {
@@ -105,24 +155,41 @@ namespace dxvk {
 
     public:
       D3D9MemoryAllocator();
-      ~D3D9MemoryAllocator() = default;
+      ~D3D9MemoryAllocator();
       D3D9Memory Alloc(uint32_t Size);
-      void FreeChunk(D3D9MemoryChunk* Chunk);
+      void Free(D3D9MemoryChunk* Chunk, uint32_t Offset, uint32_t Size);
       void NotifyMapped(uint32_t Size);
       void NotifyUnmapped(uint32_t Size);
       void NotifyFreed(uint32_t Size);
+      void NotifyDecompressed(uint32_t Size, uint32_t CompressedSize, uint64_t Time);
+      void QueueCompression(const Rc<D3D9CompressionJob>& Job);
       uint32_t MappedMemory();
       uint32_t UsedMemory();
       uint32_t AllocatedMemory();
       uint32_t MemoryGranularity() { return m_allocationGranularity; }
+      D3D9MemoryCompressionStats CompressionStats();
 
     private:
+      void RunCompression();
+      void CompressJob(D3D9CompressionJob& Job);
+
       dxvk::mutex m_mutex;
       std::vector<std::unique_ptr<D3D9MemoryChunk>> m_chunks;
       std::atomic<size_t> m_mappedMemory = 0;
       std::atomic<size_t> m_allocatedMemory = 0;
       std::atomic<size_t> m_usedMemory = 0;
       uint32_t m_allocationGranularity;
+
+      std::atomic<uint64_t> m_uncompressedMemory = 0;
+      std::atomic<uint64_t> m_compressedMemory = 0;
+      std::atomic<uint64_t> m_decompressCount = 0;
+      std::atomic<uint64_t> m_decompressTime = 0;
+
+      dxvk::mutex m_compressionMutex;
+      dxvk::condition_variable m_compressionCond;
+      std::queue<Rc<D3D9CompressionJob>> m_compressionQueue;
+      dxvk::thread m_compressionThread;
+      bool m_compressionStopped = false;
   };
 
 #else
@@ -143,6 +210,7 @@ namespace dxvk {
 
       void Map() {}
       void Unmap() {}
+      void Compress() {}
       void* Ptr() { return m_ptr; }
       size_t GetSize() const { return m_size; }
 
@@ -162,6 +230,7 @@ namespace dxvk {
       uint32_t MappedMemory();
       uint32_t UsedMemory();
       uint32_t AllocatedMemory();
+      D3D9MemoryCompressionStats CompressionStats() { return { }; }
       void NotifyFreed(uint32_t Size) {
         m_allocatedMemory -= Size;
       }
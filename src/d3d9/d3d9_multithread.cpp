@@ -3,7 +3,9 @@
 namespace dxvk {
 
   D3D9Multithread::D3D9Multithread(
-          BOOL                  Protected)
-    : m_protected( Protected ) { }
+          BOOL                  Protected,
+          bool                  AllowLockElision)
+    : m_protected( Protected )
+    , m_mutex    ( AllowLockElision ) { }
 
 }
\ No newline at end of file
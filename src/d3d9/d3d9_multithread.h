@@ -17,48 +17,55 @@ namespace dxvk {
   public:
 
     D3D9DeviceLock()
-      : m_mutex(nullptr) { }
+      : m_mutex(nullptr), m_biased(false) { }
 
-    D3D9DeviceLock(sync::RecursiveSpinlock& mutex)
-      : m_mutex(&mutex) {
-      mutex.lock();
-    }
+    D3D9DeviceLock(sync::BiasedRecursiveSpinlock& mutex)
+      : m_mutex(&mutex), m_biased(mutex.lock()) { }
 
     D3D9DeviceLock(D3D9DeviceLock&& other)
-      : m_mutex(other.m_mutex) {
+      : m_mutex(other.m_mutex), m_biased(other.m_biased) {
       other.m_mutex = nullptr;
     }
 
     D3D9DeviceLock& operator = (D3D9DeviceLock&& other) {
       if (m_mutex)
-        m_mutex->unlock();
+        m_mutex->unlock(m_biased);
 
       m_mutex = other.m_mutex;
+      m_biased = other.m_biased;
       other.m_mutex = nullptr;
       return *this;
     }
 
     ~D3D9DeviceLock() {
       if (m_mutex != nullptr)
-        m_mutex->unlock();
+        m_mutex->unlock(m_biased);
     }
 
   private:
 
-    sync::RecursiveSpinlock* m_mutex;
+    sync::BiasedRecursiveSpinlock* m_mutex;
+    bool                           m_biased;
 
   };
 
 
   /**
    * \brief D3D9 context lock
+   *
+   * Many applications create their device with
+   * \c D3DCREATE_MULTITHREADED while only ever using it
+   * from one thread, so the lock is biased towards the
+   * first thread using it unless \c AllowLockElision
+   * is \c false.
    */
   class D3D9Multithread {
 
   public:
 
     D3D9Multithread(
-      BOOL                  Protected);
+      BOOL                  Protected,
+      bool                  AllowLockElision);
 
     D3D9DeviceLock AcquireLock() {
       return m_protected
@@ -70,7 +77,7 @@ namespace dxvk {
 
     BOOL            m_protected;
 
-    sync::RecursiveSpinlock m_mutex;
+    sync::BiasedRecursiveSpinlock m_mutex;
 
   };
 
@@ -149,6 +149,14 @@ namespace dxvk {
 
     /// How much virtual memory will be used for textures (in MB).
     int32_t textureMemory;
+
+    /// Compress texture data that gets unmapped due to the
+    /// texture memory limit in order to reduce memory usage.
+    bool compressTextureMemory;
+
+    /// Skip atomic operations on the device lock while
+    /// only one thread uses a multithreaded device.
+    bool lockElision;
   };
 
 }
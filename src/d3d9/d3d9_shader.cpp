@@ -69,6 +69,7 @@ namespace dxvk {
     m_info      = pModule->info();
     m_meta      = pModule->meta();
     m_constants = pModule->constants();
+    m_constantRanges = pModule->constantRanges();
     m_maxDefinedConst = pModule->maxDefinedConstant();
 
     m_shader->setShaderKey(Key);
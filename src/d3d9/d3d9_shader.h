@@ -47,6 +47,7 @@ namespace dxvk {
 
     const DxsoShaderMetaInfo& GetMeta() const { return m_meta; }
     const DxsoDefinedConstants& GetConstants() const { return m_constants; }
+    const DxsoConstantRanges& GetConstantRanges() const { return m_constantRanges; }
 
     D3D9ShaderMasks GetShaderMask() const { return D3D9ShaderMasks{ m_usedSamplers, m_usedRTs }; }
 
@@ -63,6 +64,7 @@ namespace dxvk {
     DxsoProgramInfo       m_info;
     DxsoShaderMetaInfo    m_meta;
     DxsoDefinedConstants  m_constants;
+    DxsoConstantRanges    m_constantRanges;
     uint32_t              m_maxDefinedConst;
 
     Rc<DxvkShader>        m_shader;
@@ -3,6 +3,7 @@
 #include "d3d9_caps.h"
 #include "d3d9_constant_set.h"
 #include "../dxso/dxso_common.h"
+#include "../util/util_flags.h"
 #include "../util/util_matrix.h"
 
 #include "d3d9_surface.h"
@@ -26,6 +27,30 @@ namespace dxvk {
     static constexpr DWORD AlphaToCoverageEnabled  = MAKEFOURCC('A', '2', 'M', '1');
   }
   
+  enum class D3D9CapturedStateFlag : uint32_t {
+    VertexDecl,
+    Indices,
+    RenderStates,
+    SamplerStates,
+    VertexBuffers,
+    Textures,
+    VertexShader,
+    PixelShader,
+    Viewport,
+    ScissorRect,
+    ClipPlanes,
+    VsConstants,
+    PsConstants,
+    StreamFreq,
+    Transforms,
+    TextureStages,
+    Material
+  };
+
+  static constexpr uint32_t D3D9CapturedStateFlagCount = uint32_t(D3D9CapturedStateFlag::Material) + 1;
+
+  using D3D9CapturedStateFlags = Flags<D3D9CapturedStateFlag>;
+
   struct D3D9ClipPlane {
     float coeff[4] = {};
   };
@@ -283,6 +308,29 @@ namespace dxvk {
       : UpdateHelper(pState->psConsts);
   }
 
+  template <
+    DxsoProgramType  ProgramType,
+    D3D9ConstantType ConstantType,
+    typename         T>
+  bool CompareStateConstants(
+    const D3D9CapturableState* pState,
+          UINT                 StartRegister,
+    const T*                   pConstantData,
+          UINT                 Count) {
+    auto CompareHelper = [&] (const auto& set) {
+      if constexpr (ConstantType == D3D9ConstantType::Float)
+        return !std::memcmp(set.fConsts[StartRegister].data, pConstantData, Count * sizeof(Vector4));
+      else if constexpr (ConstantType == D3D9ConstantType::Int)
+        return !std::memcmp(set.iConsts[StartRegister].data, pConstantData, Count * sizeof(Vector4i));
+      else
+        return false;
+    };
+
+    return ProgramType == DxsoProgramTypes::VertexShader
+      ? CompareHelper(pState->vsConsts)
+      : CompareHelper(pState->psConsts);
+  }
+
   struct Direct3DState9 : public D3D9CapturableState {
 
     std::array<Com<D3D9Surface, false>, caps::MaxSimultaneousRenderTargets> renderTargets;
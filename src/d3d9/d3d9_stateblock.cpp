@@ -14,6 +14,8 @@ namespace dxvk {
   D3D9StateBlock::D3D9StateBlock(D3D9DeviceEx* pDevice, D3D9StateBlockType Type)
     : D3D9StateBlockBase(pDevice)
     , m_deviceState     (pDevice->GetRawState()) {
+    m_syncGenerations.fill(InvalidGeneration);
+
     CaptureType(Type);
   }
 
@@ -39,11 +41,17 @@ namespace dxvk {
 
 
   HRESULT STDMETHODCALLTYPE D3D9StateBlock::Capture() {
-    if (m_captures.flags.test(D3D9CapturedStateFlag::VertexDecl))
+    m_groupsCopied  = 0;
+    m_groupsSkipped = 0;
+
+    if (ShouldCopyGroup(D3D9CapturedStateFlag::VertexDecl))
       SetVertexDeclaration(m_deviceState->vertexDecl.ptr());
 
     ApplyOrCapture<D3D9StateFunction::Capture>();
 
+    SyncGenerations();
+
+    m_parent->AddStateBlockStats(m_groupsCopied, m_groupsSkipped);
     return D3D_OK;
   }
 
@@ -51,12 +59,27 @@ namespace dxvk {
   HRESULT STDMETHODCALLTYPE D3D9StateBlock::Apply() {
     m_applying = true;
 
-    if (m_captures.flags.test(D3D9CapturedStateFlag::VertexDecl) && m_state.vertexDecl != nullptr)
+    m_groupsCopied  = 0;
+    m_groupsSkipped = 0;
+
+    if (ShouldCopyGroup(D3D9CapturedStateFlag::VertexDecl) && m_state.vertexDecl != nullptr)
       m_parent->SetVertexDeclaration(m_state.vertexDecl.ptr());
 
     ApplyOrCapture<D3D9StateFunction::Apply>();
     m_applying = false;
 
+    // If we are being recorded into another state block,
+    // the device state itself did not actually change.
+    if (!m_parent->IsRecording()) {
+      SyncGenerations();
+
+      // A null declaration is never applied, so the
+      // device may still use a different one
+      if (m_state.vertexDecl == nullptr)
+        m_syncGenerations[uint32_t(D3D9CapturedStateFlag::VertexDecl)] = InvalidGeneration;
+    }
+
+    m_parent->AddStateBlockStats(m_groupsCopied, m_groupsSkipped);
     return D3D_OK;
   }
 
@@ -64,7 +87,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::SetVertexDeclaration(D3D9VertexDecl* pDecl) {
     m_state.vertexDecl = pDecl;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::VertexDecl);
+    MarkModified(D3D9CapturedStateFlag::VertexDecl);
     return D3D_OK;
   }
 
@@ -72,7 +95,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::SetIndices(D3D9IndexBuffer* pIndexData) {
     m_state.indices = pIndexData;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::Indices);
+    MarkModified(D3D9CapturedStateFlag::Indices);
     return D3D_OK;
   }
 
@@ -80,7 +103,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::SetRenderState(D3DRENDERSTATETYPE State, DWORD Value) {
     m_state.renderStates[State] = Value;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::RenderStates);
+    MarkModified(D3D9CapturedStateFlag::RenderStates);
     m_captures.renderStates.set(State, true);
     return D3D_OK;
   }
@@ -92,7 +115,7 @@ namespace dxvk {
           DWORD               Value) {
     m_state.samplerStates[StateSampler][Type] = Value;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::SamplerStates);
+    MarkModified(D3D9CapturedStateFlag::SamplerStates);
     m_captures.samplers.set(StateSampler, true);
     m_captures.samplerStates[StateSampler].set(Type, true);
     return D3D_OK;
@@ -109,7 +132,7 @@ namespace dxvk {
     m_state.vertexBuffers[StreamNumber].offset = OffsetInBytes;
     m_state.vertexBuffers[StreamNumber].stride = Stride;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::VertexBuffers);
+    MarkModified(D3D9CapturedStateFlag::VertexBuffers);
     m_captures.vertexBuffers.set(StreamNumber, true);
     return D3D_OK;
   }
@@ -118,7 +141,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::SetStreamSourceFreq(UINT StreamNumber, UINT Setting) {
     m_state.streamFreq[StreamNumber] = Setting;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::StreamFreq);
+    MarkModified(D3D9CapturedStateFlag::StreamFreq);
     m_captures.streamFreq.set(StreamNumber, true);
     return D3D_OK;
   }
@@ -127,7 +150,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::SetStateTexture(DWORD StateSampler, IDirect3DBaseTexture9* pTexture) {
     TextureChangePrivate(m_state.textures[StateSampler], pTexture);
 
-    m_captures.flags.set(D3D9CapturedStateFlag::Textures);
+    MarkModified(D3D9CapturedStateFlag::Textures);
     m_captures.textures.set(StateSampler, true);
     return D3D_OK;
   }
@@ -136,7 +159,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::SetVertexShader(D3D9VertexShader* pShader) {
     m_state.vertexShader = pShader;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::VertexShader);
+    MarkModified(D3D9CapturedStateFlag::VertexShader);
     return D3D_OK;
   }
 
@@ -144,7 +167,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::SetPixelShader(D3D9PixelShader* pShader) {
     m_state.pixelShader = pShader;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::PixelShader);
+    MarkModified(D3D9CapturedStateFlag::PixelShader);
     return D3D_OK;
   }
 
@@ -152,7 +175,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::SetMaterial(const D3DMATERIAL9* pMaterial) {
     m_state.material = *pMaterial;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::Material);
+    MarkModified(D3D9CapturedStateFlag::Material);
     return D3D_OK;
   }
 
@@ -160,7 +183,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::SetStateTransform(uint32_t idx, const D3DMATRIX* pMatrix) {
     m_state.transforms[idx] = ConvertMatrix(pMatrix);
 
-    m_captures.flags.set(D3D9CapturedStateFlag::Transforms);
+    MarkModified(D3D9CapturedStateFlag::Transforms);
     m_captures.transforms.set(idx, true);
     return D3D_OK;
   }
@@ -172,7 +195,7 @@ namespace dxvk {
           DWORD                      Value) {
     m_state.textureStages[Stage][Type] = Value;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::TextureStages);
+    MarkModified(D3D9CapturedStateFlag::TextureStages);
     m_captures.textureStages.set(Stage, true);
     m_captures.textureStageStates[Stage].set(Type, true);
     return D3D_OK;
@@ -182,7 +205,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::MultiplyStateTransform(uint32_t idx, const D3DMATRIX* pMatrix) {
     m_state.transforms[idx] = m_state.transforms[idx] * ConvertMatrix(pMatrix);
 
-    m_captures.flags.set(D3D9CapturedStateFlag::Transforms);
+    MarkModified(D3D9CapturedStateFlag::Transforms);
     m_captures.transforms.set(idx, true);
     return D3D_OK;
   }
@@ -191,7 +214,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::SetViewport(const D3DVIEWPORT9* pViewport) {
     m_state.viewport = *pViewport;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::Viewport);
+    MarkModified(D3D9CapturedStateFlag::Viewport);
     return D3D_OK;
   }
 
@@ -199,7 +222,7 @@ namespace dxvk {
   HRESULT D3D9StateBlock::SetScissorRect(const RECT* pRect) {
     m_state.scissorRect = *pRect;
 
-    m_captures.flags.set(D3D9CapturedStateFlag::ScissorRect);
+    MarkModified(D3D9CapturedStateFlag::ScissorRect);
     return D3D_OK;
   }
 
@@ -208,7 +231,7 @@ namespace dxvk {
     for (uint32_t i = 0; i < 4; i++)
       m_state.clipPlanes[Index].coeff[i] = pPlane[i];
 
-    m_captures.flags.set(D3D9CapturedStateFlag::ClipPlanes);
+    MarkModified(D3D9CapturedStateFlag::ClipPlanes);
     m_captures.clipPlanes.set(Index, true);
     return D3D_OK;
   }
@@ -292,6 +315,12 @@ namespace dxvk {
   }
 
 
+  void D3D9StateBlock::MarkModified(D3D9CapturedStateFlag Group) {
+    m_captures.flags.set(Group);
+    m_syncGenerations[uint32_t(Group)] = InvalidGeneration;
+  }
+
+
   HRESULT D3D9StateBlock::SetVertexBoolBitfield(uint32_t idx, uint32_t mask, uint32_t bits) {
     m_state.vsConsts.bConsts[idx] &= ~mask;
     m_state.vsConsts.bConsts[idx] |= bits & mask;
@@ -306,6 +335,34 @@ namespace dxvk {
   }
 
 
+  bool D3D9StateBlock::ShouldCopyGroup(D3D9CapturedStateFlag Group) {
+    if (!m_captures.flags.test(Group))
+      return false;
+
+    // Skip the group if neither the device state nor our
+    // own state changed since we last captured or applied it
+    bool inSync = !m_parent->IsRecording()
+      && m_syncGenerations[uint32_t(Group)] == m_parent->GetStateGeneration(Group);
+
+    if (inSync)
+      m_groupsSkipped += 1;
+    else
+      m_groupsCopied += 1;
+
+    return !inSync;
+  }
+
+
+  void D3D9StateBlock::SyncGenerations() {
+    for (uint32_t i = 0; i < D3D9CapturedStateFlagCount; i++) {
+      auto group = D3D9CapturedStateFlag(i);
+
+      if (m_captures.flags.test(group))
+        m_syncGenerations[i] = m_parent->GetStateGeneration(group);
+    }
+  }
+
+
   void D3D9StateBlock::CapturePixelRenderStates() {
     m_captures.flags.set(D3D9CapturedStateFlag::RenderStates);
 
@@ -8,28 +8,6 @@
 
 namespace dxvk {
 
-  enum class D3D9CapturedStateFlag : uint32_t {
-    VertexDecl,
-    Indices,
-    RenderStates,
-    SamplerStates,
-    VertexBuffers,
-    Textures,
-    VertexShader,
-    PixelShader,
-    Viewport,
-    ScissorRect,
-    ClipPlanes,
-    VsConstants,
-    PsConstants,
-    StreamFreq,
-    Transforms,
-    TextureStages,
-    Material
-  };
-
-  using D3D9CapturedStateFlags = Flags<D3D9CapturedStateFlag>;
-
   struct D3D9StateCaptures {
     D3D9CapturedStateFlags flags;
 
@@ -174,15 +152,15 @@ namespace dxvk {
 
     template <typename Dst, typename Src>
     void ApplyOrCapture(Dst* dst, const Src* src) {
-      if (m_captures.flags.test(D3D9CapturedStateFlag::StreamFreq)) {
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::StreamFreq)) {
         for (uint32_t idx : bit::BitMask(m_captures.streamFreq.dword(0)))
           dst->SetStreamSourceFreq(idx, src->streamFreq[idx]);
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::Indices))
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::Indices))
         dst->SetIndices(src->indices.ptr());
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::RenderStates)) {
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::RenderStates)) {
         for (uint32_t i = 0; i < m_captures.renderStates.dwordCount(); i++) {
           for (uint32_t rs : bit::BitMask(m_captures.renderStates.dword(i))) {
             uint32_t idx = i * 32 + rs;
@@ -192,14 +170,14 @@ namespace dxvk {
         }
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::SamplerStates)) {
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::SamplerStates)) {
         for (uint32_t samplerIdx : bit::BitMask(m_captures.samplers.dword(0))) {
           for (uint32_t stateIdx : bit::BitMask(m_captures.samplerStates[samplerIdx].dword(0)))
             dst->SetStateSamplerState(samplerIdx, D3DSAMPLERSTATETYPE(stateIdx), src->samplerStates[samplerIdx][stateIdx]);
         }
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::VertexBuffers)) {
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::VertexBuffers)) {
         for (uint32_t idx : bit::BitMask(m_captures.vertexBuffers.dword(0))) {
           const auto& vbo = src->vertexBuffers[idx];
           dst->SetStreamSource(
@@ -210,21 +188,21 @@ namespace dxvk {
         }
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::Material))
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::Material))
         dst->SetMaterial(&src->material);
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::Textures)) {
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::Textures)) {
         for (uint32_t idx : bit::BitMask(m_captures.textures.dword(0)))
           dst->SetStateTexture(idx, src->textures[idx]);
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::VertexShader))
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::VertexShader))
         dst->SetVertexShader(src->vertexShader.ptr());
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::PixelShader))
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::PixelShader))
         dst->SetPixelShader(src->pixelShader.ptr());
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::Transforms)) {
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::Transforms)) {
         for (uint32_t i = 0; i < m_captures.transforms.dwordCount(); i++) {
           for (uint32_t trans : bit::BitMask(m_captures.transforms.dword(i))) {
             uint32_t idx = i * 32 + trans;
@@ -234,40 +212,32 @@ namespace dxvk {
         }
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::TextureStages)) {
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::TextureStages)) {
         for (uint32_t stageIdx : bit::BitMask(m_captures.textureStages.dword(0))) {
           for (uint32_t stateIdx : bit::BitMask(m_captures.textureStageStates[stageIdx].dword(0)))
             dst->SetStateTextureStageState(stageIdx, D3D9TextureStageStateTypes(stateIdx), src->textureStages[stageIdx][stateIdx]);
         }
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::Viewport))
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::Viewport))
         dst->SetViewport(&src->viewport);
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::ScissorRect))
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::ScissorRect))
         dst->SetScissorRect(&src->scissorRect);
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::ClipPlanes)) {
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::ClipPlanes)) {
         for (uint32_t idx : bit::BitMask(m_captures.clipPlanes.dword(0)))
           dst->SetClipPlane(idx, src->clipPlanes[idx].coeff);
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::VsConstants)) {
-        for (uint32_t i = 0; i < m_captures.vsConsts.fConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.vsConsts.fConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
-
-            dst->SetVertexShaderConstantF(idx, (float*)&src->vsConsts.fConsts[idx], 1);
-          }
-        }
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::VsConstants)) {
+        ForEachRange(m_captures.vsConsts.fConsts, [&] (uint32_t idx, uint32_t count) {
+          dst->SetVertexShaderConstantF(idx, (float*)&src->vsConsts.fConsts[idx], count);
+        });
 
-        for (uint32_t i = 0; i < m_captures.vsConsts.iConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.vsConsts.iConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
-
-            dst->SetVertexShaderConstantI(idx, (int*)&src->vsConsts.iConsts[idx], 1);
-          }
-        }
+        ForEachRange(m_captures.vsConsts.iConsts, [&] (uint32_t idx, uint32_t count) {
+          dst->SetVertexShaderConstantI(idx, (int*)&src->vsConsts.iConsts[idx], count);
+        });
 
         if (m_captures.vsConsts.bConsts.any()) {
           for (uint32_t i = 0; i < m_captures.vsConsts.bConsts.dwordCount(); i++)
@@ -275,22 +245,14 @@ namespace dxvk {
         }
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::PsConstants)) {
-        for (uint32_t i = 0; i < m_captures.psConsts.fConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.psConsts.fConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
-
-            dst->SetPixelShaderConstantF(idx, (float*)&src->psConsts.fConsts[idx], 1);
-          }
-        }
+      if (ShouldCopyGroup(D3D9CapturedStateFlag::PsConstants)) {
+        ForEachRange(m_captures.psConsts.fConsts, [&] (uint32_t idx, uint32_t count) {
+          dst->SetPixelShaderConstantF(idx, (float*)&src->psConsts.fConsts[idx], count);
+        });
 
-        for (uint32_t i = 0; i < m_captures.psConsts.iConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.psConsts.iConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
-
-            dst->SetPixelShaderConstantI(idx, (int*)&src->psConsts.iConsts[idx], 1);
-          }
-        }
+        ForEachRange(m_captures.psConsts.iConsts, [&] (uint32_t idx, uint32_t count) {
+          dst->SetPixelShaderConstantI(idx, (int*)&src->psConsts.iConsts[idx], count);
+        });
 
         if (m_captures.psConsts.bConsts.any()) {
           for (uint32_t i = 0; i < m_captures.psConsts.bConsts.dwordCount(); i++)
@@ -317,9 +279,9 @@ namespace dxvk {
             UINT  Count) {
       auto SetHelper = [&](auto& setCaptures) {
         if constexpr (ProgramType == DxsoProgramTypes::VertexShader)
-          m_captures.flags.set(D3D9CapturedStateFlag::VsConstants);
+          MarkModified(D3D9CapturedStateFlag::VsConstants);
         else
-          m_captures.flags.set(D3D9CapturedStateFlag::PsConstants);
+          MarkModified(D3D9CapturedStateFlag::PsConstants);
 
         for (uint32_t i = 0; i < Count; i++) {
           uint32_t reg = StartRegister + i;
@@ -358,6 +320,41 @@ namespace dxvk {
 
   private:
 
+    constexpr static uint64_t InvalidGeneration = ~0ull;
+
+    template <typename Bitset, typename Fn>
+    static void ForEachRange(const Bitset& Set, Fn&& Func) {
+      // Merge adjacent registers so that constants
+      // can be copied with as few calls as possible
+      uint32_t start = 0;
+      uint32_t count = 0;
+
+      for (uint32_t i = 0; i < Set.dwordCount(); i++) {
+        for (uint32_t bit : bit::BitMask(Set.dword(i))) {
+          uint32_t idx = i * 32 + bit;
+
+          if (count && start + count == idx) {
+            count += 1;
+          } else {
+            if (count)
+              Func(start, count);
+
+            start = idx;
+            count = 1;
+          }
+        }
+      }
+
+      if (count)
+        Func(start, count);
+    }
+
+    bool ShouldCopyGroup(D3D9CapturedStateFlag Group);
+
+    void MarkModified(D3D9CapturedStateFlag Group);
+
+    void SyncGenerations();
+
     void CapturePixelRenderStates();
     void CapturePixelSamplerStates();
     void CapturePixelShaderStates();
@@ -375,6 +372,14 @@ namespace dxvk {
 
     bool                 m_applying = false;
 
+    // Device state generations at the time each group
+    // was last captured or applied, or an invalid value
+    // if the state block itself was modified since.
+    std::array<uint64_t, D3D9CapturedStateFlagCount> m_syncGenerations;
+
+    uint32_t             m_groupsCopied  = 0;
+    uint32_t             m_groupsSkipped = 0;
+
   };
 
 }
\ No newline at end of file
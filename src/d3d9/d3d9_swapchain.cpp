@@ -643,6 +643,7 @@ namespace dxvk {
 
   void D3D9SwapChainEx::PresentImage(UINT SyncInterval) {
     m_parent->EndFrame();
+    m_parent->PublishStats();
     m_parent->Flush();
 
     // Retrieve the image and image view to present
@@ -906,6 +907,7 @@ namespace dxvk {
     if (m_hud != nullptr) {
       m_hud->addItem<hud::HudClientApiItem>("api", 1, GetApiName());
       m_hud->addItem<hud::HudSamplerCount>("samplers", -1, m_parent);
+      m_hud->addItem<hud::HudD3D9Stats>("d3d9stats", -1, m_parent);
 
 #ifdef D3D9_ALLOW_UNMAPPING
       m_hud->addItem<hud::HudTextureMemory>("memory", -1, m_parent);
@@ -928,6 +930,16 @@ namespace dxvk {
   void D3D9SwapChainEx::SyncFrameLatency() {
     // Wait for the sync event so that we respect the maximum frame latency
     m_frameLatencySignal->wait(m_frameId - GetActualFrameLatency());
+
+    // Delay the next frame so that it does not queue up behind
+    // previous frames on the GPU. The present is submitted from
+    // the CS thread, so wait for it to reach the submission queue
+    // first, otherwise the estimate would not include this frame.
+    // Errors are handled by SynchronizePresent on the next present.
+    if (m_device->config().latencyPacing) {
+      m_device->waitForSubmission(&m_presentStatus);
+      m_presenter->delayFrameStart(m_device->getLatencyStats().idleTime);
+    }
   }
 
 
@@ -9,13 +9,13 @@ namespace dxvk {
 
   // Doesn't compare everything, only what we use in SWVP.
 
-  size_t D3D9VertexDeclHash::operator () (const D3D9VertexElements& key) const {
+  size_t D3D9SWVPEmulatorKeyHash::operator () (const D3D9SWVPEmulatorKey& key) const {
     DxvkHashState hash;
 
     std::hash<BYTE> bytehash;
     std::hash<WORD> wordhash;
 
-    for (auto& element : key) {
+    for (auto& element : key.elements) {
       hash.add(wordhash(element.Stream));
       hash.add(wordhash(element.Offset));
       hash.add(bytehash(element.Type));
@@ -24,17 +24,18 @@ namespace dxvk {
       hash.add(bytehash(element.UsageIndex));
     }
 
+    hash.add(key.outputMask);
     return hash;
   }
 
-  bool D3D9VertexDeclEq::operator () (const D3D9VertexElements& a, const D3D9VertexElements& b) const {
-    if (a.size() != b.size())
+  bool D3D9SWVPEmulatorKeyEq::operator () (const D3D9SWVPEmulatorKey& a, const D3D9SWVPEmulatorKey& b) const {
+    if (a.elements.size() != b.elements.size() || a.outputMask != b.outputMask)
       return false;
 
     bool equal = true;
 
-    for (uint32_t i = 0; i < a.size(); i++)
-      equal &= std::memcmp(&a[i], &b[i], sizeof(a[0])) == 0;
+    for (uint32_t i = 0; i < a.elements.size(); i++)
+      equal &= std::memcmp(&a.elements[i], &b.elements[i], sizeof(a.elements[0])) == 0;
 
     return equal;
   }
@@ -78,6 +79,17 @@ namespace dxvk {
     }
   }
 
+  float GetDecltypeScale(const Decltype& Info) {
+    bool isSigned = Info.Flags & DecltypeFlags::Signed;
+
+    switch (Info.Class) {
+      case DecltypeClass::Byte:  return isSigned ? 127.0f   : 255.0f;
+      case DecltypeClass::Short: return isSigned ? 32767.0f : 65535.0f;
+      case DecltypeClass::Dec:   return isSigned ? 511.0f   : 1023.0f;
+      default:                   return 1.0f;
+    }
+  }
+
   class D3D9SWVPEmulatorGenerator {
 
   public:
@@ -109,7 +121,7 @@ namespace dxvk {
       m_module.opLabel(m_module.allocateId());
     }
 
-    void compile(const D3D9VertexDecl* pDecl) {
+    void compile(const D3D9VertexDecl* pDecl, uint32_t outputMask) {
       uint32_t uint_t     = m_module.defIntType(32, false);
       uint32_t float_t    = m_module.defFloatType(32);
       uint32_t vec4_t     = m_module.defVectorType(float_t, 4);
@@ -156,15 +168,21 @@ namespace dxvk {
         uint32_t elementPtr;
         uint32_t elementVar;
 
+        bool isPosition = (semantic.usage == DxsoUsage::Position || semantic.usage == DxsoUsage::PositionT) && element.UsageIndex == 0;
+        uint32_t slotIdx = isPosition ? 0u : RegisterLinkerSlot(semantic);
+
+        // Leave data that the vertex shader does not produce
+        // untouched if the application asked us to do so
+        if (!isPosition && !(outputMask & (1u << slotIdx)))
+          continue;
+
         elementPtr = m_module.newVar(m_module.defPointerType(vec4_singular_array_t, spv::StorageClassInput), spv::StorageClassInput);
-        if ((semantic.usage == DxsoUsage::Position || semantic.usage == DxsoUsage::PositionT) && element.UsageIndex == 0) {
+        if (isPosition) {
           // Load from builtin
           m_module.decorateBuiltIn(elementPtr, spv::BuiltInPosition);
         }
         else {
           // Load from slot
-          uint32_t slotIdx      = RegisterLinkerSlot(semantic);
-
           m_module.decorateLocation(elementPtr, slotIdx);
           m_inputMask |= 1u << slotIdx;
         }
@@ -182,17 +200,17 @@ namespace dxvk {
         // Write to the buffer at the element offset for each part of the vector.
         Decltype elementInfo = ClassifyDecltype(D3DDECLTYPE(element.Type));
 
-        if (elementInfo.Class == DecltypeClass::Dec) {
-          // TODO!
-          Logger::warn("Encountered DEC3/UDEC3N class, ignoring...");
-          continue;
-        }
-
-        uint32_t vecn_t = m_module.defVectorType(float_t, elementInfo.VectorCount);
+        uint32_t vecn_t = elementInfo.VectorCount > 1
+          ? m_module.defVectorType(float_t, elementInfo.VectorCount)
+          : float_t;
         uint32_t componentSet;
         
         // Modifiers...
-        if (elementInfo.Flags & DecltypeFlags::ReverseRGB) {
+        if (elementInfo.VectorCount == 1) {
+          uint32_t index = 0;
+          componentSet = m_module.opCompositeExtract(vecn_t, elementVar, 1, &index);
+        }
+        else if (elementInfo.Flags & DecltypeFlags::ReverseRGB) {
           std::array<uint32_t, 4> indices = { 2, 1, 0, 3 };
           componentSet = m_module.opVectorShuffle(vecn_t, elementVar, elementVar, elementInfo.VectorCount, indices.data());
         }
@@ -202,7 +220,7 @@ namespace dxvk {
         }
 
         if (elementInfo.Flags & DecltypeFlags::Normalize)
-          componentSet = m_module.opVectorTimesScalar(vecn_t, componentSet, m_module.constf32(255.0f));
+          componentSet = m_module.opVectorTimesScalar(vecn_t, componentSet, m_module.constf32(GetDecltypeScale(elementInfo)));
 
 
         bool isSigned = elementInfo.Flags & DecltypeFlags::Signed;
@@ -244,23 +262,48 @@ namespace dxvk {
             break;
           }
           case DecltypeClass::Dec: {
-            // TODO!
+            // Pack three 10-bit components into a single dword,
+            // the remaining two bits are always written as zero.
+            uint32_t uvec3_t = m_module.defVectorType(uint_t, 3);
+
+            if (isSigned) {
+              uint32_t ivec3_t = m_module.defVectorType(m_module.defIntType(32, true), 3);
+              componentSet = m_module.opBitcast(uvec3_t, m_module.opConvertFtoS(ivec3_t, componentSet));
+            } else {
+              componentSet = m_module.opConvertFtoU(uvec3_t, componentSet);
+            }
+
+            uint32_t packed = m_module.constu32(0);
+
+            for (uint32_t i = 0; i < 3; i++) {
+              packed = m_module.opBitFieldInsert(uint_t, packed,
+                m_module.opCompositeExtract(uint_t, componentSet, 1, &i),
+                m_module.constu32(10 * i), m_module.constu32(10));
+            }
+
+            componentSet = packed;
             break;
           }
         }
 
         // Bitcast to dwords before we write.
         uint32_t dwordCount  = GetDecltypeSize(D3DDECLTYPE(element.Type)) / sizeof(uint32_t);
-        uint32_t dwordVector = m_module.opBitcast(
-          m_module.defVectorType(uint_t, dwordCount),
-          componentSet);
+        uint32_t dwordVector = componentSet;
+
+        if (elementInfo.Class != DecltypeClass::Dec) {
+          dwordVector = m_module.opBitcast(dwordCount > 1
+            ? m_module.defVectorType(uint_t, dwordCount)
+            : uint_t, componentSet);
+        }
 
         // Finally write each dword to the buffer!
         for (uint32_t i = 0; i < dwordCount; i++) {
           std::array<uint32_t, 2> bufferIndices = { m_module.constu32(0), elementOffset };
 
           uint32_t writeDest = m_module.opAccessChain(m_module.defPointerType(uint_t, spv::StorageClassUniform), buffer, bufferIndices.size(), bufferIndices.data());
-          uint32_t currentDword = m_module.opCompositeExtract(uint_t, dwordVector, 1, &i);
+          uint32_t currentDword = dwordCount > 1
+            ? m_module.opCompositeExtract(uint_t, dwordVector, 1, &i)
+            : dwordVector;
 
           m_module.opStore(writeDest, currentDword);
 
@@ -296,19 +339,27 @@ namespace dxvk {
 
   };
 
-  Rc<DxvkShader> D3D9SWVPEmulator::GetShaderModule(D3D9DeviceEx* pDevice, const D3D9VertexDecl* pDecl) {
-    auto& elements = pDecl->GetElements();
+  Rc<DxvkShader> D3D9SWVPEmulator::GetShaderModule(D3D9DeviceEx* pDevice, const D3D9VertexDecl* pDecl, uint32_t outputMask) {
+    D3D9SWVPEmulatorKey lookupKey;
+    lookupKey.elements   = pDecl->GetElements();
+    lookupKey.outputMask = outputMask;
 
     // Use the shader's unique key for the lookup
     { std::unique_lock<dxvk::mutex> lock(m_mutex);
       
-      auto entry = m_modules.find(elements);
+      auto entry = m_modules.find(lookupKey);
       if (entry != m_modules.end())
         return entry->second;
     }
 
-    Sha1Hash hash = Sha1Hash::compute(
-      elements.data(), elements.size() * sizeof(elements[0]));
+    auto& elements = lookupKey.elements;
+
+    std::array<Sha1Data, 2> hashChunks = {{
+      { elements.data(), elements.size() * sizeof(elements[0]) },
+      { &lookupKey.outputMask, sizeof(lookupKey.outputMask) },
+    }};
+
+    Sha1Hash hash = Sha1Hash::compute(hashChunks.size(), hashChunks.data());
 
     DxvkShaderKey key = { VK_SHADER_STAGE_GEOMETRY_BIT , hash };
     std::string name = str::format("SWVP_", key.toString());
@@ -316,7 +367,7 @@ namespace dxvk {
     // This shader has not been compiled yet, so we have to create a
     // new module. This takes a while, so we won't lock the structure.
     D3D9SWVPEmulatorGenerator generator(name);
-    generator.compile(pDecl);
+    generator.compile(pDecl, outputMask);
     Rc<DxvkShader> shader = generator.finalize();
 
     shader->setShaderKey(key);
@@ -337,7 +388,7 @@ namespace dxvk {
     // that object instead and discard the newly created module.
     { std::unique_lock<dxvk::mutex> lock(m_mutex);
       
-      auto status = m_modules.insert({ elements, shader });
+      auto status = m_modules.insert({ lookupKey, shader });
       if (!status.second)
         return status.first->second;
     }
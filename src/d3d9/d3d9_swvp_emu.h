@@ -11,27 +11,40 @@ namespace dxvk {
   class D3D9VertexDecl;
   class D3D9DeviceEx;
 
-  struct D3D9VertexDeclHash {
-    size_t operator () (const D3D9VertexElements& key) const;
+  /**
+   * \brief SWVP emulation shader key
+   *
+   * Besides the output vertex declaration, this stores the
+   * set of linker slots that the vertex shader writes when
+   * \c D3DPV_DONOTCOPYDATA is used. Elements outside of that
+   * mask are left untouched in the destination buffer.
+   */
+  struct D3D9SWVPEmulatorKey {
+    D3D9VertexElements elements;
+    uint32_t           outputMask;
   };
 
-  struct D3D9VertexDeclEq {
-    bool operator () (const D3D9VertexElements& a, const D3D9VertexElements& b) const;
+  struct D3D9SWVPEmulatorKeyHash {
+    size_t operator () (const D3D9SWVPEmulatorKey& key) const;
+  };
+
+  struct D3D9SWVPEmulatorKeyEq {
+    bool operator () (const D3D9SWVPEmulatorKey& a, const D3D9SWVPEmulatorKey& b) const;
   };
 
   class D3D9SWVPEmulator {
 
   public:
 
-    Rc<DxvkShader> GetShaderModule(D3D9DeviceEx* pDevice, const D3D9VertexDecl* pDecl);
+    Rc<DxvkShader> GetShaderModule(D3D9DeviceEx* pDevice, const D3D9VertexDecl* pDecl, uint32_t outputMask);
 
   private:
 
     dxvk::mutex                               m_mutex;
 
     std::unordered_map<
-      D3D9VertexElements, Rc<DxvkShader>,
-      D3D9VertexDeclHash, D3D9VertexDeclEq>   m_modules;
+      D3D9SWVPEmulatorKey,     Rc<DxvkShader>,
+      D3D9SWVPEmulatorKeyHash, D3D9SWVPEmulatorKeyEq> m_modules;
 
   };
 
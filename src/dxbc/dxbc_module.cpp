@@ -40,6 +40,18 @@ namespace dxvk {
   }
   
   
+  void DxbcModule::validate() const {
+    if (m_shexChunk == nullptr)
+      throw DxvkError("DxbcModule::validate: No SHDR/SHEX chunk");
+    
+    DxbcCodeSlice slice = m_shexChunk->slice();
+    DxbcDecodeContext decoder;
+    
+    while (!slice.atEnd())
+      decoder.decodeInstruction(slice);
+  }
+  
+  
   Rc<DxvkShader> DxbcModule::compile(
     const DxbcModuleInfo& moduleInfo,
     const std::string&    fileName) const {
@@ -48,6 +48,15 @@ namespace dxvk {
     Rc<DxbcIsgn> isgn() const { return m_isgnChunk; }
     Rc<DxbcIsgn> osgn() const { return m_osgnChunk; }
     
+    /**
+     * \brief Validates the instruction stream
+     * 
+     * Decodes all instructions without compiling them,
+     * so that malformed byte code can be rejected before
+     * the shader gets translated. Throws on error.
+     */
+    void validate() const;
+    
     /**
      * \brief Compiles DXBC shader to SPIR-V module
      * 
@@ -47,9 +47,62 @@ namespace dxvk {
      || opcode == DxsoOpcode::TexDepth)
       m_analysis->usesDerivatives = true;
 
+    if (opcode == DxsoOpcode::Def) {
+      uint32_t reg = ctx.dst.id.num;
+
+      if (reg < 64 * m_definedFloatConsts.size())
+        m_definedFloatConsts[reg / 64] |= 1ull << (reg % 64);
+    } else if (opcode != DxsoOpcode::Dcl
+            && opcode != DxsoOpcode::DefI
+            && opcode != DxsoOpcode::DefB
+            && opcode != DxsoOpcode::Comment) {
+      // Matrix instructions implicitly read consecutive
+      // registers starting at the second source operand.
+      uint32_t matrixRows = 1;
+
+      switch (opcode) {
+        case DxsoOpcode::M3x2: matrixRows = 2; break;
+        case DxsoOpcode::M3x3: matrixRows = 3; break;
+        case DxsoOpcode::M3x4: matrixRows = 4; break;
+        case DxsoOpcode::M4x3: matrixRows = 3; break;
+        case DxsoOpcode::M4x4: matrixRows = 4; break;
+        default: break;
+      }
+
+      for (uint32_t i = 0; i < ctx.instruction.srcCount; i++)
+        this->processFloatConstRead(ctx.src[i], i == 1 ? matrixRows : 1);
+    }
+
     m_parentOpcode = ctx.instruction.opcode;
   }
 
+
+  void DxsoAnalyzer::processFloatConstRead(
+    const DxsoRegister&           reg,
+          uint32_t                count) {
+    if (reg.id.type != DxsoRegisterType::Const)
+      return;
+
+    if (reg.hasRelative) {
+      m_analysis->packableFloatConsts = false;
+      return;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t idx = reg.id.num + i;
+
+      if (idx >= 64 * m_analysis->usedFloatConsts.size()) {
+        m_analysis->packableFloatConsts = false;
+        return;
+      }
+
+      uint64_t bit = 1ull << (idx % 64);
+
+      if (!(m_definedFloatConsts[idx / 64] & bit))
+        m_analysis->usedFloatConsts[idx / 64] |= bit;
+    }
+  }
+
   void DxsoAnalyzer::finalize(size_t tokenCount) {
     m_analysis->bytecodeByteLength = tokenCount * sizeof(uint32_t);
   }
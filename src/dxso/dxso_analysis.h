@@ -11,6 +11,15 @@ namespace dxvk {
     bool usesDerivatives = false;
     bool usesKill        = false;
 
+    /// Whether float constants are only ever read
+    /// with immediate register indices. If so, the
+    /// used registers can be packed densely.
+    bool packableFloatConsts = true;
+
+    /// Float constant registers read from the constant
+    /// buffer, i.e. not overridden by a prior def.
+    std::array<uint64_t, 4> usedFloatConsts = { };
+
     std::vector<DxsoInstructionContext> coissues;
   };
 
@@ -36,6 +45,12 @@ namespace dxvk {
 
     DxsoOpcode m_parentOpcode;
 
+    std::array<uint64_t, 4> m_definedFloatConsts = { };
+
+    void processFloatConstRead(
+      const DxsoRegister&           reg,
+            uint32_t                count);
+
   };
 
 }
\ No newline at end of file
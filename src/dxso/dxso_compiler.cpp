@@ -54,6 +54,9 @@ namespace dxvk {
     for (uint32_t i = 0; i < m_cBool.size(); i++)
       m_cBool.at(i)  = 0;
 
+    for (uint32_t i = 0; i < m_cFloatPacked.size(); i++)
+      m_cFloatPacked.at(i) = 0;
+
     m_vs.addr        = DxsoRegisterPointer{ };
     m_vs.oPos        = DxsoRegisterPointer{ };
     m_fog            = DxsoRegisterPointer{ };
@@ -246,6 +249,7 @@ namespace dxvk {
       m_cBoolBuffer = this->emitDclSwvpConstantBuffer<DxsoConstantBufferType::Bool>();
     } else {
       this->emitDclConstantBuffer();
+      this->setupConstantPacking();
     }
 
     this->emitDclInputArray();
@@ -259,6 +263,37 @@ namespace dxvk {
     }
   }
 
+  void DxsoCompiler::setupConstantPacking() {
+    // Shaders typically only read a handful of float constants,
+    // so if none of them are accessed with relative addressing,
+    // store the used registers densely in the constant buffer.
+    if (!m_analysis->packableFloatConsts)
+      return;
+
+    const auto& used = m_analysis->usedFloatConsts;
+
+    for (uint32_t i = m_layout->floatCount; i < 64 * used.size(); i++) {
+      if (used[i / 64] & (1ull << (i % 64)))
+        return;
+    }
+
+    uint32_t packedCount = 0;
+
+    for (uint32_t i = 0; i < m_layout->floatCount; i++) {
+      if (!(used[i / 64] & (1ull << (i % 64))))
+        continue;
+
+      if (m_constantRanges.empty()
+       || m_constantRanges.back().first + m_constantRanges.back().count != i)
+        m_constantRanges.push_back({ i, 0u });
+
+      m_constantRanges.back().count += 1;
+      m_cFloatPacked.at(i) = packedCount++;
+    }
+
+    m_meta.packedConstCountF = packedCount;
+  }
+
   void DxsoCompiler::emitDclConstantBuffer() {
     std::array<uint32_t, 2> members = {
       // int i[16 or 2048]
@@ -916,7 +951,12 @@ namespace dxvk {
       default: break;
     }
 
-    uint32_t relativeIdx = this->emitArrayIndex(reg.id.num, relative);
+    uint32_t regIdx = reg.id.num;
+
+    if (reg.id.type == DxsoRegisterType::Const && m_meta.packedConstCountF)
+      regIdx = m_cFloatPacked.at(regIdx);
+
+    uint32_t relativeIdx = this->emitArrayIndex(regIdx, relative);
 
     if (reg.id.type != DxsoRegisterType::ConstBool) {
       uint32_t structIdx;
@@ -245,6 +245,7 @@ namespace dxvk {
 
     const DxsoShaderMetaInfo& meta() { return m_meta; }
     const DxsoDefinedConstants& constants() { return m_constants; }
+    const DxsoConstantRanges& constantRanges() { return m_constantRanges; }
     uint32_t usedSamplers() const { return m_usedSamplers; }
     uint32_t usedRTs() const { return m_usedRTs; }
     uint32_t maxDefinedConstant() const { return m_maxDefinedConstant; }
@@ -306,6 +307,12 @@ namespace dxvk {
     std::array<uint32_t, caps::MaxOtherConstantsSoftware> m_cInt;
     std::array<uint32_t, caps::MaxOtherConstantsSoftware> m_cBool;
 
+    ////////////////////////////////////////
+    // Packed float constant layout, only used
+    // if the shader does not index constants
+    DxsoConstantRanges m_constantRanges;
+    std::array<uint32_t, caps::MaxFloatConstantsVS> m_cFloatPacked;
+
     //////////////////////
     // Loop counter
     DxsoRegisterPointer m_loopCounter;
@@ -378,6 +385,8 @@ namespace dxvk {
 
     void emitDclConstantBuffer();
 
+    void setupConstantPacking();
+
     void emitDclInputArray();
     void emitDclOutputArray();
 
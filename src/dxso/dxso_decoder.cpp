@@ -193,6 +193,8 @@ namespace dxvk {
     uint32_t tokenLength =
       m_ctx.instruction.tokenLength;
 
+    m_ctx.instruction.srcCount = 0;
+
     switch (m_ctx.instruction.opcode) {
       case DxsoOpcode::If:
       case DxsoOpcode::Ifc:
@@ -207,6 +209,7 @@ namespace dxvk {
 
           sourceIdx++;
         }
+        m_ctx.instruction.srcCount = sourceIdx;
         return true;
       }
 
@@ -246,6 +249,7 @@ namespace dxvk {
             sourceIdx++;
           }
         }
+        m_ctx.instruction.srcCount = sourceIdx;
         return true;
       }
 
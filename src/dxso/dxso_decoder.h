@@ -75,6 +75,7 @@ namespace dxvk {
     DxsoOpcodeSpecificData specificData;
 
     uint32_t               tokenLength;
+    uint32_t               srcCount;
   };
 
   struct DxsoRegisterId {
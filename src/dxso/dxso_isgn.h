@@ -29,12 +29,37 @@ namespace dxvk {
 
   using DxsoDefinedConstants = std::vector<DxsoDefinedConstant>;
 
+  /**
+   * \brief Packed float constant range
+   *
+   * Consecutive float constant registers which are stored
+   * directly after the previous range in the constant buffer.
+   */
+  struct DxsoConstantRange {
+    uint32_t first;
+    uint32_t count;
+
+    bool operator == (const DxsoConstantRange& other) const {
+      return first == other.first && count == other.count;
+    }
+
+    bool operator != (const DxsoConstantRange& other) const {
+      return !operator == (other);
+    }
+  };
+
+  using DxsoConstantRanges = std::vector<DxsoConstantRange>;
+
   struct DxsoShaderMetaInfo {
     bool needsConstantCopies = false;
     uint32_t maxConstIndexF = 0;
     uint32_t maxConstIndexI = 0;
     uint32_t maxConstIndexB = 0;
 
+    // Number of float constants in the packed layout,
+    // or 0 if constants are indexed by register number.
+    uint32_t packedConstCountF = 0;
+
     uint32_t boolConstantMask = 0;
   };
 
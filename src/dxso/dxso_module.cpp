@@ -36,6 +36,7 @@ namespace dxvk {
 
     m_meta            = compiler->meta();
     m_constants       = compiler->constants();
+    m_constantRanges  = compiler->constantRanges();
     m_maxDefinedConst = compiler->maxDefinedConstant();
     m_usedSamplers    = compiler->usedSamplers();
     m_usedRTs         = compiler->usedRTs();
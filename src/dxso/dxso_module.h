@@ -55,6 +55,8 @@ namespace dxvk {
 
     const DxsoDefinedConstants& constants() { return m_constants; }
 
+    const DxsoConstantRanges& constantRanges() { return m_constantRanges; }
+
     uint32_t usedSamplers() { return m_usedSamplers; }
 
     uint32_t usedRTs() { return m_usedRTs; }
@@ -81,6 +83,7 @@ namespace dxvk {
     DxsoShaderMetaInfo   m_meta;
     uint32_t             m_maxDefinedConst;
     DxsoDefinedConstants m_constants;
+    DxsoConstantRanges   m_constantRanges;
 
   };
 
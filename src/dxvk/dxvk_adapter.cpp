@@ -378,6 +378,22 @@ namespace dxvk {
     enabledFeatures.extShaderModuleIdentifier.shaderModuleIdentifier =
       m_deviceFeatures.extShaderModuleIdentifier.shaderModuleIdentifier;
 
+    // Sparse binds are submitted to the graphics queue, so
+    // sparse resources can only be used if it supports them
+    uint32_t sparseQueueFamily = findQueueFamilies().graphics;
+
+    if (!(m_queueFamilies[sparseQueueFamily].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT)) {
+      enabledFeatures.core.features.sparseBinding = VK_FALSE;
+      enabledFeatures.core.features.sparseResidencyBuffer = VK_FALSE;
+      enabledFeatures.core.features.sparseResidencyImage2D = VK_FALSE;
+      enabledFeatures.core.features.sparseResidencyImage3D = VK_FALSE;
+      enabledFeatures.core.features.sparseResidency2Samples = VK_FALSE;
+      enabledFeatures.core.features.sparseResidency4Samples = VK_FALSE;
+      enabledFeatures.core.features.sparseResidency8Samples = VK_FALSE;
+      enabledFeatures.core.features.sparseResidency16Samples = VK_FALSE;
+      enabledFeatures.core.features.sparseResidencyAliased = VK_FALSE;
+    }
+
     Logger::info(str::format("Device properties:"
       "\n  Device name:     : ", m_deviceInfo.core.properties.deviceName,
       "\n  Driver version   : ",
@@ -1,5 +1,6 @@
 #include "dxvk_barrier.h"
 #include "dxvk_buffer.h"
+#include "dxvk_buffer_pool.h"
 #include "dxvk_device.h"
 
 #include <algorithm>
@@ -30,6 +31,13 @@ namespace dxvk {
       ? MaxBufferSize / m_physSliceStride
       : 1;
 
+    // Sparse buffers cannot be renamed since page
+    // mappings are tied to the Vulkan buffer object
+    if (createInfo.flags & VK_BUFFER_CREATE_SPARSE_BINDING_BIT) {
+      m_physSliceCount    = 1;
+      m_physSliceMaxCount = 1;
+    }
+
     // Allocate the initial set of buffer slices. Only clear
     // buffer memory if there is more than one slice, since
     // we expect the client api to initialize the first slice.
@@ -43,10 +51,42 @@ namespace dxvk {
 
     m_physSlice = slice;
     m_lazyAlloc = m_physSliceCount > 1;
+
+    if (createInfo.flags & VK_BUFFER_CREATE_SPARSE_BINDING_BIT) {
+      try {
+        m_sparsePageTable = DxvkSparsePageTable(device, this);
+      } catch (const DxvkError&) {
+        auto vkd = device->vkd();
+        vkd->vkDestroyBuffer(vkd->device(), m_buffer.buffer, nullptr);
+        throw;
+      }
+    }
+  }
+
+
+  DxvkBuffer::DxvkBuffer(
+          DxvkDevice*           device,
+    const DxvkBufferCreateInfo& createInfo,
+          DxvkSharedBufferPool& pool,
+          VkMemoryPropertyFlags memFlags)
+  : m_device        (device),
+    m_info          (createInfo),
+    m_memAlloc      (nullptr),
+    m_memFlags      (memFlags),
+    m_shaderStages  (util::shaderStages(createInfo.stages)),
+    m_sharedPool    (&pool) {
+    // All slices, including the initial one, are suballocated
+    // from the shared pool, so we never own a Vulkan buffer
+    m_physSliceLength = createInfo.size;
+    m_physSlice = allocSharedSlice();
   }
 
 
   DxvkBuffer::~DxvkBuffer() {
+    // Nothing can use the current slice anymore at this point
+    if (m_sharedPool)
+      freeSharedSlice(m_physSlice);
+
     auto vkd = m_device->vkd();
 
     for (const auto& buffer : m_buffers)
@@ -59,6 +99,7 @@ namespace dxvk {
     auto vkd = m_device->vkd();
 
     VkBufferCreateInfo info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    info.flags                 = m_info.flags;
     info.size                  = m_physSliceStride * sliceCount;
     info.usage                 = m_info.usage;
     info.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
@@ -72,6 +113,10 @@ namespace dxvk {
         "\n  size:  ", info.size,
         "\n  usage: ", info.usage));
     }
+
+    // Memory for sparse buffers is bound page by page later
+    if (info.flags & VK_BUFFER_CREATE_SPARSE_BINDING_BIT)
+      return handle;
     
     VkMemoryDedicatedRequirements dedicatedRequirements = { VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS };
     VkMemoryRequirements2 memReq = { VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2, &dedicatedRequirements };
@@ -117,6 +162,17 @@ namespace dxvk {
   }
 
 
+  DxvkBufferSliceHandle DxvkBuffer::allocSharedSlice() {
+    return m_sharedPool->alloc(m_memFlags, m_physSliceLength);
+  }
+
+
+  void DxvkBuffer::freeSharedSlice(
+    const DxvkBufferSliceHandle& slice) {
+    m_sharedPool->free(m_memFlags, slice);
+  }
+
+
   VkDeviceSize DxvkBuffer::computeSliceAlignment() const {
     const auto& devInfo = m_device->properties();
 
@@ -8,9 +8,12 @@
 #include "dxvk_hash.h"
 #include "dxvk_memory.h"
 #include "dxvk_resource.h"
+#include "dxvk_sparse.h"
 
 namespace dxvk {
 
+  class DxvkSharedBufferPool;
+
   /**
    * \brief Buffer create info
    * 
@@ -18,6 +21,9 @@ namespace dxvk {
    * passed to \ref DxvkDevice::createBuffer
    */
   struct DxvkBufferCreateInfo {
+    /// Buffer create flags
+    VkBufferCreateFlags flags = 0;
+
     /// Size of the buffer, in bytes
     VkDeviceSize size;
     
@@ -109,6 +115,12 @@ namespace dxvk {
             DxvkMemoryAllocator&  memAlloc,
             VkMemoryPropertyFlags memFlags);
     
+    DxvkBuffer(
+            DxvkDevice*           device,
+      const DxvkBufferCreateInfo& createInfo,
+            DxvkSharedBufferPool& pool,
+            VkMemoryPropertyFlags memFlags);
+    
     ~DxvkBuffer();
     
     /**
@@ -152,6 +164,16 @@ namespace dxvk {
     VkShaderStageFlags getShaderStages() const {
       return m_shaderStages;
     }
+
+    /**
+     * \brief Queries sparse page table
+     * \returns Page table, or \c nullptr for non-sparse buffers
+     */
+    DxvkSparsePageTable* getSparsePageTable() final {
+      return (m_info.flags & VK_BUFFER_CREATE_SPARSE_BINDING_BIT)
+        ? &m_sparsePageTable
+        : nullptr;
+    }
     
     /**
      * \brief Retrieves slice handle
@@ -243,6 +265,9 @@ namespace dxvk {
      * \returns The new buffer slice
      */
     DxvkBufferSliceHandle allocSlice() {
+      if (unlikely(m_sharedPool != nullptr))
+        return allocSharedSlice();
+
       std::unique_lock<sync::Spinlock> freeLock(m_freeMutex);
       
       // If no slices are available, swap the two free lists.
@@ -285,6 +310,11 @@ namespace dxvk {
      * \param [in] slice The buffer slice to free
      */
     void freeSlice(const DxvkBufferSliceHandle& slice) {
+      if (unlikely(m_sharedPool != nullptr)) {
+        freeSharedSlice(slice);
+        return;
+      }
+
       // Add slice to a separate free list to reduce lock contention.
       std::unique_lock<sync::Spinlock> swapLock(m_swapMutex);
       m_nextSlices.push_back(slice);
@@ -297,11 +327,14 @@ namespace dxvk {
     DxvkMemoryAllocator*    m_memAlloc;
     VkMemoryPropertyFlags   m_memFlags;
     VkShaderStageFlags      m_shaderStages;
+    DxvkSharedBufferPool*   m_sharedPool = nullptr;
     
     DxvkBufferHandle        m_buffer;
     DxvkBufferSliceHandle   m_physSlice;
     uint32_t                m_vertexStride = 0;
 
+    DxvkSparsePageTable     m_sparsePageTable;
+
     alignas(CACHE_LINE_SIZE)
     sync::Spinlock          m_freeMutex;
 
@@ -331,6 +364,11 @@ namespace dxvk {
             VkDeviceSize          sliceCount,
             bool                  clear) const;
 
+    DxvkBufferSliceHandle allocSharedSlice();
+
+    void freeSharedSlice(
+      const DxvkBufferSliceHandle& slice);
+
     VkDeviceSize computeSliceAlignment() const;
     
   };
@@ -0,0 +1,127 @@
+#include "dxvk_buffer_pool.h"
+#include "dxvk_device.h"
+
+#include "../util/util_bit.h"
+
+namespace dxvk {
+
+  // Texel buffer usage is not supported since buffer views cache
+  // one Vulkan view per slice, and pooled slices are spread across
+  // the entire chunk, which would make that cache grow unbounded.
+  constexpr static VkBufferUsageFlags SharedBufferUsage
+    = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+    | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+    | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+    | VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+    | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+    | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+
+  DxvkSharedBufferPool::DxvkSharedBufferPool(
+          DxvkDevice*           device)
+  : m_device(device) {
+
+  }
+
+
+  DxvkSharedBufferPool::~DxvkSharedBufferPool() {
+
+  }
+
+
+  bool DxvkSharedBufferPool::isSupported(
+    const DxvkBufferCreateInfo& createInfo,
+          VkMemoryPropertyFlags memFlags) {
+    return (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        && !(createInfo.flags)
+        && !(createInfo.usage & ~SharedBufferUsage)
+        && createInfo.size <= MaxSliceSize;
+  }
+
+
+  DxvkBufferSliceHandle DxvkSharedBufferPool::alloc(
+          VkMemoryPropertyFlags memFlags,
+          VkDeviceSize          size) {
+    uint32_t sizeClass = getSizeClass(size);
+    VkDeviceSize sliceSize = MinSliceSize << sizeClass;
+
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    Pool& pool = getPool(memFlags);
+
+    // Reuse a slice that the GPU is done with if possible
+    auto& freeList = pool.freeLists[sizeClass];
+
+    if (!freeList.empty()) {
+      DxvkBufferSliceHandle result = freeList.back();
+      result.length = size;
+
+      freeList.pop_back();
+      return result;
+    }
+
+    // Otherwise, take a new slice from the current chunk.
+    // Any remaining space in a full chunk is left unused.
+    if (pool.chunkOffset + sliceSize > ChunkSize) {
+      pool.chunks.push_back(createChunk(memFlags));
+      pool.chunkOffset = 0;
+    }
+
+    DxvkBufferSliceHandle result = pool.chunks.back()->getSliceHandle(pool.chunkOffset, size);
+    pool.chunkOffset += sliceSize;
+    return result;
+  }
+
+
+  void DxvkSharedBufferPool::free(
+          VkMemoryPropertyFlags memFlags,
+    const DxvkBufferSliceHandle& slice) {
+    uint32_t sizeClass = getSizeClass(slice.length);
+
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    getPool(memFlags).freeLists[sizeClass].push_back(slice);
+  }
+
+
+  DxvkSharedBufferPool::Pool& DxvkSharedBufferPool::getPool(
+          VkMemoryPropertyFlags memFlags) {
+    for (auto& pool : m_pools) {
+      if (pool.memFlags == memFlags)
+        return pool;
+    }
+
+    Pool& pool = m_pools.emplace_back();
+    pool.memFlags = memFlags;
+    return pool;
+  }
+
+
+  Rc<DxvkBuffer> DxvkSharedBufferPool::createChunk(
+          VkMemoryPropertyFlags memFlags) {
+    DxvkBufferCreateInfo info;
+    info.size   = ChunkSize;
+    info.usage  = SharedBufferUsage;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT
+                | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+                | VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT
+                | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    info.access = VK_ACCESS_TRANSFER_READ_BIT
+                | VK_ACCESS_TRANSFER_WRITE_BIT
+                | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+                | VK_ACCESS_INDEX_READ_BIT
+                | VK_ACCESS_UNIFORM_READ_BIT
+                | VK_ACCESS_SHADER_READ_BIT;
+
+    return m_device->createBuffer(info, memFlags);
+  }
+
+
+  uint32_t DxvkSharedBufferPool::getSizeClass(
+          VkDeviceSize          size) {
+    if (size <= MinSliceSize)
+      return 0;
+
+    // Round up to the next power of two
+    return 32 - bit::lzcnt(uint32_t(size - 1)) - 8;
+  }
+
+}
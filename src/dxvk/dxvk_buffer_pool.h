@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "dxvk_buffer.h"
+
+namespace dxvk {
+
+  class DxvkDevice;
+
+  /**
+   * \brief Shared buffer pool
+   *
+   * Suballocates buffer slices for small, frequently discarded
+   * buffers from a small number of large, persistently mapped
+   * buffers, rather than having every buffer create its own
+   * set of backing buffers. Slices are bucketed by size, and
+   * are returned to the pool once the GPU has finished using
+   * them, which happens through the regular buffer tracking.
+   */
+  class DxvkSharedBufferPool {
+    constexpr static VkDeviceSize MinSliceSize    = 256;
+    constexpr static VkDeviceSize MaxSliceSize    = 64 << 10;
+    constexpr static VkDeviceSize ChunkSize       = 4 << 20;
+    constexpr static uint32_t     SizeClassCount  = 9;
+  public:
+
+    DxvkSharedBufferPool(
+            DxvkDevice*           device);
+
+    ~DxvkSharedBufferPool();
+
+    /**
+     * \brief Checks whether a buffer can use the pool
+     *
+     * Only small host-visible buffers with a limited set
+     * of usage flags can be suballocated from the pool.
+     * \param [in] createInfo Buffer create info
+     * \param [in] memFlags Memory type flags
+     * \returns \c true if the pool can be used
+     */
+    static bool isSupported(
+      const DxvkBufferCreateInfo& createInfo,
+            VkMemoryPropertyFlags memFlags);
+
+    /**
+     * \brief Allocates a buffer slice
+     *
+     * \param [in] memFlags Memory type flags
+     * \param [in] size Slice size, in bytes
+     * \returns Buffer slice handle
+     */
+    DxvkBufferSliceHandle alloc(
+            VkMemoryPropertyFlags memFlags,
+            VkDeviceSize          size);
+
+    /**
+     * \brief Returns a buffer slice to the pool
+     *
+     * Must only be called once the slice
+     * is no longer in use by the GPU.
+     * \param [in] memFlags Memory type flags
+     * \param [in] slice The slice to free
+     */
+    void free(
+            VkMemoryPropertyFlags memFlags,
+      const DxvkBufferSliceHandle& slice);
+
+  private:
+
+    struct Pool {
+      VkMemoryPropertyFlags memFlags    = 0;
+      VkDeviceSize          chunkOffset = ChunkSize;
+
+      std::vector<Rc<DxvkBuffer>> chunks;
+      std::array<std::vector<DxvkBufferSliceHandle>, SizeClassCount> freeLists;
+    };
+
+    DxvkDevice*           m_device;
+
+    dxvk::mutex           m_mutex;
+    std::vector<Pool>     m_pools;
+
+    Pool& getPool(
+            VkMemoryPropertyFlags memFlags);
+
+    Rc<DxvkBuffer> createChunk(
+            VkMemoryPropertyFlags memFlags);
+
+    static uint32_t getSizeClass(
+            VkDeviceSize          size);
+
+  };
+
+}
@@ -67,6 +67,26 @@ namespace dxvk {
     const auto& graphics = m_device->queues().graphics;
     const auto& transfer = m_device->queues().transfer;
 
+    VkSemaphoreSubmitInfo bindWaitInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO };
+
+    if (!m_bindSubmission.isEmpty()) {
+      // Sparse binds are not implicitly ordered with other
+      // queue operations, so wait for all previous submissions
+      // to complete and make the command buffers wait for the
+      // binds via the global timeline semaphore.
+      m_bindSubmission.waitSemaphore(semaphore, semaphoreValue);
+      m_bindSubmission.signalSemaphore(semaphore, ++semaphoreValue);
+
+      VkResult status = m_bindSubmission.submit(m_device, graphics.queueHandle);
+
+      if (status != VK_SUCCESS)
+        return status;
+
+      bindWaitInfo.semaphore = semaphore;
+      bindWaitInfo.value = semaphoreValue;
+      bindWaitInfo.stageMask = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT;
+    }
+
     m_submission.reset();
 
     if (m_cmdBuffersUsed.test(DxvkCmdBuffer::SdmaBuffer)) {
@@ -94,6 +114,9 @@ namespace dxvk {
       }
     }
 
+    if (bindWaitInfo.semaphore)
+      m_submission.waitInfos.push_back(bindWaitInfo);
+
     if (m_cmdBuffersUsed.test(DxvkCmdBuffer::InitBuffer)) {
       VkCommandBufferSubmitInfo cmdInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO };
       cmdInfo.commandBuffer = m_initBuffer;
@@ -166,6 +189,7 @@ namespace dxvk {
     // Unconditionally mark the exec buffer as used. There
     // is virtually no use case where this isn't correct.
     m_cmdBuffersUsed = DxvkCmdBuffer::ExecBuffer;
+    m_execBufferRecorded = false;
   }
   
   
@@ -209,6 +233,10 @@ namespace dxvk {
     m_signalSemaphores.clear();
 
     m_wsiSemaphores = vk::PresenterSync();
+
+    // Release pages that were unbound from sparse resources
+    m_bindSubmission.reset();
+    m_sparsePages.clear();
   }
 
 
@@ -15,6 +15,7 @@
 #include "dxvk_limits.h"
 #include "dxvk_pipelayout.h"
 #include "dxvk_signal.h"
+#include "dxvk_sparse.h"
 #include "dxvk_staging.h"
 #include "dxvk_stats.h"
 
@@ -182,6 +183,69 @@ namespace dxvk {
       m_pipelines.push_back(pipeline);
     }
 
+    /**
+     * \brief Checks whether any commands were recorded
+     *
+     * Unlike the set of used command buffers, this does not
+     * account for the exec buffer being submitted implicitly.
+     * \returns \c true if any command was recorded since
+     *    the command list was last reset.
+     */
+    bool hasCommands() const {
+      return m_execBufferRecorded
+          || m_cmdBuffersUsed.any(DxvkCmdBuffer::InitBuffer, DxvkCmdBuffer::SdmaBuffer);
+    }
+
+    /**
+     * \brief Tracks a sparse page
+     *
+     * Keeps a page that was unbound from a sparse resource
+     * alive until the command buffer has finished executing.
+     * \param [in] page Page object
+     */
+    void trackSparsePage(Rc<DxvkSparsePage>&& page) {
+      if (page != nullptr)
+        m_sparsePages.push_back(std::move(page));
+    }
+
+    /**
+     * \brief Adds a sparse buffer memory bind
+     *
+     * Binds are executed on the sparse binding queue
+     * before any command buffers of this submission.
+     * \param [in] buffer Buffer handle
+     * \param [in] bind Memory bind
+     */
+    void bindBufferMemory(
+            VkBuffer              buffer,
+      const VkSparseMemoryBind&   bind) {
+      m_bindSubmission.bindBufferMemory(buffer, bind);
+    }
+
+    /**
+     * \brief Adds a sparse image memory bind
+     *
+     * \param [in] image Image handle
+     * \param [in] bind Memory bind
+     */
+    void bindImageMemory(
+            VkImage               image,
+      const VkSparseImageMemoryBind& bind) {
+      m_bindSubmission.bindImageMemory(image, bind);
+    }
+
+    /**
+     * \brief Adds an opaque sparse image memory bind
+     *
+     * \param [in] image Image handle
+     * \param [in] bind Memory bind
+     */
+    void bindImageOpaqueMemory(
+            VkImage               image,
+      const VkSparseMemoryBind&   bind) {
+      m_bindSubmission.bindImageOpaqueMemory(image, bind);
+    }
+
     /**
      * \brief Queues signal
      * 
@@ -194,6 +258,17 @@ namespace dxvk {
       m_signalTracker.add(signal, value);
     }
 
+    /**
+     * \brief Sets tracking ID of tracked resources
+     *
+     * Records the submission that last uses each resource,
+     * so that the host can wait for that submission only.
+     * \param [in] trackId Submission tracking ID
+     */
+    void setTrackId(uint64_t trackId) {
+      m_resources.setTrackId(trackId);
+    }
+
     /**
      * \brief Notifies resources and signals
      */
@@ -263,12 +338,12 @@ namespace dxvk {
     void cmdBeginConditionalRendering(
       const VkConditionalRenderingBeginInfoEXT* pConditionalRenderingBegin) {
       m_vkd->vkCmdBeginConditionalRenderingEXT(
-        m_execBuffer, pConditionalRenderingBegin);
+        getExecBuffer(), pConditionalRenderingBegin);
     }
 
 
     void cmdEndConditionalRendering() {
-      m_vkd->vkCmdEndConditionalRenderingEXT(m_execBuffer);
+      m_vkd->vkCmdEndConditionalRenderingEXT(getExecBuffer());
     }
 
     
@@ -277,7 +352,7 @@ namespace dxvk {
             VkQueryPool             queryPool,
             uint32_t                query,
             VkQueryControlFlags     flags) {
-      m_vkd->vkCmdBeginQuery(m_execBuffer,
+      m_vkd->vkCmdBeginQuery(getExecBuffer(),
         queryPool, query, flags);
     }
     
@@ -288,13 +363,13 @@ namespace dxvk {
             VkQueryControlFlags     flags,
             uint32_t                index) {
       m_vkd->vkCmdBeginQueryIndexedEXT(
-        m_execBuffer, queryPool, query, flags, index);
+        getExecBuffer(), queryPool, query, flags, index);
     }
 
 
     void cmdBeginRendering(
       const VkRenderingInfo*        pRenderingInfo) {
-      m_vkd->vkCmdBeginRendering(m_execBuffer, pRenderingInfo);
+      m_vkd->vkCmdBeginRendering(getExecBuffer(), pRenderingInfo);
     }
 
     
@@ -303,7 +378,7 @@ namespace dxvk {
             uint32_t                  bufferCount,
       const VkBuffer*                 counterBuffers,
       const VkDeviceSize*             counterOffsets) {
-      m_vkd->vkCmdBeginTransformFeedbackEXT(m_execBuffer,
+      m_vkd->vkCmdBeginTransformFeedbackEXT(getExecBuffer(),
         firstBuffer, bufferCount, counterBuffers, counterOffsets);
     }
     
@@ -314,7 +389,7 @@ namespace dxvk {
             VkDescriptorSet           descriptorSet,
             uint32_t                  dynamicOffsetCount,
       const uint32_t*                 pDynamicOffsets) {
-      m_vkd->vkCmdBindDescriptorSets(m_execBuffer,
+      m_vkd->vkCmdBindDescriptorSets(getExecBuffer(),
         pipeline, pipelineLayout, 0, 1,
         &descriptorSet, dynamicOffsetCount, pDynamicOffsets);
     }
@@ -328,7 +403,7 @@ namespace dxvk {
       const VkDescriptorSet*          descriptorSets,
             uint32_t                  dynamicOffsetCount,
       const uint32_t*                 pDynamicOffsets) {
-      m_vkd->vkCmdBindDescriptorSets(m_execBuffer,
+      m_vkd->vkCmdBindDescriptorSets(getExecBuffer(),
         pipeline, pipelineLayout, firstSet, descriptorSetCount,
         descriptorSets, dynamicOffsetCount, pDynamicOffsets);
     }
@@ -338,7 +413,7 @@ namespace dxvk {
             VkBuffer                buffer,
             VkDeviceSize            offset,
             VkIndexType             indexType) {
-      m_vkd->vkCmdBindIndexBuffer(m_execBuffer,
+      m_vkd->vkCmdBindIndexBuffer(getExecBuffer(),
         buffer, offset, indexType);
     }
     
@@ -346,7 +421,7 @@ namespace dxvk {
     void cmdBindPipeline(
             VkPipelineBindPoint     pipelineBindPoint,
             VkPipeline              pipeline) {
-      m_vkd->vkCmdBindPipeline(m_execBuffer,
+      m_vkd->vkCmdBindPipeline(getExecBuffer(),
         pipelineBindPoint, pipeline);
     }
 
@@ -357,7 +432,7 @@ namespace dxvk {
       const VkBuffer*               pBuffers,
       const VkDeviceSize*           pOffsets,
       const VkDeviceSize*           pSizes) {
-      m_vkd->vkCmdBindTransformFeedbackBuffersEXT(m_execBuffer,
+      m_vkd->vkCmdBindTransformFeedbackBuffersEXT(getExecBuffer(),
         firstBinding, bindingCount, pBuffers, pOffsets, pSizes);
     }
     
@@ -369,18 +444,18 @@ namespace dxvk {
       const VkDeviceSize*           pOffsets,
       const VkDeviceSize*           pSizes,
       const VkDeviceSize*           pStrides) {
-      m_vkd->vkCmdBindVertexBuffers2(m_execBuffer,
+      m_vkd->vkCmdBindVertexBuffers2(getExecBuffer(),
         firstBinding, bindingCount, pBuffers, pOffsets,
         pSizes, pStrides);
     }
     
     void cmdLaunchCuKernel(VkCuLaunchInfoNVX launchInfo) {
-      m_vkd->vkCmdCuLaunchKernelNVX(m_execBuffer, &launchInfo);
+      m_vkd->vkCmdCuLaunchKernelNVX(getExecBuffer(), &launchInfo);
     }
     
     void cmdBlitImage(
         const VkBlitImageInfo2*     pBlitInfo) {
-      m_vkd->vkCmdBlitImage2(m_execBuffer, pBlitInfo);
+      m_vkd->vkCmdBlitImage2(getExecBuffer(), pBlitInfo);
     }
     
     
@@ -389,7 +464,7 @@ namespace dxvk {
       const VkClearAttachment*      pAttachments,
             uint32_t                rectCount,
       const VkClearRect*            pRects) {
-      m_vkd->vkCmdClearAttachments(m_execBuffer,
+      m_vkd->vkCmdClearAttachments(getExecBuffer(),
         attachmentCount, pAttachments,
         rectCount, pRects);
     }
@@ -401,7 +476,7 @@ namespace dxvk {
       const VkClearColorValue*      pColor,
             uint32_t                rangeCount,
       const VkImageSubresourceRange* pRanges) {
-      m_vkd->vkCmdClearColorImage(m_execBuffer,
+      m_vkd->vkCmdClearColorImage(getExecBuffer(),
         image, imageLayout, pColor,
         rangeCount, pRanges);
     }
@@ -413,7 +488,7 @@ namespace dxvk {
       const VkClearDepthStencilValue* pDepthStencil,
             uint32_t                rangeCount,
       const VkImageSubresourceRange* pRanges) {
-      m_vkd->vkCmdClearDepthStencilImage(m_execBuffer,
+      m_vkd->vkCmdClearDepthStencilImage(getExecBuffer(),
         image, imageLayout, pDepthStencil,
         rangeCount, pRanges);
     }
@@ -463,7 +538,7 @@ namespace dxvk {
             VkDeviceSize            dstOffset,
             VkDeviceSize            stride,
             VkQueryResultFlags      flags) {
-      m_vkd->vkCmdCopyQueryPoolResults(m_execBuffer,
+      m_vkd->vkCmdCopyQueryPoolResults(getExecBuffer(),
         queryPool, firstQuery, queryCount,
         dstBuffer, dstOffset, stride, flags);
     }
@@ -473,7 +548,7 @@ namespace dxvk {
             uint32_t                x,
             uint32_t                y,
             uint32_t                z) {
-      m_vkd->vkCmdDispatch(m_execBuffer, x, y, z);
+      m_vkd->vkCmdDispatch(getExecBuffer(), x, y, z);
     }
     
     
@@ -481,7 +556,7 @@ namespace dxvk {
             VkBuffer                buffer,
             VkDeviceSize            offset) {
       m_vkd->vkCmdDispatchIndirect(
-        m_execBuffer, buffer, offset);
+        getExecBuffer(), buffer, offset);
     }
     
     
@@ -490,7 +565,7 @@ namespace dxvk {
             uint32_t                instanceCount,
             uint32_t                firstVertex,
             uint32_t                firstInstance) {
-      m_vkd->vkCmdDraw(m_execBuffer,
+      m_vkd->vkCmdDraw(getExecBuffer(),
         vertexCount, instanceCount,
         firstVertex, firstInstance);
     }
@@ -501,7 +576,7 @@ namespace dxvk {
             VkDeviceSize            offset,
             uint32_t                drawCount,
             uint32_t                stride) {
-      m_vkd->vkCmdDrawIndirect(m_execBuffer,
+      m_vkd->vkCmdDrawIndirect(getExecBuffer(),
         buffer, offset, drawCount, stride);
     }
     
@@ -513,7 +588,7 @@ namespace dxvk {
             VkDeviceSize            countOffset,
             uint32_t                maxDrawCount,
             uint32_t                stride) {
-      m_vkd->vkCmdDrawIndirectCount(m_execBuffer,
+      m_vkd->vkCmdDrawIndirectCount(getExecBuffer(),
         buffer, offset, countBuffer, countOffset, maxDrawCount, stride);
     }
     
@@ -524,7 +599,7 @@ namespace dxvk {
             uint32_t                firstIndex,
             uint32_t                vertexOffset,
             uint32_t                firstInstance) {
-      m_vkd->vkCmdDrawIndexed(m_execBuffer,
+      m_vkd->vkCmdDrawIndexed(getExecBuffer(),
         indexCount, instanceCount,
         firstIndex, vertexOffset,
         firstInstance);
@@ -536,7 +611,7 @@ namespace dxvk {
             VkDeviceSize            offset,
             uint32_t                drawCount,
             uint32_t                stride) {
-      m_vkd->vkCmdDrawIndexedIndirect(m_execBuffer,
+      m_vkd->vkCmdDrawIndexedIndirect(getExecBuffer(),
         buffer, offset, drawCount, stride);
     }
 
@@ -548,7 +623,7 @@ namespace dxvk {
             VkDeviceSize            countOffset,
             uint32_t                maxDrawCount,
             uint32_t                stride) {
-      m_vkd->vkCmdDrawIndexedIndirectCount(m_execBuffer,
+      m_vkd->vkCmdDrawIndexedIndirectCount(getExecBuffer(),
         buffer, offset, countBuffer, countOffset, maxDrawCount, stride);
     }
     
@@ -560,7 +635,7 @@ namespace dxvk {
             VkDeviceSize            counterBufferOffset,
             uint32_t                counterOffset,
             uint32_t                vertexStride) {
-      m_vkd->vkCmdDrawIndirectByteCountEXT(m_execBuffer,
+      m_vkd->vkCmdDrawIndirectByteCountEXT(getExecBuffer(),
         instanceCount, firstInstance, counterBuffer,
         counterBufferOffset, counterOffset, vertexStride);
     }
@@ -569,7 +644,7 @@ namespace dxvk {
     void cmdEndQuery(
             VkQueryPool             queryPool,
             uint32_t                query) {
-      m_vkd->vkCmdEndQuery(m_execBuffer, queryPool, query);
+      m_vkd->vkCmdEndQuery(getExecBuffer(), queryPool, query);
     }
 
 
@@ -578,12 +653,12 @@ namespace dxvk {
             uint32_t                query,
             uint32_t                index) {
       m_vkd->vkCmdEndQueryIndexedEXT(
-        m_execBuffer, queryPool, query, index);
+        getExecBuffer(), queryPool, query, index);
     }
     
     
     void cmdEndRendering() {
-      m_vkd->vkCmdEndRendering(m_execBuffer);
+      m_vkd->vkCmdEndRendering(getExecBuffer());
     }
 
     
@@ -592,7 +667,7 @@ namespace dxvk {
             uint32_t                  bufferCount,
       const VkBuffer*                 counterBuffers,
       const VkDeviceSize*             counterOffsets) {
-      m_vkd->vkCmdEndTransformFeedbackEXT(m_execBuffer,
+      m_vkd->vkCmdEndTransformFeedbackEXT(getExecBuffer(),
         firstBuffer, bufferCount, counterBuffers, counterOffsets);
     }
 
@@ -625,14 +700,14 @@ namespace dxvk {
             uint32_t                offset,
             uint32_t                size,
       const void*                   pValues) {
-      m_vkd->vkCmdPushConstants(m_execBuffer,
+      m_vkd->vkCmdPushConstants(getExecBuffer(),
         layout, stageFlags, offset, size, pValues);
     }
 
 
     void cmdResolveImage(
       const VkResolveImageInfo2*    resolveInfo) {
-      m_vkd->vkCmdResolveImage2(m_execBuffer, resolveInfo);
+      m_vkd->vkCmdResolveImage2(getExecBuffer(), resolveInfo);
     }
     
     
@@ -650,13 +725,13 @@ namespace dxvk {
     
     
     void cmdSetBlendConstants(const float blendConstants[4]) {
-      m_vkd->vkCmdSetBlendConstants(m_execBuffer, blendConstants);
+      m_vkd->vkCmdSetBlendConstants(getExecBuffer(), blendConstants);
     }
     
 
     void cmdSetDepthBiasState(
             VkBool32                depthBiasEnable) {
-      m_vkd->vkCmdSetDepthBiasEnable(m_execBuffer, depthBiasEnable);
+      m_vkd->vkCmdSetDepthBiasEnable(getExecBuffer(), depthBiasEnable);
     }
 
 
@@ -664,7 +739,7 @@ namespace dxvk {
             float                   depthBiasConstantFactor,
             float                   depthBiasClamp,
             float                   depthBiasSlopeFactor) {
-      m_vkd->vkCmdSetDepthBias(m_execBuffer,
+      m_vkd->vkCmdSetDepthBias(getExecBuffer(),
         depthBiasConstantFactor,
         depthBiasClamp,
         depthBiasSlopeFactor);
@@ -674,7 +749,7 @@ namespace dxvk {
     void cmdSetDepthBounds(
             float                   minDepthBounds,
             float                   maxDepthBounds) {
-      m_vkd->vkCmdSetDepthBounds(m_execBuffer,
+      m_vkd->vkCmdSetDepthBounds(getExecBuffer(),
         minDepthBounds,
         maxDepthBounds);
     }
@@ -682,7 +757,7 @@ namespace dxvk {
 
     void cmdSetDepthBoundsState(
             VkBool32                depthBoundsTestEnable) {
-      m_vkd->vkCmdSetDepthBoundsTestEnable(m_execBuffer, depthBoundsTestEnable);
+      m_vkd->vkCmdSetDepthBoundsTestEnable(getExecBuffer(), depthBoundsTestEnable);
     }
 
 
@@ -690,14 +765,14 @@ namespace dxvk {
             VkBool32                depthTestEnable,
             VkBool32                depthWriteEnable,
             VkCompareOp             depthCompareOp) {
-      m_vkd->vkCmdSetDepthTestEnable(m_execBuffer, depthTestEnable);
+      m_vkd->vkCmdSetDepthTestEnable(getExecBuffer(), depthTestEnable);
 
       if (depthTestEnable) {
-        m_vkd->vkCmdSetDepthWriteEnable(m_execBuffer, depthWriteEnable);
-        m_vkd->vkCmdSetDepthCompareOp(m_execBuffer, depthCompareOp);
+        m_vkd->vkCmdSetDepthWriteEnable(getExecBuffer(), depthWriteEnable);
+        m_vkd->vkCmdSetDepthCompareOp(getExecBuffer(), depthCompareOp);
       } else {
-        m_vkd->vkCmdSetDepthWriteEnable(m_execBuffer, VK_FALSE);
-        m_vkd->vkCmdSetDepthCompareOp(m_execBuffer, VK_COMPARE_OP_ALWAYS);
+        m_vkd->vkCmdSetDepthWriteEnable(getExecBuffer(), VK_FALSE);
+        m_vkd->vkCmdSetDepthCompareOp(getExecBuffer(), VK_COMPARE_OP_ALWAYS);
       }
     }
 
@@ -705,15 +780,15 @@ namespace dxvk {
     void cmdSetEvent(
             VkEvent                 event,
       const VkDependencyInfo*       dependencyInfo) {
-      m_vkd->vkCmdSetEvent2(m_execBuffer, event, dependencyInfo);
+      m_vkd->vkCmdSetEvent2(getExecBuffer(), event, dependencyInfo);
     }
 
 
     void cmdSetRasterizerState(
             VkCullModeFlags         cullMode,
             VkFrontFace             frontFace) {
-      m_vkd->vkCmdSetCullMode(m_execBuffer, cullMode);
-      m_vkd->vkCmdSetFrontFace(m_execBuffer, frontFace);
+      m_vkd->vkCmdSetCullMode(getExecBuffer(), cullMode);
+      m_vkd->vkCmdSetFrontFace(getExecBuffer(), frontFace);
     }
 
     
@@ -721,7 +796,7 @@ namespace dxvk {
             uint32_t                scissorCount,
       const VkRect2D*               scissors) {
       m_vkd->vkCmdSetScissorWithCount(
-        m_execBuffer, scissorCount, scissors);
+        getExecBuffer(), scissorCount, scissors);
     }
 
 
@@ -730,32 +805,32 @@ namespace dxvk {
       const VkStencilOpState&       front,
       const VkStencilOpState&       back) {
       m_vkd->vkCmdSetStencilTestEnable(
-        m_execBuffer, enableStencilTest);
+        getExecBuffer(), enableStencilTest);
 
       if (enableStencilTest) {
-        m_vkd->vkCmdSetStencilOp(m_execBuffer,
+        m_vkd->vkCmdSetStencilOp(getExecBuffer(),
           VK_STENCIL_FACE_FRONT_BIT, front.failOp,
           front.passOp, front.depthFailOp, front.compareOp);
-        m_vkd->vkCmdSetStencilCompareMask(m_execBuffer,
+        m_vkd->vkCmdSetStencilCompareMask(getExecBuffer(),
           VK_STENCIL_FACE_FRONT_BIT, front.compareMask);
-        m_vkd->vkCmdSetStencilWriteMask(m_execBuffer,
+        m_vkd->vkCmdSetStencilWriteMask(getExecBuffer(),
           VK_STENCIL_FACE_FRONT_BIT, front.writeMask);
 
-        m_vkd->vkCmdSetStencilOp(m_execBuffer,
+        m_vkd->vkCmdSetStencilOp(getExecBuffer(),
           VK_STENCIL_FACE_BACK_BIT, back.failOp,
           back.passOp, back.depthFailOp, back.compareOp);
-        m_vkd->vkCmdSetStencilCompareMask(m_execBuffer,
+        m_vkd->vkCmdSetStencilCompareMask(getExecBuffer(),
           VK_STENCIL_FACE_BACK_BIT, back.compareMask);
-        m_vkd->vkCmdSetStencilWriteMask(m_execBuffer,
+        m_vkd->vkCmdSetStencilWriteMask(getExecBuffer(),
           VK_STENCIL_FACE_BACK_BIT, back.writeMask);
       } else {
-        m_vkd->vkCmdSetStencilOp(m_execBuffer,
+        m_vkd->vkCmdSetStencilOp(getExecBuffer(),
           VK_STENCIL_FACE_FRONT_AND_BACK,
           VK_STENCIL_OP_KEEP, VK_STENCIL_OP_KEEP,
           VK_STENCIL_OP_KEEP, VK_COMPARE_OP_ALWAYS);
-        m_vkd->vkCmdSetStencilCompareMask(m_execBuffer,
+        m_vkd->vkCmdSetStencilCompareMask(getExecBuffer(),
           VK_STENCIL_FACE_FRONT_AND_BACK, 0x0);
-        m_vkd->vkCmdSetStencilWriteMask(m_execBuffer,
+        m_vkd->vkCmdSetStencilWriteMask(getExecBuffer(),
           VK_STENCIL_FACE_FRONT_AND_BACK, 0x0);
       }
     }
@@ -764,7 +839,7 @@ namespace dxvk {
     void cmdSetStencilReference(
             VkStencilFaceFlags      faceMask,
             uint32_t                reference) {
-      m_vkd->vkCmdSetStencilReference(m_execBuffer,
+      m_vkd->vkCmdSetStencilReference(getExecBuffer(),
         faceMask, reference);
     }
     
@@ -773,7 +848,7 @@ namespace dxvk {
             uint32_t                viewportCount,
       const VkViewport*             viewports) {
       m_vkd->vkCmdSetViewportWithCount(
-        m_execBuffer, viewportCount, viewports);
+        getExecBuffer(), viewportCount, viewports);
     }
 
 
@@ -781,7 +856,7 @@ namespace dxvk {
             VkPipelineStageFlagBits2 pipelineStage,
             VkQueryPool             queryPool,
             uint32_t                query) {
-      m_vkd->vkCmdWriteTimestamp2(m_execBuffer,
+      m_vkd->vkCmdWriteTimestamp2(getExecBuffer(),
         pipelineStage, queryPool, query);
     }
     
@@ -823,6 +898,7 @@ namespace dxvk {
     vk::PresenterSync   m_wsiSemaphores = { };
 
     DxvkCmdBufferFlags  m_cmdBuffersUsed;
+    bool                m_execBufferRecorded = false;
     DxvkLifetimeTracker m_resources;
     DxvkSignalTracker   m_signalTracker;
     DxvkGpuEventTracker m_gpuEventTracker;
@@ -840,8 +916,16 @@ namespace dxvk {
 
     std::vector<DxvkGraphicsPipeline*> m_pipelines;
 
-    VkCommandBuffer getCmdBuffer(DxvkCmdBuffer cmdBuffer) const {
-      if (cmdBuffer == DxvkCmdBuffer::ExecBuffer) return m_execBuffer;
+    DxvkSparseBindSubmission        m_bindSubmission;
+    std::vector<Rc<DxvkSparsePage>> m_sparsePages;
+
+    VkCommandBuffer getExecBuffer() {
+      m_execBufferRecorded = true;
+      return m_execBuffer;
+    }
+
+    VkCommandBuffer getCmdBuffer(DxvkCmdBuffer cmdBuffer) {
+      if (cmdBuffer == DxvkCmdBuffer::ExecBuffer) return getExecBuffer();
       if (cmdBuffer == DxvkCmdBuffer::InitBuffer) return m_initBuffer;
       if (cmdBuffer == DxvkCmdBuffer::SdmaBuffer) return m_sdmaBuffer;
       return VK_NULL_HANDLE;
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <vector>
 #include <utility>
@@ -110,10 +111,11 @@ namespace dxvk {
   Rc<DxvkCommandList> DxvkContext::endRecording() {
     this->spillRenderPass(true);
     this->flushSharedImages();
+    this->flushImageUploads();
 
     m_sdmaBarriers.recordCommands(m_cmd);
     m_initBarriers.recordCommands(m_cmd);
-    m_execBarriers.recordCommands(m_cmd);
+    this->flushBarriers();
 
     if (m_descriptorPool->shouldSubmit(false)) {
       m_cmd->trackDescriptorPool(m_descriptorPool, m_descriptorManager);
@@ -143,11 +145,16 @@ namespace dxvk {
   
   
   void DxvkContext::beginQuery(const Rc<DxvkGpuQuery>& query) {
+    // Clears issued before the query must not be counted by it
+    this->flushComputeClears();
+
     m_queryManager.enableQuery(m_cmd, query);
   }
 
 
   void DxvkContext::endQuery(const Rc<DxvkGpuQuery>& query) {
+    this->flushComputeClears();
+
     m_queryManager.disableQuery(m_cmd, query);
   }
   
@@ -198,7 +205,7 @@ namespace dxvk {
       this->prepareImage(image, subresources);
 
       if (m_execBarriers.isImageDirty(image, subresources, DxvkAccess::Write))
-        m_execBarriers.recordCommands(m_cmd);
+        this->flushBarriers();
 
       m_execBarriers.accessImage(image, subresources,
         image->info().layout,
@@ -226,7 +233,7 @@ namespace dxvk {
       this->spillRenderPass(true);
     
       if (m_execBarriers.isBufferDirty(bufferSlice, DxvkAccess::Write))
-        m_execBarriers.recordCommands(m_cmd);
+        this->flushBarriers();
     }
 
     DxvkCmdBuffer cmdBuffer = replaceBuffer
@@ -267,7 +274,6 @@ namespace dxvk {
           VkDeviceSize          length,
           VkClearColorValue     value) {
     this->spillRenderPass(true);
-    this->invalidateState();
 
     // The view range might have been invalidated, so
     // we need to make sure the handle is up to date
@@ -276,7 +282,7 @@ namespace dxvk {
     auto bufferSlice = bufferView->getSliceHandle();
 
     if (m_execBarriers.isBufferDirty(bufferSlice, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
     
     // Query pipeline objects to use for this clear operation
     DxvkMetaClearPipeline pipeInfo = m_common->metaClear().getClearBufferPipeline(
@@ -305,21 +311,8 @@ namespace dxvk {
     VkExtent3D workgroups = util::computeBlockCount(
       pushArgs.extent, pipeInfo.workgroupSize);
     
-    m_cmd->cmdBindPipeline(
-      VK_PIPELINE_BIND_POINT_COMPUTE,
-      pipeInfo.pipeline);
-    m_cmd->cmdBindDescriptorSet(
-      VK_PIPELINE_BIND_POINT_COMPUTE,
-      pipeInfo.pipeLayout, descriptorSet,
-      0, nullptr);
-    m_cmd->cmdPushConstants(
-      pipeInfo.pipeLayout,
-      VK_SHADER_STAGE_COMPUTE_BIT,
-      0, sizeof(pushArgs), &pushArgs);
-    m_cmd->cmdDispatch(
-      workgroups.width,
-      workgroups.height,
-      workgroups.depth);
+    this->deferComputeClear(pipeInfo,
+      descriptorSet, pushArgs, workgroups);
     
     m_execBarriers.accessBuffer(bufferSlice,
       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
@@ -426,7 +419,7 @@ namespace dxvk {
 
       if (m_execBarriers.isBufferDirty(srcSlice, DxvkAccess::Read)
        || m_execBarriers.isBufferDirty(dstSlice, DxvkAccess::Write))
-        m_execBarriers.recordCommands(m_cmd);
+        this->flushBarriers();
     }
 
     DxvkCmdBuffer cmdBuffer = replaceBuffer
@@ -520,7 +513,7 @@ namespace dxvk {
     
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isBufferDirty(srcSlice, DxvkAccess::Read))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
 
     // Initialize the image if the entire subresource is covered
     VkImageLayout dstImageLayoutInitial  = dstImage->info().layout;
@@ -691,7 +684,7 @@ namespace dxvk {
     
     if (m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isBufferDirty(dstSlice, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
 
     // Select a suitable image layout for the transfer op
     VkImageLayout srcImageLayoutTransfer = srcImage->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
@@ -783,7 +776,7 @@ namespace dxvk {
     auto subresourceRange = vk::makeSubresourceRange(srcSubresource);
 
     if (m_execBarriers.isImageDirty(srcImage, subresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
     
     if (srcImage->info().layout != layout) {
       m_execAcquires.accessImage(
@@ -865,7 +858,7 @@ namespace dxvk {
 
     if (m_execBarriers.isBufferDirty(dstBufferSlice, DxvkAccess::Write)
      || m_execBarriers.isBufferDirty(srcBufferSlice, DxvkAccess::Read))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
 
     // We'll use texel buffer views with an appropriately
     // sized integer format to perform the copy
@@ -1032,7 +1025,7 @@ namespace dxvk {
 
     if (m_execBarriers.isBufferDirty(srcBuffer->getSliceHandle(), DxvkAccess::Read)
      || m_execBarriers.isImageDirty(dstImage, vk::makeSubresourceRange(dstSubresource), DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
     
     // Retrieve compute pipeline for the given format
     auto pipeInfo = m_common->metaPack().getUnpackPipeline(dstImage->info().format, format);
@@ -1158,7 +1151,7 @@ namespace dxvk {
       VK_PIPELINE_STAGE_TRANSFER_BIT,
       VK_ACCESS_TRANSFER_WRITE_BIT);
 
-    m_execBarriers.recordCommands(m_cmd);
+    this->flushBarriers();
 
     // Copy temporary buffer data to depth-stencil image
     VkImageSubresourceLayers dstSubresourceD = dstSubresource;
@@ -1207,11 +1200,63 @@ namespace dxvk {
   }
 
 
+  void DxvkContext::copySparsePagesToBuffer(
+    const Rc<DxvkBuffer>&       dstBuffer,
+          VkDeviceSize          dstOffset,
+    const Rc<DxvkBuffer>&       srcBuffer,
+          uint32_t              pageCount,
+    const uint32_t*             pages) {
+    this->copySparseBufferPages<true>(
+      srcBuffer, pageCount, pages,
+      dstBuffer, dstOffset);
+  }
+
+
+  void DxvkContext::copySparsePagesToBuffer(
+    const Rc<DxvkBuffer>&       dstBuffer,
+          VkDeviceSize          dstOffset,
+    const Rc<DxvkImage>&        srcImage,
+          uint32_t              pageCount,
+    const uint32_t*             pages) {
+    this->copySparseImagePages<true>(
+      srcImage, pageCount, pages,
+      dstBuffer, dstOffset);
+  }
+
+
+  void DxvkContext::copySparsePagesFromBuffer(
+    const Rc<DxvkBuffer>&       dstBuffer,
+          uint32_t              pageCount,
+    const uint32_t*             pages,
+    const Rc<DxvkBuffer>&       srcBuffer,
+          VkDeviceSize          srcOffset) {
+    this->copySparseBufferPages<false>(
+      dstBuffer, pageCount, pages,
+      srcBuffer, srcOffset);
+  }
+
+
+  void DxvkContext::copySparsePagesFromBuffer(
+    const Rc<DxvkImage>&        dstImage,
+          uint32_t              pageCount,
+    const uint32_t*             pages,
+    const Rc<DxvkBuffer>&       srcBuffer,
+          VkDeviceSize          srcOffset) {
+    this->copySparseImagePages<false>(
+      dstImage, pageCount, pages,
+      srcBuffer, srcOffset);
+  }
+
+
   void DxvkContext::discardBuffer(
     const Rc<DxvkBuffer>&       buffer) {
     if (buffer->memFlags() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
       return;
 
+    // Sparse buffers keep their page mappings in the buffer itself
+    if (buffer->info().flags & VK_BUFFER_CREATE_SPARSE_BINDING_BIT)
+      return;
+
     if (m_execBarriers.isBufferDirty(buffer->getSliceHandle(), DxvkAccess::Write))
       this->invalidateBuffer(buffer, buffer->allocSlice());
   }
@@ -1259,7 +1304,7 @@ namespace dxvk {
       offset, sizeof(VkDispatchIndirectCommand));
 
     if (m_execBarriers.isBufferDirty(bufferSlice, DxvkAccess::Read))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
     
     if (this->commitComputeState()) {
       this->commitComputeBarriers<false>();
@@ -1418,13 +1463,18 @@ namespace dxvk {
     const Rc<DxvkBuffer>&           buffer) {
     auto slice = buffer->getSliceHandle();
 
-    m_cmd->cmdFillBuffer(DxvkCmdBuffer::InitBuffer,
+    // Use the transfer queue so that initialization does
+    // not compete with rendering work on the main queue
+    m_cmd->cmdFillBuffer(DxvkCmdBuffer::SdmaBuffer,
       slice.handle, slice.offset,
       dxvk::align(slice.length, 4), 0);
 
-    m_initBarriers.accessBuffer(slice,
+    m_sdmaBarriers.releaseBuffer(
+      m_initBarriers, slice,
+      m_device->queues().transfer.queueFamily,
       VK_PIPELINE_STAGE_TRANSFER_BIT,
       VK_ACCESS_TRANSFER_WRITE_BIT,
+      m_device->queues().graphics.queueFamily,
       buffer->info().stages,
       buffer->info().access);
 
@@ -1537,12 +1587,38 @@ namespace dxvk {
   }
   
   
+  void DxvkContext::initSparseImage(
+    const Rc<DxvkImage>&            image) {
+    m_initBarriers.accessImage(image,
+      image->getAvailableSubresources(),
+      VK_IMAGE_LAYOUT_UNDEFINED,
+      VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0,
+      image->info().layout,
+      image->info().stages,
+      image->info().access);
+
+    m_cmd->trackResource<DxvkAccess::None>(image);
+  }
+
+
   void DxvkContext::emitGraphicsBarrier() {
     if (!m_barrierControl.test(DxvkBarrierControl::IgnoreGraphicsBarriers))
       this->spillRenderPass(true);
   }
 
 
+  void DxvkContext::emitFullBarrier() {
+    this->spillRenderPass(true);
+    this->flushBarriers();
+
+    this->emitMemoryBarrier(
+      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+      VK_ACCESS_MEMORY_WRITE_BIT,
+      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+      VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+  }
+
+
   void DxvkContext::generateMipmaps(
     const Rc<DxvkImageView>&        imageView,
           VkFilter                  filter) {
@@ -1552,11 +1628,21 @@ namespace dxvk {
     this->spillRenderPass(false);
     this->invalidateState();
 
+    if (DxvkMetaMipGenComputePass::checkSupport(m_device.ptr(), imageView, filter))
+      this->generateMipmapsCs(imageView, filter);
+    else
+      this->generateMipmapsFb(imageView, filter);
+  }
+
+
+  void DxvkContext::generateMipmapsFb(
+    const Rc<DxvkImageView>&        imageView,
+          VkFilter                  filter) {
     // Create image views, etc.
     Rc<DxvkMetaMipGenRenderPass> mipGenerator = new DxvkMetaMipGenRenderPass(m_device->vkd(), imageView);
     
     if (m_execBarriers.isImageDirty(imageView->image(), imageView->imageSubresources(), DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
 
     VkImageLayout dstLayout = imageView->pickLayout(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
     VkImageLayout srcLayout = imageView->pickLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
@@ -1713,6 +1799,195 @@ namespace dxvk {
     m_cmd->trackResource<DxvkAccess::None>(mipGenerator);
     m_cmd->trackResource<DxvkAccess::Write>(imageView->image());
   }
+
+
+  void DxvkContext::generateMipmapsCs(
+    const Rc<DxvkImageView>&        imageView,
+          VkFilter                  filter) {
+    Rc<DxvkMetaMipGenComputePass> mipGenerator = new DxvkMetaMipGenComputePass(m_device->vkd(), imageView);
+
+    // Scratch memory stores one workgroup counter per layer, as well
+    // as the intermediate mip level read back by the last workgroup.
+    // It is only needed if more levels than the first workgroup pass
+    // can write are generated, and layers get processed in batches
+    // so that the scratch buffer size stays fixed.
+    uint32_t layerCount = imageView->info().numLayers;
+    uint32_t layerBatch = layerCount;
+
+    Rc<DxvkBuffer> scratchBuffer;
+
+    DxvkBufferSliceHandle bufferSlice = { };
+    DxvkBufferSliceHandle counterSlice = { };
+    DxvkBufferSliceHandle scratchSlice = { };
+
+    if (mipGenerator->needsScratch()) {
+      layerBatch = std::min(layerCount, DxvkMetaMipGenComputePass::MaxScratchLayers);
+
+      VkDeviceSize counterSize = align<VkDeviceSize>(sizeof(uint32_t) * DxvkMetaMipGenComputePass::MaxScratchLayers, 256);
+      VkDeviceSize scratchSize = sizeof(float) * 4 * DxvkMetaMipGenComputePass::MaxScratchLayers
+        * DxvkMetaMipGenComputePass::MidSize
+        * DxvkMetaMipGenComputePass::MidSize;
+
+      scratchBuffer = createMipGenScratchBuffer(counterSize + scratchSize);
+
+      bufferSlice = scratchBuffer->getSliceHandle(0, counterSize + scratchSize);
+      counterSlice = scratchBuffer->getSliceHandle(0, counterSize);
+      scratchSlice = scratchBuffer->getSliceHandle(counterSize, scratchSize);
+    }
+
+    if (m_execBarriers.isImageDirty(imageView->image(), imageView->imageSubresources(), DxvkAccess::Write)
+     || (scratchBuffer != nullptr && m_execBarriers.isBufferDirty(bufferSlice, DxvkAccess::Write)))
+      this->flushBarriers();
+
+    VkImageSubresourceRange srcSubresources = imageView->imageSubresources();
+    srcSubresources.levelCount = 1;
+
+    VkImageSubresourceRange dstSubresources = imageView->imageSubresources();
+    dstSubresources.baseMipLevel += 1;
+    dstSubresources.levelCount -= 1;
+
+    VkImageLayout srcLayout = imageView->pickLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    VkImageLayout dstLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    if (imageView->imageInfo().layout != srcLayout) {
+      m_execAcquires.accessImage(imageView->image(), srcSubresources,
+        imageView->imageInfo().layout,
+        imageView->imageInfo().stages, 0,
+        srcLayout,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    m_execAcquires.accessImage(imageView->image(), dstSubresources,
+      VK_IMAGE_LAYOUT_UNDEFINED,
+      imageView->imageInfo().stages, 0,
+      dstLayout,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_ACCESS_SHADER_WRITE_BIT);
+
+    m_execAcquires.recordCommands(m_cmd);
+
+    // Levels that are not generated still need a valid
+    // descriptor, so just bind the last level to them
+    DxvkMetaMipGenPipeline pipeInfo = m_common->metaMipGen().getPipeline();
+
+    std::array<VkDescriptorImageInfo, DxvkMetaMipGenComputePass::MaxLevels + 1> imageDescriptors;
+    imageDescriptors[0].sampler     = m_common->metaBlit().getSampler(filter);
+    imageDescriptors[0].imageView   = mipGenerator->getSrcView();
+    imageDescriptors[0].imageLayout = srcLayout;
+
+    for (uint32_t i = 0; i < DxvkMetaMipGenComputePass::MaxLevels; i++) {
+      imageDescriptors[i + 1].sampler     = VK_NULL_HANDLE;
+      imageDescriptors[i + 1].imageView   = mipGenerator->getDstView(std::min(i, mipGenerator->getLevelCount() - 1));
+      imageDescriptors[i + 1].imageLayout = dstLayout;
+    }
+
+    // The shader does not access scratch memory at all if
+    // it is not needed, so use null descriptors in that case
+    std::array<VkDescriptorBufferInfo, 2> bufferDescriptors = {{
+      { VK_NULL_HANDLE, 0, VK_WHOLE_SIZE },
+      { VK_NULL_HANDLE, 0, VK_WHOLE_SIZE },
+    }};
+
+    if (scratchBuffer != nullptr) {
+      bufferDescriptors[0] = { counterSlice.handle, counterSlice.offset, counterSlice.length };
+      bufferDescriptors[1] = { scratchSlice.handle, scratchSlice.offset, scratchSlice.length };
+    }
+
+    VkDescriptorSet descriptorSet = m_descriptorPool->alloc(pipeInfo.dsetLayout);
+
+    std::array<VkWriteDescriptorSet, 4> descriptorWrites = {{
+      { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, descriptorSet, 0, 0, 1,
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &imageDescriptors[0] },
+      { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, descriptorSet, 1, 0, DxvkMetaMipGenComputePass::MaxLevels,
+        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &imageDescriptors[1] },
+      { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, descriptorSet, 2, 0, 1,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &bufferDescriptors[0] },
+      { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, descriptorSet, 3, 0, 1,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &bufferDescriptors[1] },
+    }};
+
+    m_cmd->updateDescriptorSets(descriptorWrites.size(), descriptorWrites.data());
+
+    DxvkMetaMipGenPushConstants pushConstants = { };
+    pushConstants.srcExtent = { imageView->mipLevelExtent(0).width, imageView->mipLevelExtent(0).height };
+    pushConstants.mipCount  = mipGenerator->getLevelCount();
+
+    m_cmd->cmdBindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, pipeInfo.pipeHandle);
+    m_cmd->cmdBindDescriptorSet(VK_PIPELINE_BIND_POINT_COMPUTE,
+      pipeInfo.pipeLayout, descriptorSet, 0, nullptr);
+
+    for (uint32_t i = 0; i < layerCount; i += layerBatch) {
+      uint32_t batchSize = std::min(layerCount - i, layerBatch);
+
+      if (scratchBuffer != nullptr) {
+        // Wait for the previous batch to finish using
+        // scratch memory before resetting the counters
+        if (i) {
+          m_execAcquires.accessBuffer(bufferSlice,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+          m_execAcquires.recordCommands(m_cmd);
+        }
+
+        m_cmd->cmdFillBuffer(DxvkCmdBuffer::ExecBuffer,
+          counterSlice.handle,
+          counterSlice.offset,
+          counterSlice.length, 0);
+
+        m_execAcquires.accessBuffer(counterSlice,
+          VK_PIPELINE_STAGE_TRANSFER_BIT,
+          VK_ACCESS_TRANSFER_WRITE_BIT,
+          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+          VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+        m_execAcquires.recordCommands(m_cmd);
+      }
+
+      pushConstants.layerOffset = i;
+
+      VkExtent3D workgroups = mipGenerator->computeWorkgroupCount(batchSize);
+
+      m_cmd->cmdPushConstants(pipeInfo.pipeLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(pushConstants),
+        &pushConstants);
+      m_cmd->cmdDispatch(
+        workgroups.width,
+        workgroups.height,
+        workgroups.depth);
+    }
+
+    m_execBarriers.accessImage(imageView->image(), srcSubresources,
+      srcLayout,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_ACCESS_SHADER_READ_BIT,
+      imageView->imageInfo().layout,
+      imageView->imageInfo().stages,
+      imageView->imageInfo().access);
+
+    m_execBarriers.accessImage(imageView->image(), dstSubresources,
+      dstLayout,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_ACCESS_SHADER_WRITE_BIT,
+      imageView->imageInfo().layout,
+      imageView->imageInfo().stages,
+      imageView->imageInfo().access);
+
+    if (scratchBuffer != nullptr) {
+      m_execBarriers.accessBuffer(bufferSlice,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        scratchBuffer->info().stages,
+        scratchBuffer->info().access);
+
+      m_cmd->trackResource<DxvkAccess::Write>(scratchBuffer);
+    }
+
+    m_cmd->trackResource<DxvkAccess::None>(mipGenerator);
+    m_cmd->trackResource<DxvkAccess::Write>(imageView->image());
+  }
   
   
   void DxvkContext::invalidateBuffer(
@@ -1845,7 +2120,7 @@ namespace dxvk {
     this->spillRenderPass(false);
     
     if (srcLayout != dstLayout) {
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
 
       m_execBarriers.accessImage(
         dstImage, dstSubresources,
@@ -1922,7 +2197,7 @@ namespace dxvk {
     
     if (attachmentIndex < 0) {
       if (m_execBarriers.isImageDirty(imageView->image(), imageView->imageSubresources(), DxvkAccess::Write))
-        m_execBarriers.recordCommands(m_cmd);
+        this->flushBarriers();
 
       // Set up a temporary render pass to execute the clear
       VkImageLayout imageLayout = ((clearAspects | discardAspects) & VK_IMAGE_ASPECT_COLOR_BIT)
@@ -2110,6 +2385,55 @@ namespace dxvk {
   }
 
 
+  void DxvkContext::updatePageTable(
+    const DxvkSparseBindInfo&       bindInfo) {
+    // Binds are executed before the command buffers of the
+    // current submission, so record any pending clears and
+    // barriers and submit previously recorded commands first.
+    // Consecutive page table updates do not record anything
+    // and end up in the same batch.
+    this->spillRenderPass(false);
+    this->flushBarriers();
+
+    if (m_cmd->hasCommands())
+      this->flushCommandList();
+
+    DxvkSparsePageTable* dstPageTable = bindInfo.dstResource->getSparsePageTable();
+    DxvkSparsePageTable* srcPageTable = nullptr;
+
+    if (bindInfo.srcResource != nullptr)
+      srcPageTable = bindInfo.srcResource->getSparsePageTable();
+
+    // Look up all source pages before modifying any mappings,
+    // since source and destination may be the same resource
+    std::vector<Rc<DxvkSparsePage>> pages(bindInfo.binds.size());
+
+    for (size_t i = 0; i < bindInfo.binds.size(); i++) {
+      const auto& bind = bindInfo.binds[i];
+
+      switch (bind.mode) {
+        case DxvkSparseBindMode::Null:
+          break;
+
+        case DxvkSparseBindMode::Bind:
+          pages[i] = bindInfo.srcAllocator->acquirePage(bind.srcPage);
+          break;
+
+        case DxvkSparseBindMode::Copy:
+          pages[i] = srcPageTable->getMapping(bind.srcPage);
+          break;
+      }
+    }
+
+    for (size_t i = 0; i < bindInfo.binds.size(); i++) {
+      dstPageTable->updateMapping(m_cmd.ptr(),
+        bindInfo.binds[i].dstPage, std::move(pages[i]));
+    }
+
+    m_cmd->trackResource<DxvkAccess::Write>(bindInfo.dstResource);
+  }
+
+
   void DxvkContext::updateBuffer(
     const Rc<DxvkBuffer>&           buffer,
           VkDeviceSize              offset,
@@ -2122,7 +2446,7 @@ namespace dxvk {
       this->spillRenderPass(true);
     
       if (m_execBarriers.isBufferDirty(bufferSlice, DxvkAccess::Write))
-        m_execBarriers.recordCommands(m_cmd);
+        this->flushBarriers();
     }
 
     DxvkCmdBuffer cmdBuffer = replaceBuffer
@@ -2250,7 +2574,10 @@ namespace dxvk {
       VK_PIPELINE_STAGE_TRANSFER_BIT,
       VK_ACCESS_TRANSFER_WRITE_BIT);
 
-    barriers->recordCommands(m_cmd);
+    // Transfer queue copies are deferred until submission,
+    // so the acquire barriers will be recorded at that point
+    if (cmdBuffer != DxvkCmdBuffer::SdmaBuffer)
+      barriers->recordCommands(m_cmd);
 
     this->copyImageHostData(cmdBuffer,
       image, subresources, imageOffset, imageExtent,
@@ -2483,6 +2810,7 @@ namespace dxvk {
   
   void DxvkContext::signalGpuEvent(const Rc<DxvkGpuEvent>& event) {
     this->spillRenderPass(true);
+    this->flushComputeClears();
     
     DxvkGpuEventHandle handle = m_common->eventPool().allocEvent();
 
@@ -2530,7 +2858,7 @@ namespace dxvk {
     m_execBarriers.accessMemory(srcStages, srcAccess,
       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
       VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
-    m_execBarriers.recordCommands(m_cmd);
+    this->flushBarriers();
 
     m_cmd->cmdLaunchCuKernel(nvxLaunchInfo);
 
@@ -2571,6 +2899,7 @@ namespace dxvk {
   
   
   void DxvkContext::writeTimestamp(const Rc<DxvkGpuQuery>& query) {
+    this->flushComputeClears();
     m_queryManager.writeTimestamp(m_cmd, query);
   }
 
@@ -2625,7 +2954,7 @@ namespace dxvk {
 
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
 
     bool srcIsDepthStencil = region.srcSubresource.aspectMask & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
 
@@ -2804,7 +3133,7 @@ namespace dxvk {
 
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
 
     // Prepare the two images for transfer ops if necessary
     auto dstLayout = dstImage->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
@@ -3009,10 +3338,16 @@ namespace dxvk {
         auto subresource = imageSubresource;
         subresource.aspectMask = aspect;
 
-        this->copyImageBufferData<true>(cmd,
-          image, subresource, imageOffset, imageExtent,
-          image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL),
-          stagingHandle, 0, 0);
+        if (cmd == DxvkCmdBuffer::SdmaBuffer) {
+          m_imageUploads.push_back({ image,
+            subresource, imageOffset, imageExtent,
+            stagingHandle });
+        } else {
+          this->copyImageBufferData<true>(cmd,
+            image, subresource, imageOffset, imageExtent,
+            image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL),
+            stagingHandle, 0, 0);
+        }
 
         layerData += blockCount.height * rowPitch;
 
@@ -3022,6 +3357,193 @@ namespace dxvk {
   }
 
 
+  template<bool ToBuffer>
+  void DxvkContext::copySparseBufferPages(
+    const Rc<DxvkBuffer>&       sparse,
+          uint32_t              pageCount,
+    const uint32_t*             pages,
+    const Rc<DxvkBuffer>&       buffer,
+          VkDeviceSize          bufferOffset) {
+    auto pageTable = sparse->getSparsePageTable();
+
+    if (!pageTable || !pageCount)
+      return;
+
+    this->spillRenderPass(true);
+
+    auto sparseSlice = sparse->getSliceHandle();
+    auto bufferSlice = buffer->getSliceHandle(bufferOffset, SparseMemoryPageSize * pageCount);
+
+    if (m_execBarriers.isBufferDirty(sparseSlice, ToBuffer ? DxvkAccess::Read : DxvkAccess::Write)
+     || m_execBarriers.isBufferDirty(bufferSlice, ToBuffer ? DxvkAccess::Write : DxvkAccess::Read))
+      this->flushBarriers();
+
+    small_vector<VkBufferCopy2, 16> regions;
+
+    for (uint32_t i = 0; i < pageCount; i++) {
+      auto pageInfo = pageTable->getPageInfo(pages[i]);
+
+      if (pageInfo.type != DxvkSparsePageType::Buffer)
+        continue;
+
+      VkDeviceSize sparseOffset = sparseSlice.offset + pageInfo.buffer.offset;
+      VkDeviceSize linearOffset = bufferSlice.offset + SparseMemoryPageSize * i;
+
+      VkBufferCopy2 copyRegion = { VK_STRUCTURE_TYPE_BUFFER_COPY_2 };
+      copyRegion.srcOffset = ToBuffer ? sparseOffset : linearOffset;
+      copyRegion.dstOffset = ToBuffer ? linearOffset : sparseOffset;
+      copyRegion.size      = pageInfo.buffer.length;
+      regions.push_back(copyRegion);
+    }
+
+    if (!regions.size())
+      return;
+
+    VkCopyBufferInfo2 copyInfo = { VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2 };
+    copyInfo.srcBuffer = ToBuffer ? sparseSlice.handle : bufferSlice.handle;
+    copyInfo.dstBuffer = ToBuffer ? bufferSlice.handle : sparseSlice.handle;
+    copyInfo.regionCount = regions.size();
+    copyInfo.pRegions = regions.data();
+
+    m_cmd->cmdCopyBuffer(DxvkCmdBuffer::ExecBuffer, &copyInfo);
+
+    m_execBarriers.accessBuffer(sparseSlice,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      ToBuffer ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_TRANSFER_WRITE_BIT,
+      sparse->info().stages,
+      sparse->info().access);
+
+    m_execBarriers.accessBuffer(bufferSlice,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      ToBuffer ? VK_ACCESS_TRANSFER_WRITE_BIT : VK_ACCESS_TRANSFER_READ_BIT,
+      buffer->info().stages,
+      buffer->info().access);
+
+    if (ToBuffer) {
+      m_cmd->trackResource<DxvkAccess::Write>(buffer);
+      m_cmd->trackResource<DxvkAccess::Read>(sparse);
+    } else {
+      m_cmd->trackResource<DxvkAccess::Write>(sparse);
+      m_cmd->trackResource<DxvkAccess::Read>(buffer);
+    }
+  }
+
+
+  template<bool ToBuffer>
+  void DxvkContext::copySparseImagePages(
+    const Rc<DxvkImage>&        sparse,
+          uint32_t              pageCount,
+    const uint32_t*             pages,
+    const Rc<DxvkBuffer>&       buffer,
+          VkDeviceSize          bufferOffset) {
+    auto pageTable = sparse->getSparsePageTable();
+
+    if (!pageTable || !pageCount)
+      return;
+
+    this->spillRenderPass(true);
+
+    auto formatInfo = sparse->formatInfo();
+    auto subresources = sparse->getAvailableSubresources();
+
+    this->prepareImage(sparse, subresources);
+
+    auto bufferSlice = buffer->getSliceHandle(bufferOffset, SparseMemoryPageSize * pageCount);
+
+    if (m_execBarriers.isImageDirty(sparse, subresources, DxvkAccess::Write)
+     || m_execBarriers.isBufferDirty(bufferSlice, ToBuffer ? DxvkAccess::Write : DxvkAccess::Read))
+      this->flushBarriers();
+
+    VkImageLayout transferLayout = sparse->pickLayout(ToBuffer
+      ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+      : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    VkAccessFlags transferAccess = ToBuffer
+      ? VK_ACCESS_TRANSFER_READ_BIT
+      : VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    m_execAcquires.accessImage(
+      sparse, subresources,
+      sparse->info().layout,
+      VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+      transferLayout,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      transferAccess);
+
+    m_execAcquires.recordCommands(m_cmd);
+
+    // Page data is laid out using the full page shape even if
+    // the page is clipped at the edge of the subresource, so
+    // use the page dimensions as row and slice alignment.
+    VkExtent3D pageBlocks = util::computeBlockCount(
+      pageTable->getProperties().pageRegionExtent,
+      formatInfo->blockSize);
+
+    VkDeviceSize rowPitch = pageBlocks.width * formatInfo->elementSize;
+    VkDeviceSize slicePitch = pageBlocks.height * rowPitch;
+
+    for (uint32_t i = 0; i < pageCount; i++) {
+      auto pageInfo = pageTable->getPageInfo(pages[i]);
+
+      // The mip tail layout is implementation-defined
+      // and cannot be expressed in terms of texels
+      if (pageInfo.type != DxvkSparsePageType::Image)
+        continue;
+
+      DxvkBufferSliceHandle pageSlice = bufferSlice;
+      pageSlice.offset += SparseMemoryPageSize * i;
+      pageSlice.length = SparseMemoryPageSize;
+
+      this->copyImageBufferData<!ToBuffer>(DxvkCmdBuffer::ExecBuffer,
+        sparse, vk::makeSubresourceLayers(pageInfo.image.subresource),
+        pageInfo.image.offset, pageInfo.image.extent, transferLayout,
+        pageSlice, rowPitch, slicePitch);
+    }
+
+    m_execBarriers.accessImage(
+      sparse, subresources,
+      transferLayout,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      transferAccess,
+      sparse->info().layout,
+      sparse->info().stages,
+      sparse->info().access);
+
+    m_execBarriers.accessBuffer(bufferSlice,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      ToBuffer ? VK_ACCESS_TRANSFER_WRITE_BIT : VK_ACCESS_TRANSFER_READ_BIT,
+      buffer->info().stages,
+      buffer->info().access);
+
+    if (ToBuffer) {
+      m_cmd->trackResource<DxvkAccess::Write>(buffer);
+      m_cmd->trackResource<DxvkAccess::Read>(sparse);
+    } else {
+      m_cmd->trackResource<DxvkAccess::Write>(sparse);
+      m_cmd->trackResource<DxvkAccess::Read>(buffer);
+    }
+  }
+
+
+  void DxvkContext::flushImageUploads() {
+    if (m_imageUploads.empty())
+      return;
+
+    // Transition all uploaded images in one go
+    // before recording the actual copy commands
+    m_sdmaAcquires.recordCommands(m_cmd);
+
+    for (const auto& upload : m_imageUploads) {
+      this->copyImageBufferData<true>(DxvkCmdBuffer::SdmaBuffer,
+        upload.image, upload.subresource, upload.offset, upload.extent,
+        upload.image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL),
+        upload.stagingSlice, 0, 0);
+    }
+
+    m_imageUploads.clear();
+  }
+
+
   void DxvkContext::clearImageViewFb(
     const Rc<DxvkImageView>&    imageView,
           VkOffset3D            offset,
@@ -3048,7 +3570,7 @@ namespace dxvk {
       this->spillRenderPass(false);
 
       if (m_execBarriers.isImageDirty(imageView->image(), imageView->imageSubresources(), DxvkAccess::Write))
-        m_execBarriers.recordCommands(m_cmd);
+        this->flushBarriers();
 
       clearLayout = (imageView->info().aspect & VK_IMAGE_ASPECT_COLOR_BIT)
         ? imageView->pickLayout(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL)
@@ -3147,13 +3669,12 @@ namespace dxvk {
           VkExtent3D            extent,
           VkClearValue          value) {
     this->spillRenderPass(false);
-    this->invalidateState();
     
     if (m_execBarriers.isImageDirty(
           imageView->image(),
           imageView->imageSubresources(),
           DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
     
     // Query pipeline objects to use for this clear operation
     DxvkMetaClearPipeline pipeInfo = m_common->metaClear().getClearImagePipeline(
@@ -3190,21 +3711,8 @@ namespace dxvk {
     else if (imageView->type() == VK_IMAGE_VIEW_TYPE_2D_ARRAY)
       workgroups.depth = imageView->subresources().layerCount;
     
-    m_cmd->cmdBindPipeline(
-      VK_PIPELINE_BIND_POINT_COMPUTE,
-      pipeInfo.pipeline);
-    m_cmd->cmdBindDescriptorSet(
-      VK_PIPELINE_BIND_POINT_COMPUTE,
-      pipeInfo.pipeLayout, descriptorSet,
-      0, nullptr);
-    m_cmd->cmdPushConstants(
-      pipeInfo.pipeLayout,
-      VK_SHADER_STAGE_COMPUTE_BIT,
-      0, sizeof(pushArgs), &pushArgs);
-    m_cmd->cmdDispatch(
-      workgroups.width,
-      workgroups.height,
-      workgroups.depth);
+    this->deferComputeClear(pipeInfo,
+      descriptorSet, pushArgs, workgroups);
     
     m_execBarriers.accessImage(
       imageView->image(),
@@ -3220,6 +3728,75 @@ namespace dxvk {
     m_cmd->trackResource<DxvkAccess::Write>(imageView->image());
   }
 
+
+  void DxvkContext::deferComputeClear(
+    const DxvkMetaClearPipeline& pipeInfo,
+          VkDescriptorSet       descriptorSet,
+    const DxvkMetaClearArgs&    pushArgs,
+          VkExtent3D            workgroups) {
+    // Callers emit pending barriers for the resource being cleared
+    // before queuing the clear, and then record the post-clear
+    // barrier right away. Any later access to the same resource
+    // will therefore flush the barrier set, and with it all pending
+    // clears, so queued clears never overlap and can be reordered.
+    auto& entry = m_computeClears.emplace_back();
+    entry.pipeline      = pipeInfo.pipeline;
+    entry.pipeLayout    = pipeInfo.pipeLayout;
+    entry.descriptorSet = descriptorSet;
+    entry.pushArgs      = pushArgs;
+    entry.workgroups    = workgroups;
+  }
+
+
+  void DxvkContext::flushComputeClears() {
+    if (m_computeClears.empty())
+      return;
+
+    // Group clears by pipeline so that each one is only bound once
+    std::sort(m_computeClears.begin(), m_computeClears.end(),
+      [] (const DxvkDeferredComputeClear& a, const DxvkDeferredComputeClear& b) {
+        return a.pipeline < b.pipeline;
+      });
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    uint32_t pipelineBinds = 0;
+
+    for (const auto& clear : m_computeClears) {
+      if (clear.pipeline != pipeline) {
+        pipeline = clear.pipeline;
+        pipelineBinds += 1;
+
+        m_cmd->cmdBindPipeline(
+          VK_PIPELINE_BIND_POINT_COMPUTE,
+          pipeline);
+      }
+
+      m_cmd->cmdBindDescriptorSet(
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        clear.pipeLayout, clear.descriptorSet,
+        0, nullptr);
+      m_cmd->cmdPushConstants(
+        clear.pipeLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(clear.pushArgs), &clear.pushArgs);
+      m_cmd->cmdDispatch(
+        clear.workgroups.width,
+        clear.workgroups.height,
+        clear.workgroups.depth);
+    }
+
+    // Count clears that did not need their own pipeline bind
+    m_cmd->addStatCtr(DxvkStatCounter::CmdClearsMerged,
+      m_computeClears.size() - pipelineBinds);
+
+    // Only the compute bind point is affected, so there is no
+    // need to unbind anything. Callers must not have committed
+    // any compute state for the current dispatch at this point.
+    m_flags.set(DxvkContextFlag::CpDirtyPipelineState);
+
+    m_computeClears.clear();
+  }
+
   
   void DxvkContext::copyImageHw(
     const Rc<DxvkImage>&        dstImage,
@@ -3236,7 +3813,7 @@ namespace dxvk {
 
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
 
     VkImageLayout dstImageLayout = dstImage->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
     VkImageLayout srcImageLayout = srcImage->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
@@ -3415,7 +3992,7 @@ namespace dxvk {
     
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
 
     // Flag used to determine whether we can do an UNDEFINED transition    
     bool doDiscard = dstImage->isFullSubresource(dstSubresource, extent);
@@ -3662,7 +4239,7 @@ namespace dxvk {
     
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
     
     // We only support resolving to the entire image
     // area, so we might as well discard its contents
@@ -3744,7 +4321,7 @@ namespace dxvk {
 
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
 
     // Transition both images to usable layouts if necessary. For the source image we
     // can be fairly leniet since writable layouts are allowed for resolve attachments.
@@ -3848,7 +4425,7 @@ namespace dxvk {
 
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
 
     // Discard the destination image if we're fully writing it,
     // and transition the image layout if necessary
@@ -4020,6 +4597,10 @@ namespace dxvk {
 
   void DxvkContext::startRenderPass() {
     if (!m_flags.test(DxvkContextFlag::GpRenderPassBound)) {
+      // Compute clears cannot be recorded inside a render pass
+      if (unlikely(!m_computeClears.empty()))
+        this->flushComputeClears();
+
       this->applyRenderTargetLoadLayouts();
       this->flushClears(true);
 
@@ -4082,13 +4663,13 @@ namespace dxvk {
       else
         this->transitionRenderTargetLayouts(false);
 
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
     } else if (!suspend) {
       // We may end a previously suspended render pass
       if (m_flags.test(DxvkContextFlag::GpRenderPassSuspended)) {
         m_flags.clr(DxvkContextFlag::GpRenderPassSuspended);
         this->transitionRenderTargetLayouts(false);
-        m_execBarriers.recordCommands(m_cmd);
+        this->flushBarriers();
       }
 
       // Execute deferred clears if necessary
@@ -4109,7 +4690,7 @@ namespace dxvk {
           attachment.view->image(),
           attachment.view->imageSubresources(),
           DxvkAccess::Write)) {
-        m_execBarriers.recordCommands(m_cmd);
+        this->flushBarriers();
         break;
       }
     }
@@ -4173,7 +4754,7 @@ namespace dxvk {
     // Unconditionally emit barriers here. We need to do this
     // even if there are no layout transitions, since we don't
     // track resource usage during render passes.
-    m_execBarriers.recordCommands(m_cmd);
+    this->flushBarriers();
   }
 
 
@@ -4329,7 +4910,7 @@ namespace dxvk {
     // since the backend expects images to be in the store layout after
     // a render pass instance. This is expected to be rare.
     if (m_execBarriers.hasResourceBarriers())
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriers();
   }
   
   
@@ -4645,6 +5226,18 @@ namespace dxvk {
   }
 
 
+  void DxvkContext::flushBarriers() {
+    // Pending clears must execute before their post-clear
+    // barriers are recorded. Draws and dispatches flush them
+    // before committing state, so this never happens while
+    // pipeline state for a draw or dispatch is being bound.
+    if (unlikely(!m_computeClears.empty()))
+      this->flushComputeClears();
+
+    m_execBarriers.recordCommands(m_cmd);
+  }
+
+
   void DxvkContext::invalidateState() {
     this->unbindComputePipeline();
     this->unbindGraphicsPipeline();
@@ -5336,6 +5929,11 @@ namespace dxvk {
   bool DxvkContext::commitComputeState() {
     this->spillRenderPass(false);
 
+    // Pending clears bind their own pipeline, so they
+    // must be recorded before any compute state is
+    if (unlikely(!m_computeClears.empty()))
+      this->flushComputeClears();
+
     if (m_flags.any(
       DxvkContextFlag::CpDirtyPipelineState,
       DxvkContextFlag::CpDirtySpecConstants)) {
@@ -5355,6 +5953,9 @@ namespace dxvk {
   
   template<bool Indexed, bool Indirect>
   bool DxvkContext::commitGraphicsState() {
+    if (unlikely(!m_computeClears.empty()))
+      this->flushComputeClears();
+
     if (m_flags.test(DxvkContextFlag::GpDirtyPipeline)) {
       if (unlikely(!this->updateGraphicsPipeline()))
         return false;
@@ -5474,7 +6075,7 @@ namespace dxvk {
         }
 
         if (requiresBarrier) {
-          m_execBarriers.recordCommands(m_cmd);
+          this->flushBarriers();
           return;
         }
       }
@@ -5762,6 +6363,10 @@ namespace dxvk {
     if (buffer->memFlags() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
       return false;
 
+    // Sparse buffers cannot be discarded without losing their page mappings
+    if (buffer->info().flags & VK_BUFFER_CREATE_SPARSE_BINDING_BIT)
+      return false;
+
     // Suspend the current render pass if transform feedback is active prior to
     // invalidating the buffer, since otherwise we may invalidate a bound buffer.
     if ((buffer->info().usage & VK_BUFFER_USAGE_TRANSFORM_FEEDBACK_COUNTER_BUFFER_BIT_EXT)
@@ -5816,6 +6421,27 @@ namespace dxvk {
   }
   
 
+  Rc<DxvkBuffer> DxvkContext::createMipGenScratchBuffer(
+          VkDeviceSize              size) {
+    if (m_mipGenScratchBuffer != nullptr && m_mipGenScratchBuffer->info().size >= size)
+      return m_mipGenScratchBuffer;
+
+    DxvkBufferCreateInfo bufInfo;
+    bufInfo.size    = align<VkDeviceSize>(size, 1 << 16);
+    bufInfo.usage   = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                    | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufInfo.stages  = VK_PIPELINE_STAGE_TRANSFER_BIT
+                    | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    bufInfo.access  = VK_ACCESS_TRANSFER_WRITE_BIT
+                    | VK_ACCESS_SHADER_READ_BIT
+                    | VK_ACCESS_SHADER_WRITE_BIT;
+
+    m_mipGenScratchBuffer = m_device->createBuffer(bufInfo,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    return m_mipGenScratchBuffer;
+  }
+
+
   void DxvkContext::resizeDescriptorArrays(
           uint32_t                  bindingCount) {
     m_descriptors.resize(bindingCount);
@@ -669,7 +669,80 @@ namespace dxvk {
             VkOffset2D            srcOffset,
             VkExtent2D            srcExtent,
             VkFormat              format);
-    
+
+    /**
+     * \brief Copies pages from a sparse buffer to a buffer
+     *
+     * Pages are written to consecutive 64k blocks
+     * in the destination buffer, in the given order.
+     * \param [in] dstBuffer Destination buffer
+     * \param [in] dstOffset Destination buffer offset
+     * \param [in] srcBuffer Sparse source buffer
+     * \param [in] pageCount Number of pages to copy
+     * \param [in] pages Page indices to copy
+     */
+    void copySparsePagesToBuffer(
+      const Rc<DxvkBuffer>&       dstBuffer,
+            VkDeviceSize          dstOffset,
+      const Rc<DxvkBuffer>&       srcBuffer,
+            uint32_t              pageCount,
+      const uint32_t*             pages);
+
+    /**
+     * \brief Copies pages from a sparse image to a buffer
+     *
+     * Pages are written to consecutive 64k blocks
+     * in the destination buffer, in the given order.
+     * Texels are laid out using the full page shape
+     * even for pages at the edge of a subresource.
+     * Mip tail pages are skipped.
+     * \param [in] dstBuffer Destination buffer
+     * \param [in] dstOffset Destination buffer offset
+     * \param [in] srcImage Sparse source image
+     * \param [in] pageCount Number of pages to copy
+     * \param [in] pages Page indices to copy
+     */
+    void copySparsePagesToBuffer(
+      const Rc<DxvkBuffer>&       dstBuffer,
+            VkDeviceSize          dstOffset,
+      const Rc<DxvkImage>&        srcImage,
+            uint32_t              pageCount,
+      const uint32_t*             pages);
+
+    /**
+     * \brief Copies pages from a buffer to a sparse buffer
+     *
+     * Reverse operation of \ref copySparsePagesToBuffer.
+     * \param [in] dstBuffer Sparse destination buffer
+     * \param [in] pageCount Number of pages to copy
+     * \param [in] pages Page indices to copy
+     * \param [in] srcBuffer Source buffer
+     * \param [in] srcOffset Source buffer offset
+     */
+    void copySparsePagesFromBuffer(
+      const Rc<DxvkBuffer>&       dstBuffer,
+            uint32_t              pageCount,
+      const uint32_t*             pages,
+      const Rc<DxvkBuffer>&       srcBuffer,
+            VkDeviceSize          srcOffset);
+
+    /**
+     * \brief Copies pages from a buffer to a sparse image
+     *
+     * Reverse operation of \ref copySparsePagesToBuffer.
+     * \param [in] dstImage Sparse destination image
+     * \param [in] pageCount Number of pages to copy
+     * \param [in] pages Page indices to copy
+     * \param [in] srcBuffer Source buffer
+     * \param [in] srcOffset Source buffer offset
+     */
+    void copySparsePagesFromBuffer(
+      const Rc<DxvkImage>&        dstImage,
+            uint32_t              pageCount,
+      const uint32_t*             pages,
+      const Rc<DxvkBuffer>&       srcBuffer,
+            VkDeviceSize          srcOffset);
+
     /**
      * \brief Discards a buffer
      * 
@@ -829,11 +902,23 @@ namespace dxvk {
      */
     void emitGraphicsBarrier();
 
+    /**
+     * \brief Emits full memory barrier
+     *
+     * Makes all prior writes visible to all subsequent commands.
+     * Needed when resources alias the same memory, e.g. tiled
+     * resources mapped to the same tile pool pages, since
+     * barrier tracking only works on a per-resource basis.
+     */
+    void emitFullBarrier();
+
     /**
      * \brief Generates mip maps
      * 
-     * Uses blitting to generate lower mip levels from
-     * the top-most mip level passed to this method.
+     * Generates lower mip levels from the top-most mip level
+     * passed to this method. Uses a single compute dispatch
+     * if the image supports storage access with the given
+     * view format, and falls back to blitting otherwise.
      * \param [in] imageView The image to generate mips for
      * \param [in] filter The filter to use for generation
      */
@@ -844,8 +929,9 @@ namespace dxvk {
     /**
      * \brief Initializes a buffer
      *
-     * Clears the given buffer to zero. Only safe to call
-     * if the buffer is not currently in use by the GPU.
+     * Clears the given buffer to zero on the transfer queue.
+     * Only safe to call if the buffer is not currently in
+     * use by the GPU.
      * \param [in] buffer Buffer to clear
      */
     void initBuffer(
@@ -865,6 +951,16 @@ namespace dxvk {
       const Rc<DxvkImage>&            image,
       const VkImageSubresourceRange&  subresources,
             VkImageLayout             initialLayout);
+
+    /**
+     * \brief Initializes a sparse image
+     *
+     * Transitions the image into its default layout. Since
+     * no memory is bound to the image yet, it is not cleared.
+     * \param [in] image The image to initialize
+     */
+    void initSparseImage(
+      const Rc<DxvkImage>&            image);
     
     /**
      * \brief Invalidates a buffer's contents
@@ -950,6 +1046,18 @@ namespace dxvk {
             VkImageLayout             srcLayout,
             VkImageLayout             dstLayout);
     
+    /**
+     * \brief Updates page table of a sparse resource
+     *
+     * Binds are executed before any subsequently recorded
+     * commands, and after all previously recorded commands.
+     * All binds passed to consecutive calls without other
+     * commands in between are submitted as one batch.
+     * \param [in] bindInfo Sparse bind info
+     */
+    void updatePageTable(
+      const DxvkSparseBindInfo&       bindInfo);
+
     /**
      * \brief Updates a buffer
      * 
@@ -1002,6 +1110,9 @@ namespace dxvk {
      * \brief Uses transfer queue to initialize image
      * 
      * Only safe to use if the image is not in use by the GPU.
+     * Copies to color images are batched and recorded when
+     * the command list gets submitted, so that uploads to
+     * many subresources only need a single barrier.
      * \param [in] image The image to initialize
      * \param [in] subresources Subresources to initialize
      * \param [in] data Source data
@@ -1283,6 +1394,7 @@ namespace dxvk {
     
     Rc<DxvkCommandList>     m_cmd;
     Rc<DxvkBuffer>          m_zeroBuffer;
+    Rc<DxvkBuffer>          m_mipGenScratchBuffer;
 
     DxvkContextFlags        m_flags;
     DxvkContextState        m_state;
@@ -1311,6 +1423,8 @@ namespace dxvk {
     DxvkBindingSet<MaxNumResourceSlots>       m_rcTracked;
 
     std::vector<DxvkDeferredClear> m_deferredClears;
+    std::vector<DxvkDeferredComputeClear> m_computeClears;
+    std::vector<DxvkDeferredImageUpload>  m_imageUploads;
 
     std::vector<VkWriteDescriptorSet> m_descriptorWrites;
     std::vector<DxvkDescriptorInfo>   m_descriptors;
@@ -1354,6 +1468,32 @@ namespace dxvk {
             VkDeviceSize          rowPitch,
             VkDeviceSize          slicePitch);
 
+    template<bool ToBuffer>
+    void copySparseBufferPages(
+      const Rc<DxvkBuffer>&       sparse,
+            uint32_t              pageCount,
+      const uint32_t*             pages,
+      const Rc<DxvkBuffer>&       buffer,
+            VkDeviceSize          bufferOffset);
+
+    template<bool ToBuffer>
+    void copySparseImagePages(
+      const Rc<DxvkImage>&        sparse,
+            uint32_t              pageCount,
+      const uint32_t*             pages,
+      const Rc<DxvkBuffer>&       buffer,
+            VkDeviceSize          bufferOffset);
+
+    void flushImageUploads();
+
+    void generateMipmapsFb(
+      const Rc<DxvkImageView>&    imageView,
+            VkFilter              filter);
+
+    void generateMipmapsCs(
+      const Rc<DxvkImageView>&    imageView,
+            VkFilter              filter);
+
     void clearImageViewFb(
       const Rc<DxvkImageView>&    imageView,
             VkOffset3D            offset,
@@ -1366,6 +1506,14 @@ namespace dxvk {
             VkOffset3D            offset,
             VkExtent3D            extent,
             VkClearValue          value);
+
+    void deferComputeClear(
+      const DxvkMetaClearPipeline& pipeInfo,
+            VkDescriptorSet       descriptorSet,
+      const DxvkMetaClearArgs&    pushArgs,
+            VkExtent3D            workgroups);
+
+    void flushComputeClears();
     
     void copyImageHw(
       const Rc<DxvkImage>&        dstImage,
@@ -1484,6 +1632,8 @@ namespace dxvk {
 
     void invalidateState();
 
+    void flushBarriers();
+
     template<VkPipelineBindPoint BindPoint>
     void updateResourceBindings(const DxvkBindingLayoutObjects* layout);
 
@@ -1585,6 +1735,9 @@ namespace dxvk {
     Rc<DxvkBuffer> createZeroBuffer(
             VkDeviceSize              size);
 
+    Rc<DxvkBuffer> createMipGenScratchBuffer(
+            VkDeviceSize              size);
+
     void resizeDescriptorArrays(
             uint32_t                  bindingCount);
 
@@ -7,6 +7,7 @@
 #include "dxvk_graphics.h"
 #include "dxvk_image.h"
 #include "dxvk_limits.h"
+#include "dxvk_meta_clear.h"
 #include "dxvk_pipelayout.h"
 #include "dxvk_sampler.h"
 #include "dxvk_shader.h"
@@ -162,6 +163,41 @@ namespace dxvk {
     VkImageAspectFlags clearAspects;
     VkClearValue clearValue;
   };
+
+
+  /**
+   * \brief Deferred compute clear
+   *
+   * Stores everything needed to record a compute
+   * shader based clear. Descriptors are written at
+   * the time the clear is queued, so only the
+   * dispatch itself is deferred.
+   */
+  struct DxvkDeferredComputeClear {
+    VkPipeline        pipeline;
+    VkPipelineLayout  pipeLayout;
+    VkDescriptorSet   descriptorSet;
+    DxvkMetaClearArgs pushArgs;
+    VkExtent3D        workgroups;
+  };
+
+
+  /**
+   * \brief Deferred image upload
+   *
+   * Stores a transfer queue copy from staging memory to
+   * an image subresource. The source data is written at
+   * the time the upload is queued, but the copy itself
+   * is deferred so that all layout transitions for the
+   * uploaded images can be batched.
+   */
+  struct DxvkDeferredImageUpload {
+    Rc<DxvkImage>             image;
+    VkImageSubresourceLayers  subresource;
+    VkOffset3D                offset;
+    VkExtent3D                extent;
+    DxvkBufferSliceHandle     stagingSlice;
+  };
   
   
   /**
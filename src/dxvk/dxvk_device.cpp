@@ -180,6 +180,16 @@ namespace dxvk {
           VkMemoryPropertyFlags memoryType) {
     return new DxvkBuffer(this, createInfo, m_objects.memoryManager(), memoryType);
   }
+
+
+  Rc<DxvkBuffer> DxvkDevice::createPooledBuffer(
+    const DxvkBufferCreateInfo& createInfo,
+          VkMemoryPropertyFlags memoryType) {
+    if (!DxvkSharedBufferPool::isSupported(createInfo, memoryType))
+      return createBuffer(createInfo, memoryType);
+
+    return new DxvkBuffer(this, createInfo, m_objects.bufferPool(), memoryType);
+  }
   
   
   Rc<DxvkBufferView> DxvkDevice::createBufferView(
@@ -215,6 +225,11 @@ namespace dxvk {
   }
   
   
+  Rc<DxvkSparsePageAllocator> DxvkDevice::createSparsePageAllocator() {
+    return new DxvkSparsePageAllocator(m_objects.memoryManager());
+  }
+  
+  
   DxvkStatCounters DxvkDevice::getStatCounters() {
     DxvkPipelineCount pipe = m_objects.pipelineManager().getPipelineCount();
     
@@ -294,9 +309,21 @@ namespace dxvk {
     if (resource->isInUse(access)) {
       auto t0 = dxvk::high_resolution_clock::now();
 
-      m_submissionQueue.synchronizeUntil([resource, access] {
-        return !resource->isInUse(access);
-      });
+      // Wait for the GPU to complete the last submission that uses the
+      // resource, rather than for the command list to get released.
+      uint64_t trackId = resource->getTrackId(access);
+
+      if (trackId != DxvkResource::PendingTrackId)
+        m_submissionQueue.synchronizeTrackId(trackId);
+
+      // If the resource is used by a command list that has not been
+      // submitted yet, or if it got used again in the meantime, fall
+      // back to waiting until all uses of the resource are released.
+      if (trackId == DxvkResource::PendingTrackId || trackId != resource->getTrackId(access)) {
+        m_submissionQueue.synchronizeUntil([resource, access] {
+          return !resource->isInUse(access);
+        });
+      }
 
       auto t1 = dxvk::high_resolution_clock::now();
       auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
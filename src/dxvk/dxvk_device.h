@@ -22,6 +22,7 @@
 #include "dxvk_renderpass.h"
 #include "dxvk_sampler.h"
 #include "dxvk_shader.h"
+#include "dxvk_sparse.h"
 #include "dxvk_stats.h"
 #include "dxvk_unbound.h"
 #include "dxvk_marker.h"
@@ -326,6 +327,21 @@ namespace dxvk {
       const DxvkBufferCreateInfo& createInfo,
             VkMemoryPropertyFlags memoryType);
     
+    /**
+     * \brief Creates a pooled buffer object
+     *
+     * Small, frequently discarded buffers can suballocate all
+     * their slices from a shared pool instead of creating their
+     * own Vulkan buffers. Falls back to a regular buffer if the
+     * pool does not support the given buffer properties.
+     * \param [in] createInfo Buffer create info
+     * \param [in] memoryType Memory type flags
+     * \returns The buffer object
+     */
+    Rc<DxvkBuffer> createPooledBuffer(
+      const DxvkBufferCreateInfo& createInfo,
+            VkMemoryPropertyFlags memoryType);
+    
     /**
      * \brief Creates a buffer view
      * 
@@ -379,6 +395,12 @@ namespace dxvk {
     Rc<DxvkSampler> createSampler(
       const DxvkSamplerCreateInfo&  createInfo);
 
+    /**
+     * \brief Creates a sparse page allocator
+     * \returns Sparse page allocator
+     */
+    Rc<DxvkSparsePageAllocator> createSparsePageAllocator();
+
     /**
      * \brief Retrieves stat counters
      * 
@@ -472,6 +494,17 @@ namespace dxvk {
       return m_submissionQueue.pendingSubmissions();
     }
 
+    /**
+     * \brief Retrieves frame latency stats
+     *
+     * Used for latency-oriented frame pacing
+     * as well as for displaying latency info.
+     * \returns Frame latency stats
+     */
+    DxvkLatencyStats getLatencyStats() {
+      return m_submissionQueue.getLatencyStats();
+    }
+
     /**
      * \brief Increments a given stat counter
      *
@@ -60,6 +60,18 @@ namespace dxvk {
         "\n  Usage:           ", info.usage,
         "\n  Tiling:          ", info.tiling));
     }
+
+    // Memory for sparse images is bound page by page later
+    if (info.flags & VK_IMAGE_CREATE_SPARSE_BINDING_BIT) {
+      try {
+        m_sparsePageTable = DxvkSparsePageTable(device, this);
+      } catch (const DxvkError&) {
+        m_vkd->vkDestroyImage(m_vkd->device(), m_image.image, nullptr);
+        throw;
+      }
+
+      return;
+    }
     
     // Get memory requirements for the image. We may enforce strict
     // alignment on non-linear images in order not to violate the
@@ -142,7 +154,7 @@ namespace dxvk {
   DxvkImage::~DxvkImage() {
     // This is a bit of a hack to determine whether
     // the image is implementation-handled or not
-    if (m_image.memory.memory() != VK_NULL_HANDLE)
+    if (m_image.memory.memory() != VK_NULL_HANDLE || getSparsePageTable())
       m_vkd->vkDestroyImage(m_vkd->device(), m_image.image, nullptr);
   }
 
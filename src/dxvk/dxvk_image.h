@@ -4,6 +4,7 @@
 #include "dxvk_format.h"
 #include "dxvk_memory.h"
 #include "dxvk_resource.h"
+#include "dxvk_sparse.h"
 #include "dxvk_util.h"
 
 namespace dxvk {
@@ -329,6 +330,16 @@ namespace dxvk {
      * \returns The shared handle with the type given by DxvkSharedHandleInfo::type
      */
     HANDLE sharedHandle() const;
+
+    /**
+     * \brief Queries sparse page table
+     * \returns Page table, or \c nullptr for non-sparse images
+     */
+    DxvkSparsePageTable* getSparsePageTable() final {
+      return (m_info.flags & VK_IMAGE_CREATE_SPARSE_BINDING_BIT)
+        ? &m_sparsePageTable
+        : nullptr;
+    }
     
   private:
     
@@ -340,6 +351,8 @@ namespace dxvk {
     bool m_shared = false;
 
     small_vector<VkFormat, 4> m_viewFormats;
+
+    DxvkSparsePageTable   m_sparsePageTable;
     
     bool canShareImage(const VkImageCreateInfo&  createInfo, const DxvkSharedHandleInfo& sharingInfo) const;
 
@@ -6,6 +6,12 @@ namespace dxvk {
   DxvkLifetimeTracker::~DxvkLifetimeTracker() { }
   
   
+  void DxvkLifetimeTracker::setTrackId(uint64_t trackId) {
+    for (const auto& resource : m_resources)
+      resource.setTrackId(trackId);
+  }
+
+
   void DxvkLifetimeTracker::notify() {
     m_resources.clear();
   }
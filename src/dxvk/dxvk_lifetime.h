@@ -60,6 +60,15 @@ namespace dxvk {
       release();
     }
 
+    /**
+     * \brief Sets tracking ID of the resource
+     * \param [in] trackId Submission tracking ID
+     */
+    void setTrackId(uint64_t trackId) const {
+      if (m_resource)
+        m_resource->setTrackId(m_access, trackId);
+    }
+
   private:
 
     DxvkResource*   m_resource;
@@ -101,9 +110,18 @@ namespace dxvk {
      */
     template<DxvkAccess Access>
     void trackResource(DxvkResource* rc) {
+      rc->setTrackId(Access, DxvkResource::PendingTrackId);
       m_resources.emplace_back(rc, Access);
     }
 
+    /**
+     * \brief Sets tracking ID of all resources
+     *
+     * Called when the command list gets submitted.
+     * \param [in] trackId Submission tracking ID
+     */
+    void setTrackId(uint64_t trackId);
+
     /**
      * \brief Releases resources
      *
@@ -2,6 +2,7 @@
 
 #include "dxvk_device.h"
 #include "dxvk_memory.h"
+#include "dxvk_sparse.h"
 
 namespace dxvk {
   
@@ -202,6 +203,9 @@ namespace dxvk {
       m_memTypes[i].memType    = m_memProps.memoryTypes[i];
       m_memTypes[i].memTypeId  = i;
     }
+
+    if (device->features().core.features.sparseBinding)
+      m_sparseMemoryTypes = determineSparseMemoryTypes(device);
   }
   
   
@@ -289,6 +293,22 @@ namespace dxvk {
   }
   
   
+  DxvkMemory DxvkMemoryAllocator::allocSparsePage() {
+    VkMemoryRequirements req = { };
+    req.size            = SparseMemoryPageSize;
+    req.alignment       = SparseMemoryPageSize;
+    req.memoryTypeBits  = m_sparseMemoryTypes;
+
+    VkMemoryDedicatedRequirements dedAllocReq = { VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS };
+    VkMemoryDedicatedAllocateInfo dedAllocInfo = { VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO };
+
+    DxvkMemoryFlags hints(DxvkMemoryFlag::GpuReadable);
+
+    return this->alloc(&req, dedAllocReq, dedAllocInfo,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, hints);
+  }
+
+
   DxvkMemory DxvkMemoryAllocator::tryAlloc(
     const VkMemoryRequirements*             req,
     const VkMemoryDedicatedAllocateInfo*    dedAllocInfo,
@@ -532,4 +552,85 @@ namespace dxvk {
     }
   }
 
+
+
+  uint32_t DxvkMemoryAllocator::determineSparseMemoryTypes(
+    const DxvkDevice*           device) const {
+    auto vk = device->vkd();
+    uint32_t typeMask = ~0u;
+
+    // Create a dummy sparse buffer and image with all relevant usage
+    // flags in order to determine which memory types pages can use
+    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufferInfo.flags = VK_BUFFER_CREATE_SPARSE_BINDING_BIT
+                     | VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT
+                     | VK_BUFFER_CREATE_SPARSE_ALIASED_BIT;
+    bufferInfo.size  = SparseMemoryPageSize;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+                     | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+                     | VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT
+                     | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT
+                     | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+                     | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                     | VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+                     | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+                     | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+
+    if (device->features().core.features.sparseResidencyBuffer
+     && device->features().core.features.sparseResidencyAliased
+     && vk->vkCreateBuffer(vk->device(), &bufferInfo, nullptr, &buffer) == VK_SUCCESS) {
+      VkMemoryRequirements memReq = { };
+      vk->vkGetBufferMemoryRequirements(vk->device(), buffer, &memReq);
+      vk->vkDestroyBuffer(vk->device(), buffer, nullptr);
+
+      typeMask &= memReq.memoryTypeBits;
+    }
+
+    VkImageCreateInfo imageInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageInfo.flags         = VK_IMAGE_CREATE_SPARSE_BINDING_BIT
+                            | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT
+                            | VK_IMAGE_CREATE_SPARSE_ALIASED_BIT;
+    imageInfo.imageType     = VK_IMAGE_TYPE_2D;
+    imageInfo.format        = VK_FORMAT_R8G8B8A8_UNORM;
+    imageInfo.extent        = { 256u, 256u, 1u };
+    imageInfo.mipLevels     = 1;
+    imageInfo.arrayLayers   = 1;
+    imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage         = VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+                            | VK_IMAGE_USAGE_TRANSFER_DST_BIT
+                            | VK_IMAGE_USAGE_SAMPLED_BIT
+                            | VK_IMAGE_USAGE_STORAGE_BIT
+                            | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    VkImage image = VK_NULL_HANDLE;
+
+    if (device->features().core.features.sparseResidencyImage2D
+     && device->features().core.features.sparseResidencyAliased
+     && vk->vkCreateImage(vk->device(), &imageInfo, nullptr, &image) == VK_SUCCESS) {
+      VkMemoryRequirements memReq = { };
+      vk->vkGetImageMemoryRequirements(vk->device(), image, &memReq);
+      vk->vkDestroyImage(vk->device(), image, nullptr);
+
+      typeMask &= memReq.memoryTypeBits;
+    }
+
+    // Only use device-local memory types for pages
+    uint32_t result = 0;
+
+    for (uint32_t i = 0; i < m_memProps.memoryTypeCount; i++) {
+      if ((typeMask & (1u << i))
+       && (m_memProps.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+        result |= 1u << i;
+    }
+
+    Logger::info(str::format("Memory: Sparse page memory types: 0x", std::hex, result));
+    return result;
+  }
+
 }
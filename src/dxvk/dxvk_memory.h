@@ -318,6 +318,16 @@ namespace dxvk {
             VkMemoryPropertyFlags             flags,
             DxvkMemoryFlags                   hints);
     
+    /**
+     * \brief Allocates memory for a sparse page
+     * 
+     * Pages are allocated from memory types that are
+     * compatible with all sparse resources, so that
+     * any page can be bound to any sparse resource.
+     * \returns Allocated memory slice
+     */
+    DxvkMemory allocSparsePage();
+    
     /**
      * \brief Queries memory stats
      * 
@@ -341,6 +351,8 @@ namespace dxvk {
     std::array<DxvkMemoryHeap, VK_MAX_MEMORY_HEAPS> m_memHeaps;
     std::array<DxvkMemoryType, VK_MAX_MEMORY_TYPES> m_memTypes;
 
+    uint32_t                                        m_sparseMemoryTypes = 0;
+
     DxvkMemory tryAlloc(
       const VkMemoryRequirements*             req,
       const VkMemoryDedicatedAllocateInfo*    dedAllocInfo,
@@ -390,6 +402,9 @@ namespace dxvk {
     void freeEmptyChunks(
       const DxvkMemoryHeap*       heap);
 
+    uint32_t determineSparseMemoryTypes(
+      const DxvkDevice*           device) const;
+
   };
   
 }
@@ -1,5 +1,8 @@
+#include "dxvk_device.h"
 #include "dxvk_meta_mipgen.h"
 
+#include <dxvk_mipgen_image2darr_f.h>
+
 namespace dxvk {
 
   DxvkMetaMipGenRenderPass::DxvkMetaMipGenRenderPass(
@@ -94,4 +97,213 @@ namespace dxvk {
     return result;
   }
   
+
+
+  DxvkMetaMipGenComputePass::DxvkMetaMipGenComputePass(
+    const Rc<vk::DeviceFn>&   vkd,
+    const Rc<DxvkImageView>&  view)
+  : m_vkd(vkd), m_view(view) {
+    m_srcView = createView(0, VK_IMAGE_USAGE_SAMPLED_BIT);
+    m_dstViews.resize(view->info().numLevels - 1);
+
+    for (uint32_t i = 0; i < m_dstViews.size(); i++)
+      m_dstViews[i] = createView(i + 1, VK_IMAGE_USAGE_STORAGE_BIT);
+  }
+
+
+  DxvkMetaMipGenComputePass::~DxvkMetaMipGenComputePass() {
+    m_vkd->vkDestroyImageView(m_vkd->device(), m_srcView, nullptr);
+
+    for (auto view : m_dstViews)
+      m_vkd->vkDestroyImageView(m_vkd->device(), view, nullptr);
+  }
+
+
+  VkExtent3D DxvkMetaMipGenComputePass::computeWorkgroupCount(
+          uint32_t            layerCount) const {
+    VkExtent3D extent = m_view->mipLevelExtent(1);
+    extent.depth = layerCount;
+
+    return util::computeBlockCount(extent, VkExtent3D { TileSize, TileSize, 1u });
+  }
+
+
+  bool DxvkMetaMipGenComputePass::checkSupport(
+    const DxvkDevice*         device,
+    const Rc<DxvkImageView>&  view,
+          VkFilter            filter) {
+    if (!device->features().core.features.shaderStorageImageWriteWithoutFormat)
+      return false;
+
+    // The shader uses a box filter for all levels but the first,
+    // which is only a good approximation of linear filtering
+    if (filter != VK_FILTER_LINEAR)
+      return false;
+
+    const DxvkImageCreateInfo& imageInfo = view->imageInfo();
+
+    if (imageInfo.type != VK_IMAGE_TYPE_2D
+     || imageInfo.tiling != VK_IMAGE_TILING_OPTIMAL
+     || imageInfo.sampleCount != VK_SAMPLE_COUNT_1_BIT
+     || !(imageInfo.usage & VK_IMAGE_USAGE_STORAGE_BIT))
+      return false;
+
+    VkExtent3D extent = view->mipLevelExtent(0);
+
+    if (extent.width > MaxExtent || extent.height > MaxExtent
+     || view->info().numLevels - 1 > MaxLevels)
+      return false;
+
+    // The shader reduces 2x2 blocks, which only matches the bilinear
+    // filter used by the render pass path if every source level used
+    // to generate another level has an even size, or a size of one.
+    for (uint32_t i = 0; i < view->info().numLevels - 1; i++) {
+      VkExtent3D levelExtent = view->mipLevelExtent(i);
+
+      if (((levelExtent.width  & 1) && levelExtent.width  != 1)
+       || ((levelExtent.height & 1) && levelExtent.height != 1))
+        return false;
+    }
+
+    auto formatInfo = lookupFormatInfo(view->info().format);
+
+    if (formatInfo->aspectMask != VK_IMAGE_ASPECT_COLOR_BIT
+     || formatInfo->flags.any(DxvkFormatFlag::SampledUInt, DxvkFormatFlag::SampledSInt, DxvkFormatFlag::MultiPlane))
+      return false;
+
+    VkFormatFeatureFlags2 features = VK_FORMAT_FEATURE_2_STORAGE_IMAGE_BIT
+                                   | VK_FORMAT_FEATURE_2_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+    return (device->getFormatFeatures(view->info().format).optimal & features) == features;
+  }
+
+
+  VkImageUsageFlags DxvkMetaMipGenComputePass::getImageUsage(
+    const DxvkDevice*         device,
+          VkFormat            format,
+          VkImageTiling       tiling) {
+    if (!device->config().enableComputeMipGen
+     || tiling != VK_IMAGE_TILING_OPTIMAL)
+      return 0;
+
+    // Mip generation is only supported for float formats
+    auto formatInfo = lookupFormatInfo(format);
+
+    if (formatInfo->aspectMask != VK_IMAGE_ASPECT_COLOR_BIT
+     || formatInfo->flags.any(DxvkFormatFlag::SampledUInt, DxvkFormatFlag::SampledSInt))
+      return 0;
+
+    DxvkFormatFeatures support = device->getFormatFeatures(format);
+
+    return (support.optimal & VK_FORMAT_FEATURE_2_STORAGE_IMAGE_BIT)
+      ? VK_IMAGE_USAGE_STORAGE_BIT
+      : 0;
+  }
+
+
+  VkImageView DxvkMetaMipGenComputePass::createView(
+          uint32_t            level,
+          VkImageUsageFlags   usage) const {
+    VkImageViewUsageCreateInfo usageInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO };
+    usageInfo.usage = usage;
+
+    VkImageViewCreateInfo viewInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO, &usageInfo };
+    viewInfo.image = m_view->imageHandle();
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = m_view->info().format;
+    viewInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel   = m_view->info().minLevel + level;
+    viewInfo.subresourceRange.levelCount     = 1;
+    viewInfo.subresourceRange.baseArrayLayer = m_view->info().minLayer;
+    viewInfo.subresourceRange.layerCount     = m_view->info().numLayers;
+
+    VkImageView result = VK_NULL_HANDLE;
+
+    if (m_vkd->vkCreateImageView(m_vkd->device(), &viewInfo, nullptr, &result) != VK_SUCCESS)
+      throw DxvkError("DxvkMetaMipGenComputePass: Failed to create image view");
+
+    return result;
+  }
+
+
+  DxvkMetaMipGenObjects::DxvkMetaMipGenObjects(const DxvkDevice* device)
+  : m_vkd(device->vkd()) {
+    m_dsetLayout = createDescriptorSetLayout();
+    m_pipeLayout = createPipelineLayout();
+    m_pipeline   = createPipeline();
+  }
+
+
+  DxvkMetaMipGenObjects::~DxvkMetaMipGenObjects() {
+    m_vkd->vkDestroyPipeline(m_vkd->device(), m_pipeline, nullptr);
+    m_vkd->vkDestroyPipelineLayout(m_vkd->device(), m_pipeLayout, nullptr);
+    m_vkd->vkDestroyDescriptorSetLayout(m_vkd->device(), m_dsetLayout, nullptr);
+  }
+
+
+  VkDescriptorSetLayout DxvkMetaMipGenObjects::createDescriptorSetLayout() const {
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings = {{
+      { 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+      { 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, DxvkMetaMipGenComputePass::MaxLevels, VK_SHADER_STAGE_COMPUTE_BIT },
+      { 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+      { 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+    }};
+
+    VkDescriptorSetLayoutCreateInfo info = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    info.bindingCount = bindings.size();
+    info.pBindings    = bindings.data();
+
+    VkDescriptorSetLayout result = VK_NULL_HANDLE;
+    if (m_vkd->vkCreateDescriptorSetLayout(m_vkd->device(), &info, nullptr, &result) != VK_SUCCESS)
+      throw DxvkError("DxvkMetaMipGenObjects: Failed to create descriptor set layout");
+    return result;
+  }
+
+
+  VkPipelineLayout DxvkMetaMipGenObjects::createPipelineLayout() const {
+    VkPushConstantRange pushRange = { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(DxvkMetaMipGenPushConstants) };
+
+    VkPipelineLayoutCreateInfo info = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    info.setLayoutCount         = 1;
+    info.pSetLayouts            = &m_dsetLayout;
+    info.pushConstantRangeCount = 1;
+    info.pPushConstantRanges    = &pushRange;
+
+    VkPipelineLayout result = VK_NULL_HANDLE;
+    if (m_vkd->vkCreatePipelineLayout(m_vkd->device(), &info, nullptr, &result) != VK_SUCCESS)
+      throw DxvkError("DxvkMetaMipGenObjects: Failed to create pipeline layout");
+    return result;
+  }
+
+
+  VkPipeline DxvkMetaMipGenObjects::createPipeline() const {
+    SpirvCodeBuffer code(dxvk_mipgen_image2darr_f);
+
+    VkShaderModuleCreateInfo shaderInfo = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    shaderInfo.codeSize = code.size();
+    shaderInfo.pCode    = code.data();
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    if (m_vkd->vkCreateShaderModule(m_vkd->device(), &shaderInfo, nullptr, &shaderModule) != VK_SUCCESS)
+      throw DxvkError("DxvkMetaMipGenObjects: Failed to create shader module");
+
+    VkComputePipelineCreateInfo info = { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    info.stage        = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+    info.stage.stage  = VK_SHADER_STAGE_COMPUTE_BIT;
+    info.stage.module = shaderModule;
+    info.stage.pName  = "main";
+    info.layout       = m_pipeLayout;
+    info.basePipelineIndex = -1;
+
+    VkPipeline result = VK_NULL_HANDLE;
+    VkResult status = m_vkd->vkCreateComputePipelines(
+      m_vkd->device(), VK_NULL_HANDLE, 1, &info, nullptr, &result);
+
+    m_vkd->vkDestroyShaderModule(m_vkd->device(), shaderModule, nullptr);
+
+    if (status != VK_SUCCESS)
+      throw DxvkError("DxvkMetaMipGenObjects: Failed to create compute pipeline");
+    return result;
+  }
+
 }
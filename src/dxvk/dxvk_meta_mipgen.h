@@ -5,6 +5,26 @@
 #include "dxvk_meta_blit.h"
 
 namespace dxvk {
+
+  class DxvkDevice;
+
+  /**
+   * \brief Compute mip generation push constants
+   */
+  struct DxvkMetaMipGenPushConstants {
+    VkExtent2D srcExtent;
+    uint32_t   mipCount;
+    uint32_t   layerOffset;
+  };
+
+  /**
+   * \brief Compute mip generation pipeline
+   */
+  struct DxvkMetaMipGenPipeline {
+    VkDescriptorSetLayout dsetLayout;
+    VkPipelineLayout      pipeLayout;
+    VkPipeline            pipeHandle;
+  };
   
   /**
    * \brief Mip map generation render pass
@@ -146,4 +166,171 @@ namespace dxvk {
     
   };
   
+
+
+  /**
+   * \brief Compute mip generation views
+   *
+   * Stores a sampled view of the top level, as well as
+   * one storage view per mip level to generate. Used with
+   * the single-pass compute mip generator, which can write
+   * up to \c MaxLevels levels within one dispatch.
+   */
+  class DxvkMetaMipGenComputePass : public DxvkResource {
+
+  public:
+
+    /// Maximum number of levels that can be generated
+    constexpr static uint32_t MaxLevels = 12;
+    /// Maximum width and height of the top level
+    constexpr static uint32_t MaxExtent = 4096;
+    /// Tile size within the first generated level
+    constexpr static uint32_t TileSize  = 32;
+    /// Size of the level passed to the last workgroup
+    constexpr static uint32_t MidSize   = 64;
+    /// Level count above which scratch memory is needed
+    constexpr static uint32_t MidLevel  = 6;
+    /// Maximum number of layers per dispatch using scratch memory
+    constexpr static uint32_t MaxScratchLayers = 16;
+
+    DxvkMetaMipGenComputePass(
+      const Rc<vk::DeviceFn>&   vkd,
+      const Rc<DxvkImageView>&  view);
+
+    ~DxvkMetaMipGenComputePass();
+
+    /**
+     * \brief Number of mip levels to generate
+     * \returns Number of levels below the top level
+     */
+    uint32_t getLevelCount() const {
+      return m_dstViews.size();
+    }
+
+    /**
+     * \brief Source image view
+     * \returns View of the top level, for sampling
+     */
+    VkImageView getSrcView() const {
+      return m_srcView;
+    }
+
+    /**
+     * \brief Destination image view
+     *
+     * \param [in] level Level index, starting at 0 for
+     *    the first level below the top level
+     * \returns Storage view for the given level
+     */
+    VkImageView getDstView(uint32_t level) const {
+      return m_dstViews.at(level);
+    }
+
+    /**
+     * \brief Checks whether scratch memory is needed
+     *
+     * Only the case where more than \c MidLevel levels
+     * are generated needs the intermediate level to be
+     * written to scratch memory.
+     * \returns \c true if scratch memory is needed
+     */
+    bool needsScratch() const {
+      return getLevelCount() > MidLevel;
+    }
+
+    /**
+     * \brief Computes workgroup count
+     *
+     * Each workgroup processes one tile of the top level.
+     * \param [in] layerCount Number of layers to process
+     * \returns Number of workgroups to dispatch
+     */
+    VkExtent3D computeWorkgroupCount(
+            uint32_t            layerCount) const;
+
+    /**
+     * \brief Checks whether the compute path can be used
+     *
+     * The compute path only supports 2D color images that
+     * can be bound as a storage image with the view format,
+     * and is limited in the size of the top level.
+     * \param [in] device The device
+     * \param [in] view View of the image to generate mips for
+     * \param [in] filter Filter used for mip generation
+     * \returns \c true if the compute path is supported
+     */
+    static bool checkSupport(
+      const DxvkDevice*         device,
+      const Rc<DxvkImageView>&  view,
+            VkFilter            filter);
+
+    /**
+     * \brief Queries image usage needed by the compute path
+     *
+     * Returns storage usage if the compute path is enabled
+     * and the format can be used as a storage image, so that
+     * the frontends can enable it on images that need mip
+     * generation. Returns \c 0 otherwise.
+     * \param [in] device The device
+     * \param [in] format Image format
+     * \param [in] tiling Image tiling
+     * \returns Additional image usage flags
+     */
+    static VkImageUsageFlags getImageUsage(
+      const DxvkDevice*         device,
+            VkFormat            format,
+            VkImageTiling       tiling);
+
+  private:
+
+    Rc<vk::DeviceFn>  m_vkd;
+    Rc<DxvkImageView> m_view;
+
+    VkImageView m_srcView = VK_NULL_HANDLE;
+    std::vector<VkImageView> m_dstViews;
+
+    VkImageView createView(
+            uint32_t            level,
+            VkImageUsageFlags   usage) const;
+
+  };
+
+
+  /**
+   * \brief Compute mip generation objects
+   *
+   * Stores the pipeline used for the
+   * single-pass compute mip generator.
+   */
+  class DxvkMetaMipGenObjects {
+
+  public:
+
+    DxvkMetaMipGenObjects(const DxvkDevice* device);
+    ~DxvkMetaMipGenObjects();
+
+    /**
+     * \brief Retrieves mip generation pipeline
+     * \returns Pipeline-related objects
+     */
+    DxvkMetaMipGenPipeline getPipeline() const {
+      return { m_dsetLayout, m_pipeLayout, m_pipeline };
+    }
+
+  private:
+
+    Rc<vk::DeviceFn> m_vkd;
+
+    VkDescriptorSetLayout m_dsetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout      m_pipeLayout = VK_NULL_HANDLE;
+    VkPipeline            m_pipeline   = VK_NULL_HANDLE;
+
+    VkDescriptorSetLayout createDescriptorSetLayout() const;
+
+    VkPipelineLayout createPipelineLayout() const;
+
+    VkPipeline createPipeline() const;
+
+  };
+  
 }
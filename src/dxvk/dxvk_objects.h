@@ -1,5 +1,6 @@
 #pragma once
 
+#include "dxvk_buffer_pool.h"
 #include "dxvk_gpu_event.h"
 #include "dxvk_gpu_query.h"
 #include "dxvk_memory.h"
@@ -24,6 +25,7 @@ namespace dxvk {
     DxvkObjects(DxvkDevice* device)
     : m_device          (device),
       m_memoryManager   (device),
+      m_bufferPool      (device),
       m_pipelineManager (device),
       m_eventPool       (device),
       m_queryPool       (device),
@@ -35,6 +37,10 @@ namespace dxvk {
       return m_memoryManager;
     }
 
+    DxvkSharedBufferPool& bufferPool() {
+      return m_bufferPool;
+    }
+
     DxvkPipelineManager& pipelineManager() {
       return m_pipelineManager;
     }
@@ -63,6 +69,10 @@ namespace dxvk {
       return m_metaCopy.get(m_device);
     }
 
+    DxvkMetaMipGenObjects& metaMipGen() {
+      return m_metaMipGen.get(m_device);
+    }
+
     DxvkMetaResolveObjects& metaResolve() {
       return m_metaResolve.get(m_device);
     }
@@ -76,6 +86,7 @@ namespace dxvk {
     DxvkDevice*                   m_device;
 
     DxvkMemoryAllocator           m_memoryManager;
+    DxvkSharedBufferPool          m_bufferPool;
     DxvkPipelineManager           m_pipelineManager;
 
     DxvkGpuEventPool              m_eventPool;
@@ -86,6 +97,7 @@ namespace dxvk {
     Lazy<DxvkMetaBlitObjects>     m_metaBlit;
     Lazy<DxvkMetaClearObjects>    m_metaClear;
     Lazy<DxvkMetaCopyObjects>     m_metaCopy;
+    Lazy<DxvkMetaMipGenObjects>   m_metaMipGen;
     Lazy<DxvkMetaResolveObjects>  m_metaResolve;
     Lazy<DxvkMetaPackObjects>     m_metaPack;
 
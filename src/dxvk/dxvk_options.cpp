@@ -9,6 +9,8 @@ namespace dxvk {
     enableGraphicsPipelineLibrary = config.getOption<Tristate>("dxvk.enableGraphicsPipelineLibrary", Tristate::Auto);
     trackPipelineLifetime = config.getOption<Tristate>("dxvk.trackPipelineLifetime",  Tristate::Auto);
     useRawSsbo            = config.getOption<Tristate>("dxvk.useRawSsbo",             Tristate::Auto);
+    latencyPacing         = config.getOption<bool>    ("dxvk.latencyPacing",          false);
+    enableComputeMipGen   = config.getOption<bool>    ("dxvk.enableComputeMipGen",    false);
     hud                   = config.getOption<std::string>("dxvk.hud", "");
   }
 
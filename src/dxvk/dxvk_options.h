@@ -27,6 +27,13 @@ namespace dxvk {
     /// Shader-related options
     Tristate useRawSsbo;
 
+    /// Latency-oriented frame pacing
+    bool latencyPacing;
+
+    /// Enables storage usage on images that need mip
+    /// generation so that the compute path can be used
+    bool enableComputeMipGen;
+
     /// HUD elements
     std::string hud;
   };
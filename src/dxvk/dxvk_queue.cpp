@@ -45,6 +45,12 @@ namespace dxvk {
       return m_submitQueue.size() + m_finishQueue.size() <= MaxNumQueuedCommandBuffers;
     });
 
+    // Assign tracking IDs under the lock so that resources
+    // used by multiple command lists end up with the ID of
+    // the last one submitted
+    submitInfo.trackId = ++m_trackIdAllocated;
+    submitInfo.cmdList->setTrackId(submitInfo.trackId);
+
     DxvkSubmitEntry entry = { };
     entry.submit = std::move(submitInfo);
 
@@ -61,6 +67,10 @@ namespace dxvk {
     entry.status  = status;
     entry.present = std::move(presentInfo);
 
+    { std::lock_guard<dxvk::mutex> latencyLock(m_latencyMutex);
+      m_framesQueued += 1;
+    }
+
     m_submitQueue.push(std::move(entry));
     m_appendCond.notify_all();
   }
@@ -76,6 +86,31 @@ namespace dxvk {
   }
 
 
+  void DxvkSubmissionQueue::synchronizeTrackId(
+          uint64_t            trackId) {
+    uint64_t semaphoreValue = 0ull;
+
+    { std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+      // The semaphore value is only known once the
+      // command list has been submitted to the device
+      m_submitCond.wait(lock, [this, trackId] {
+        return m_stopped.load() || m_trackIdSubmitted >= trackId;
+      });
+
+      // Command lists that already completed or failed
+      // to submit are not in the queue, so don't wait
+      for (const auto& entry : m_finishQueue) {
+        if (entry.submit.trackId == trackId)
+          semaphoreValue = entry.submit.semaphoreValue;
+      }
+    }
+
+    if (semaphoreValue && m_lastError.load() != VK_ERROR_DEVICE_LOST)
+      synchronizeSemaphore(semaphoreValue);
+  }
+
+
   void DxvkSubmissionQueue::synchronize() {
     std::unique_lock<dxvk::mutex> lock(m_mutex);
 
@@ -85,6 +120,32 @@ namespace dxvk {
   }
 
 
+  DxvkLatencyStats DxvkSubmissionQueue::getLatencyStats() {
+    std::lock_guard<dxvk::mutex> lock(m_latencyMutex);
+
+    auto now = dxvk::high_resolution_clock::now();
+
+    DxvkLatencyStats result = m_latencyStats;
+    result.idleTime = now;
+
+    // Assume that the oldest frame in flight started executing when
+    // the previous one completed, and that all other frames in flight
+    // take as long as the frames that we have seen so far.
+    uint64_t framesInFlight = m_framesQueued - m_framesCompleted;
+
+    if (framesInFlight) {
+      auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - m_lastFrameCompletion);
+
+      if (elapsed < result.frameTime)
+        result.idleTime += result.frameTime - elapsed;
+
+      result.idleTime += (framesInFlight - 1) * result.frameTime;
+    }
+
+    return result;
+  }
+
+
   void DxvkSubmissionQueue::lockDeviceQueue() {
     m_mutexQueue.lock();
   }
@@ -136,6 +197,7 @@ namespace dxvk {
         std::lock_guard<dxvk::mutex> lock(m_mutexQueue);
 
         if (entry.submit.cmdList != nullptr) {
+          entry.submit.submitTime = dxvk::high_resolution_clock::now();
           status = entry.submit.cmdList->submit(m_semaphore, m_semaphoreValue);
           entry.submit.semaphoreValue = m_semaphoreValue;
         } else if (entry.present.presenter != nullptr) {
@@ -149,13 +211,21 @@ namespace dxvk {
 
       if (entry.status)
         entry.status->result = status;
+
+      // Mark the end of the frame regardless of whether the present
+      // succeeded, or else we would consider the frame in flight forever
+      if (entry.present.presenter != nullptr)
+        recordFrameMarker(m_semaphoreValue);
       
       // On success, pass it on to the queue thread
       lock = std::unique_lock<dxvk::mutex>(m_mutex);
 
+      if (entry.submit.cmdList != nullptr)
+        m_trackIdSubmitted = entry.submit.trackId;
+
       if (status == VK_SUCCESS) {
         if (entry.submit.cmdList != nullptr)
-          m_finishQueue.push(std::move(entry));
+          m_finishQueue.push_back(std::move(entry));
       } else if (status == VK_ERROR_DEVICE_LOST || entry.submit.cmdList != nullptr) {
         Logger::err(str::format("DxvkSubmissionQueue: Command submission failed: ", status));
         m_lastError = status;
@@ -200,6 +270,8 @@ namespace dxvk {
         Logger::err(str::format("DxvkSubmissionQueue: Failed to sync fence: ", status));
         m_lastError = status;
         m_device->waitForIdle();
+      } else {
+        recordCompletion(entry.submit, dxvk::high_resolution_clock::now());
       }
 
       // Release resources and signal events, then immediately wake
@@ -210,7 +282,7 @@ namespace dxvk {
       lock.lock();
       m_pending -= 1;
 
-      m_finishQueue.pop();
+      m_finishQueue.pop_front();
       m_finishCond.notify_all();
       lock.unlock();
 
@@ -219,5 +291,65 @@ namespace dxvk {
       m_device->recycleCommandList(entry.submit.cmdList);
     }
   }
-  
-}
\ No newline at end of file
+
+
+  void DxvkSubmissionQueue::recordFrameMarker(
+          uint64_t        semaphoreValue) {
+    std::lock_guard<dxvk::mutex> lock(m_latencyMutex);
+
+    DxvkFrameMarker marker;
+    marker.semaphoreValue = semaphoreValue;
+    marker.presentTime = dxvk::high_resolution_clock::now();
+
+    // The command lists for this frame may have
+    // completed before the present got processed
+    if (m_completedValue >= semaphoreValue)
+      completeFrame(marker, marker.presentTime);
+    else
+      m_frameMarkers.push(marker);
+  }
+
+
+  void DxvkSubmissionQueue::recordCompletion(
+    const DxvkSubmitInfo& submitInfo,
+          dxvk::high_resolution_clock::time_point time) {
+    std::lock_guard<dxvk::mutex> lock(m_latencyMutex);
+
+    // Only count the time during which this command list could have
+    // been executing, i.e. don't count time spent waiting for prior
+    // submissions to complete, or the time the GPU was idle.
+    auto start = std::max(submitInfo.submitTime, m_lastCompletion);
+
+    if (time > start)
+      m_frameBusyTime += time - start;
+
+    m_lastCompletion = time;
+    m_completedValue = submitInfo.semaphoreValue;
+
+    while (!m_frameMarkers.empty()
+        && m_frameMarkers.front().semaphoreValue <= m_completedValue) {
+      completeFrame(m_frameMarkers.front(), time);
+      m_frameMarkers.pop();
+    }
+  }
+
+
+  void DxvkSubmissionQueue::completeFrame(
+    const DxvkFrameMarker& marker,
+          dxvk::high_resolution_clock::time_point time) {
+    auto frameTime = std::chrono::duration_cast<std::chrono::microseconds>(m_frameBusyTime);
+    m_frameBusyTime = std::chrono::nanoseconds::zero();
+
+    // Smooth out the frame time estimate so that a
+    // single slow frame does not throw off pacing
+    m_latencyStats.frameTime = m_framesCompleted
+      ? (3 * m_latencyStats.frameTime + frameTime) / 4
+      : frameTime;
+
+    m_latencyStats.latency = std::chrono::duration_cast<std::chrono::microseconds>(time - marker.presentTime);
+
+    m_lastFrameCompletion = time;
+    m_framesCompleted += 1;
+  }
+
+}
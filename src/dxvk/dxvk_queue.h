@@ -1,6 +1,7 @@
 #pragma once
 
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <queue>
 
@@ -33,7 +34,9 @@ namespace dxvk {
    */
   struct DxvkSubmitInfo {
     Rc<DxvkCommandList> cmdList;
+    uint64_t trackId;
     uint64_t semaphoreValue;
+    dxvk::high_resolution_clock::time_point submitTime;
   };
   
   
@@ -48,6 +51,36 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Frame latency stats
+   *
+   * Estimates derived from command list completion
+   * times. Used for latency-oriented frame pacing.
+   */
+  struct DxvkLatencyStats {
+    /// Estimated GPU time per frame
+    std::chrono::microseconds frameTime;
+    /// Time between a frame being queued for
+    /// presentation and the GPU finishing it
+    std::chrono::microseconds latency;
+    /// Predicted point in time at which the GPU
+    /// finishes all frames queued so far
+    dxvk::high_resolution_clock::time_point idleTime;
+  };
+
+
+  /**
+   * \brief Frame marker
+   *
+   * Stores the semaphore value of the last command
+   * list submitted before a given present request.
+   */
+  struct DxvkFrameMarker {
+    uint64_t semaphoreValue;
+    dxvk::high_resolution_clock::time_point presentTime;
+  };
+
+
   /**
    * \brief Submission queue entry
    */
@@ -91,6 +124,16 @@ namespace dxvk {
       return m_gpuIdle.load();
     }
 
+    /**
+     * \brief Retrieves frame latency stats
+     *
+     * Returns the current GPU frame time and latency
+     * estimates, as well as a prediction for when the
+     * GPU will have finished all queued frames.
+     * \returns Frame latency stats
+     */
+    DxvkLatencyStats getLatencyStats();
+
     /**
      * \brief Retrieves last submission error
      * 
@@ -144,6 +187,18 @@ namespace dxvk {
      */
     void synchronize();
 
+    /**
+     * \brief Synchronizes with a tracked submission
+     *
+     * Waits for the GPU to finish executing the command
+     * list with the given tracking ID. Unlike waiting for
+     * resources to be released, this does not depend on
+     * the finish thread processing the command list.
+     * \param [in] trackId Submission tracking ID
+     */
+    void synchronizeTrackId(
+            uint64_t            trackId);
+
     /**
      * \brief Synchronizes until a given condition becomes true
      *
@@ -187,6 +242,9 @@ namespace dxvk {
     VkSemaphore                 m_semaphore = VK_NULL_HANDLE;
     uint64_t                    m_semaphoreValue = 0ull;
 
+    uint64_t                    m_trackIdAllocated = 0ull;
+    uint64_t                    m_trackIdSubmitted = 0ull;
+
     dxvk::mutex                 m_mutex;
     dxvk::mutex                 m_mutexQueue;
     
@@ -195,7 +253,17 @@ namespace dxvk {
     dxvk::condition_variable    m_finishCond;
 
     std::queue<DxvkSubmitEntry> m_submitQueue;
-    std::queue<DxvkSubmitEntry> m_finishQueue;
+    std::deque<DxvkSubmitEntry> m_finishQueue;
+
+    dxvk::mutex                 m_latencyMutex;
+    std::queue<DxvkFrameMarker> m_frameMarkers;
+    uint64_t                    m_framesQueued = 0ull;
+    uint64_t                    m_framesCompleted = 0ull;
+    uint64_t                    m_completedValue = 0ull;
+    std::chrono::nanoseconds    m_frameBusyTime = { };
+    DxvkLatencyStats            m_latencyStats = { };
+    dxvk::high_resolution_clock::time_point m_lastCompletion = { };
+    dxvk::high_resolution_clock::time_point m_lastFrameCompletion = { };
 
     dxvk::thread                m_submitThread;
     dxvk::thread                m_finishThread;
@@ -205,6 +273,17 @@ namespace dxvk {
 
     void submitCmdLists();
 
+    void recordFrameMarker(
+            uint64_t        semaphoreValue);
+
+    void recordCompletion(
+      const DxvkSubmitInfo& submitInfo,
+            dxvk::high_resolution_clock::time_point time);
+
+    void completeFrame(
+      const DxvkFrameMarker& marker,
+            dxvk::high_resolution_clock::time_point time);
+
     void finishCmdLists();
     
   };
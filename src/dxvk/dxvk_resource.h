@@ -4,6 +4,8 @@
 
 namespace dxvk {
   
+  class DxvkSparsePageTable;
+
   enum class DxvkAccess : uint32_t {
     Read    = 0,
     Write   = 1,
@@ -32,6 +34,10 @@ namespace dxvk {
     static constexpr uint64_t WrAccessInc   = 1ull << WrAccessShift;
   public:
 
+    /// Tracking ID of resources used by a
+    /// command list that is not submitted yet
+    static constexpr uint64_t PendingTrackId = ~0ull;
+
     DxvkResource();
 
     virtual ~DxvkResource();
@@ -48,6 +54,16 @@ namespace dxvk {
       return m_cookie;
     }
 
+    /**
+     * \brief Queries sparse page table
+     *
+     * \returns Page table, or \c nullptr if
+     *    the resource is not a sparse resource
+     */
+    virtual DxvkSparsePageTable* getSparsePageTable() {
+      return nullptr;
+    }
+
     /**
      * \brief Increments reference count
      * \returns New reference count
@@ -103,6 +119,38 @@ namespace dxvk {
       return bool(m_useCount.load() & mask);
     }
     
+    /**
+     * \brief Queries tracking ID of the last GPU use
+     *
+     * The tracking ID identifies the last submission that
+     * uses the resource with the given access type. As with
+     * \ref isInUse, checking for reads also includes writes.
+     * \param [in] access Access type to check for
+     * \returns Tracking ID, or \c PendingTrackId if the
+     *    last use has not been submitted yet
+     */
+    uint64_t getTrackId(DxvkAccess access = DxvkAccess::Read) const {
+      return access == DxvkAccess::Read
+        ? m_trackIdUse.load(std::memory_order_acquire)
+        : m_trackIdWrite.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \brief Sets tracking ID of the last GPU use
+     *
+     * \param [in] access Access type of the use
+     * \param [in] trackId Submission tracking ID
+     */
+    void setTrackId(DxvkAccess access, uint64_t trackId) {
+      if (access == DxvkAccess::None)
+        return;
+
+      m_trackIdUse.store(trackId, std::memory_order_release);
+
+      if (access == DxvkAccess::Write)
+        m_trackIdWrite.store(trackId, std::memory_order_release);
+    }
+
     /**
      * \brief Waits for resource to become unused
      *
@@ -121,6 +169,9 @@ namespace dxvk {
     std::atomic<uint64_t> m_useCount;
     uint64_t              m_cookie;
 
+    std::atomic<uint64_t> m_trackIdUse   = { 0ull };
+    std::atomic<uint64_t> m_trackIdWrite = { 0ull };
+
     static constexpr uint64_t getIncrement(DxvkAccess access) {
       uint64_t increment = RefcountInc;
 
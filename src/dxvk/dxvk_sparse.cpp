@@ -0,0 +1,561 @@
+#include "dxvk_buffer.h"
+#include "dxvk_cmdlist.h"
+#include "dxvk_device.h"
+#include "dxvk_image.h"
+#include "dxvk_sparse.h"
+
+namespace dxvk {
+
+  DxvkSparsePageAllocator::DxvkSparsePageAllocator(
+          DxvkMemoryAllocator&  memoryAllocator)
+  : m_memory(&memoryAllocator) {
+
+  }
+
+
+  DxvkSparsePageAllocator::~DxvkSparsePageAllocator() {
+
+  }
+
+
+  Rc<DxvkSparsePage> DxvkSparsePageAllocator::acquirePage(
+          uint32_t              page) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    if (page >= m_pageCount)
+      return nullptr;
+
+    if (page >= m_pages.size())
+      m_pages.resize(page + 1);
+
+    if (m_pages[page] == nullptr) {
+      try {
+        m_pages[page] = new DxvkSparsePage(m_memory->allocSparsePage());
+      } catch (const DxvkError& e) {
+        // Leave the page unbound rather than
+        // tearing down the entire CS thread
+        Logger::err(e.message());
+      }
+    }
+
+    return m_pages[page];
+  }
+
+
+  void DxvkSparsePageAllocator::setCapacity(
+          uint32_t              pageCount) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    if (pageCount < m_pages.size())
+      m_pages.resize(pageCount);
+
+    m_pageCount = pageCount;
+  }
+
+
+  uint32_t DxvkSparsePageAllocator::getAllocatedPageCount() {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    uint32_t count = 0;
+
+    for (const auto& page : m_pages)
+      count += page != nullptr ? 1 : 0;
+
+    return count;
+  }
+
+
+
+
+  DxvkSparsePageTable::DxvkSparsePageTable() {
+
+  }
+
+
+  DxvkSparsePageTable::DxvkSparsePageTable(
+    const DxvkDevice*             device,
+    const DxvkBuffer*             buffer)
+  : m_buffer(buffer->getSliceHandle().handle) {
+    auto vk = device->vkd();
+
+    // The memory requirements may be larger than the buffer
+    // itself, and we need to cover the entire allocation
+    VkMemoryRequirements memReq = { };
+    vk->vkGetBufferMemoryRequirements(vk->device(), m_buffer, &memReq);
+
+    if (SparseMemoryPageSize % memReq.alignment)
+      throw DxvkError(str::format("DxvkSparsePageTable: Unsupported buffer page size: ", memReq.alignment));
+
+    uint32_t pageCount = uint32_t((memReq.size + SparseMemoryPageSize - 1) / SparseMemoryPageSize);
+
+    m_metadata.resize(pageCount);
+    m_mappings.resize(pageCount);
+
+    for (uint32_t i = 0; i < pageCount; i++) {
+      VkDeviceSize offset = SparseMemoryPageSize * i;
+
+      m_metadata[i].type = DxvkSparsePageType::Buffer;
+      m_metadata[i].buffer.offset = offset;
+      m_metadata[i].buffer.length = std::min(SparseMemoryPageSize, memReq.size - offset);
+    }
+  }
+
+
+  DxvkSparsePageTable::DxvkSparsePageTable(
+    const DxvkDevice*             device,
+    const DxvkImage*              image)
+  : m_image(image->handle()) {
+    auto vk = device->vkd();
+
+    const auto& imageInfo = image->info();
+    auto formatInfo = image->formatInfo();
+
+    // Depth-stencil images would need separate pages for
+    // each aspect, which D3D does not have a concept of
+    if (formatInfo->aspectMask & (formatInfo->aspectMask - 1))
+      throw DxvkError("DxvkSparsePageTable: Multi-aspect sparse images not supported");
+
+    uint32_t reqCount = 0;
+    vk->vkGetImageSparseMemoryRequirements(vk->device(), m_image, &reqCount, nullptr);
+
+    std::vector<VkSparseImageMemoryRequirements> reqs(reqCount);
+    vk->vkGetImageSparseMemoryRequirements(vk->device(), m_image, &reqCount, reqs.data());
+
+    const VkSparseImageMemoryRequirements* req = nullptr;
+
+    for (const auto& r : reqs) {
+      if (r.formatProperties.aspectMask & VK_IMAGE_ASPECT_METADATA_BIT)
+        throw DxvkError("DxvkSparsePageTable: Sparse images with metadata not supported");
+
+      if (r.formatProperties.aspectMask & formatInfo->aspectMask)
+        req = &r;
+    }
+
+    if (!req)
+      throw DxvkError("DxvkSparsePageTable: No sparse memory requirements for image");
+
+    // Pages are shared with buffers and other images, so the
+    // sparse block size must match our page size exactly
+    VkMemoryRequirements memReq = { };
+    vk->vkGetImageMemoryRequirements(vk->device(), m_image, &memReq);
+
+    if (memReq.alignment != SparseMemoryPageSize)
+      throw DxvkError(str::format("DxvkSparsePageTable: Unsupported image page size: ", memReq.alignment));
+
+    VkExtent3D granularity = req->formatProperties.imageGranularity;
+
+    m_properties.flags            = req->formatProperties.flags;
+    m_properties.pageRegionExtent = granularity;
+    m_properties.pagedMipCount    = std::min(req->imageMipTailFirstLod, imageInfo.mipLevels);
+    m_properties.mipTailOffset    = req->imageMipTailOffset;
+    m_properties.mipTailSize      = req->imageMipTailSize;
+    m_properties.mipTailStride    = req->imageMipTailStride;
+
+    bool hasMipTail = m_properties.pagedMipCount < imageInfo.mipLevels;
+    bool singleMipTail = (req->formatProperties.flags & VK_SPARSE_IMAGE_FORMAT_SINGLE_MIPTAIL_BIT) != 0;
+
+    if (hasMipTail)
+      m_properties.mipTailPageCount = uint32_t((req->imageMipTailSize + SparseMemoryPageSize - 1) / SparseMemoryPageSize);
+
+    // Pages are ordered by array layer, with the standard mips
+    // of each layer followed by the layer's mip tail, if any.
+    m_subresources.resize(imageInfo.numLayers * imageInfo.mipLevels);
+
+    uint32_t mipTailPageIndex = 0;
+
+    for (uint32_t l = 0; l < imageInfo.numLayers; l++) {
+      for (uint32_t m = 0; m < m_properties.pagedMipCount; m++) {
+        VkExtent3D mipExtent = image->mipLevelExtent(m);
+
+        auto& subresource = m_subresources[m + imageInfo.mipLevels * l];
+        subresource.isMipTail = VK_FALSE;
+        subresource.pageCount = util::computeBlockCount(mipExtent, granularity);
+        subresource.pageIndex = getPageCount();
+
+        for (uint32_t z = 0; z < subresource.pageCount.depth; z++) {
+          for (uint32_t y = 0; y < subresource.pageCount.height; y++) {
+            for (uint32_t x = 0; x < subresource.pageCount.width; x++) {
+              DxvkSparsePageInfo pageInfo = { };
+              pageInfo.type = DxvkSparsePageType::Image;
+              pageInfo.image.subresource = { formatInfo->aspectMask, m, l };
+              pageInfo.image.offset = VkOffset3D {
+                int32_t(x * granularity.width),
+                int32_t(y * granularity.height),
+                int32_t(z * granularity.depth) };
+              pageInfo.image.extent = VkExtent3D {
+                std::min(granularity.width,  mipExtent.width  - pageInfo.image.offset.x),
+                std::min(granularity.height, mipExtent.height - pageInfo.image.offset.y),
+                std::min(granularity.depth,  mipExtent.depth  - pageInfo.image.offset.z) };
+              m_metadata.push_back(pageInfo);
+            }
+          }
+        }
+      }
+
+      if (hasMipTail) {
+        if (!singleMipTail || !l) {
+          VkDeviceSize mipTailOffset = m_properties.mipTailOffset;
+
+          if (!singleMipTail)
+            mipTailOffset += m_properties.mipTailStride * l;
+
+          mipTailPageIndex = getPageCount();
+
+          for (uint32_t i = 0; i < m_properties.mipTailPageCount; i++) {
+            VkDeviceSize offset = SparseMemoryPageSize * i;
+
+            DxvkSparsePageInfo pageInfo = { };
+            pageInfo.type = DxvkSparsePageType::ImageMipTail;
+            pageInfo.mipTail.resourceOffset = mipTailOffset + offset;
+            pageInfo.mipTail.resourceLength = std::min(SparseMemoryPageSize, m_properties.mipTailSize - offset);
+            m_metadata.push_back(pageInfo);
+          }
+        }
+
+        for (uint32_t m = m_properties.pagedMipCount; m < imageInfo.mipLevels; m++) {
+          auto& subresource = m_subresources[m + imageInfo.mipLevels * l];
+          subresource.isMipTail = VK_TRUE;
+          subresource.pageCount = VkExtent3D { m_properties.mipTailPageCount, 1u, 1u };
+          subresource.pageIndex = mipTailPageIndex;
+        }
+      }
+    }
+
+    m_mappings.resize(m_metadata.size());
+  }
+
+
+  DxvkSparseImageSubresourceProperties DxvkSparsePageTable::getSubresourceProperties(
+          uint32_t                    subresource) const {
+    if (subresource >= m_subresources.size())
+      return DxvkSparseImageSubresourceProperties();
+
+    return m_subresources[subresource];
+  }
+
+
+  DxvkSparsePageInfo DxvkSparsePageTable::getPageInfo(
+          uint32_t                    page) const {
+    if (page >= m_metadata.size()) {
+      DxvkSparsePageInfo result = { };
+      result.type = DxvkSparsePageType::None;
+      return result;
+    }
+
+    return m_metadata[page];
+  }
+
+
+  uint32_t DxvkSparsePageTable::computePageIndex(
+          uint32_t                    subresource,
+          VkOffset3D                  regionOffset,
+          VkExtent3D                  regionExtent,
+          VkBool32                    regionIsLinear,
+          uint32_t                    pageIndex) const {
+    // Buffers only have one single subresource
+    // and are always addressed in linear order
+    if (m_buffer) {
+      if (subresource)
+        return ~0u;
+
+      uint32_t result = uint32_t(regionOffset.x) + pageIndex;
+      return result < getPageCount() ? result : ~0u;
+    }
+
+    if (subresource >= m_subresources.size())
+      return ~0u;
+
+    const auto& properties = m_subresources[subresource];
+
+    if (uint32_t(regionOffset.x) >= properties.pageCount.width
+     || uint32_t(regionOffset.y) >= properties.pageCount.height
+     || uint32_t(regionOffset.z) >= properties.pageCount.depth)
+      return ~0u;
+
+    if (regionIsLinear) {
+      // Linear regions may extend into subsequent
+      // subresources, which are laid out in order
+      uint32_t result = properties.pageIndex + uint32_t(regionOffset.x)
+        + properties.pageCount.width * (uint32_t(regionOffset.y)
+        + properties.pageCount.height * uint32_t(regionOffset.z))
+        + pageIndex;
+
+      return result < getPageCount() ? result : ~0u;
+    }
+
+    // Boxes cannot be used with mip tails
+    if (properties.isMipTail)
+      return ~0u;
+
+    uint32_t x = uint32_t(regionOffset.x) + (pageIndex % regionExtent.width);
+    uint32_t y = uint32_t(regionOffset.y) + (pageIndex / regionExtent.width) % regionExtent.height;
+    uint32_t z = uint32_t(regionOffset.z) + (pageIndex / regionExtent.width) / regionExtent.height;
+
+    if (x >= properties.pageCount.width
+     || y >= properties.pageCount.height
+     || z >= properties.pageCount.depth)
+      return ~0u;
+
+    return properties.pageIndex + x + properties.pageCount.width
+      * (y + properties.pageCount.height * z);
+  }
+
+
+  Rc<DxvkSparsePage> DxvkSparsePageTable::getMapping(
+          uint32_t                    page) const {
+    if (page >= m_mappings.size())
+      return nullptr;
+
+    return m_mappings[page];
+  }
+
+
+  void DxvkSparsePageTable::updateMapping(
+          DxvkCommandList*            cmd,
+          uint32_t                    page,
+          Rc<DxvkSparsePage>&&        mapping) {
+    if (page >= m_mappings.size() || m_mappings[page] == mapping)
+      return;
+
+    const auto& pageInfo = m_metadata[page];
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize memoryOffset = 0;
+
+    if (mapping != nullptr) {
+      memory       = mapping->memory();
+      memoryOffset = mapping->offset();
+    }
+
+    switch (pageInfo.type) {
+      case DxvkSparsePageType::None:
+        break;
+
+      case DxvkSparsePageType::Buffer: {
+        VkSparseMemoryBind bind = { };
+        bind.resourceOffset = pageInfo.buffer.offset;
+        bind.size           = pageInfo.buffer.length;
+        bind.memory         = memory;
+        bind.memoryOffset   = memoryOffset;
+
+        cmd->bindBufferMemory(m_buffer, bind);
+      } break;
+
+      case DxvkSparsePageType::Image: {
+        VkSparseImageMemoryBind bind = { };
+        bind.subresource    = pageInfo.image.subresource;
+        bind.offset         = pageInfo.image.offset;
+        bind.extent         = pageInfo.image.extent;
+        bind.memory         = memory;
+        bind.memoryOffset   = memoryOffset;
+
+        cmd->bindImageMemory(m_image, bind);
+      } break;
+
+      case DxvkSparsePageType::ImageMipTail: {
+        VkSparseMemoryBind bind = { };
+        bind.resourceOffset = pageInfo.mipTail.resourceOffset;
+        bind.size           = pageInfo.mipTail.resourceLength;
+        bind.memory         = memory;
+        bind.memoryOffset   = memoryOffset;
+
+        cmd->bindImageOpaqueMemory(m_image, bind);
+      } break;
+    }
+
+    // The previously bound page may still be in use until
+    // the bind operation itself has completed on the GPU
+    cmd->trackSparsePage(std::move(m_mappings[page]));
+    m_mappings[page] = std::move(mapping);
+  }
+
+
+
+
+  DxvkSparseBindSubmission::DxvkSparseBindSubmission() {
+
+  }
+
+
+  DxvkSparseBindSubmission::~DxvkSparseBindSubmission() {
+
+  }
+
+
+  void DxvkSparseBindSubmission::waitSemaphore(
+          VkSemaphore           semaphore,
+          uint64_t              value) {
+    m_waitSemaphores.push_back(semaphore);
+    m_waitSemaphoreValues.push_back(value);
+  }
+
+
+  void DxvkSparseBindSubmission::signalSemaphore(
+          VkSemaphore           semaphore,
+          uint64_t              value) {
+    m_signalSemaphores.push_back(semaphore);
+    m_signalSemaphoreValues.push_back(value);
+  }
+
+
+  void DxvkSparseBindSubmission::bindBufferMemory(
+          VkBuffer              buffer,
+    const VkSparseMemoryBind&   bind) {
+    m_bufferBinds[BufferKey { buffer, bind.resourceOffset }] = bind;
+  }
+
+
+  void DxvkSparseBindSubmission::bindImageMemory(
+          VkImage               image,
+    const VkSparseImageMemoryBind& bind) {
+    m_imageBinds[ImageKey { image, bind.subresource, bind.offset }] = bind;
+  }
+
+
+  void DxvkSparseBindSubmission::bindImageOpaqueMemory(
+          VkImage               image,
+    const VkSparseMemoryBind&   bind) {
+    m_imageOpaqueBinds[ImageOpaqueKey { image, bind.resourceOffset }] = bind;
+  }
+
+
+  VkResult DxvkSparseBindSubmission::submit(
+          DxvkDevice*           device,
+          VkQueue               queue) {
+    auto vk = device->vkd();
+
+    // Binds are sorted by resource handle, so we can
+    // emit one bind info for each consecutive range
+    std::vector<VkSparseMemoryBind>                 bufferBinds;
+    std::vector<VkSparseBufferMemoryBindInfo>       bufferInfos;
+
+    for (const auto& entry : m_bufferBinds) {
+      if (bufferInfos.empty() || bufferInfos.back().buffer != entry.first.buffer)
+        bufferInfos.push_back({ entry.first.buffer, 0u, nullptr });
+
+      bufferInfos.back().bindCount += 1;
+      bufferBinds.push_back(entry.second);
+    }
+
+    std::vector<VkSparseImageMemoryBind>            imageBinds;
+    std::vector<VkSparseImageMemoryBindInfo>        imageInfos;
+
+    for (const auto& entry : m_imageBinds) {
+      if (imageInfos.empty() || imageInfos.back().image != entry.first.image)
+        imageInfos.push_back({ entry.first.image, 0u, nullptr });
+
+      imageInfos.back().bindCount += 1;
+      imageBinds.push_back(entry.second);
+    }
+
+    std::vector<VkSparseMemoryBind>                 imageOpaqueBinds;
+    std::vector<VkSparseImageOpaqueMemoryBindInfo>  imageOpaqueInfos;
+
+    for (const auto& entry : m_imageOpaqueBinds) {
+      if (imageOpaqueInfos.empty() || imageOpaqueInfos.back().image != entry.first.image)
+        imageOpaqueInfos.push_back({ entry.first.image, 0u, nullptr });
+
+      imageOpaqueInfos.back().bindCount += 1;
+      imageOpaqueBinds.push_back(entry.second);
+    }
+
+    // Assign bind pointers now that the arrays are final
+    uint32_t bindIndex = 0;
+
+    for (auto& info : bufferInfos) {
+      info.pBinds = &bufferBinds[bindIndex];
+      bindIndex += info.bindCount;
+    }
+
+    bindIndex = 0;
+
+    for (auto& info : imageInfos) {
+      info.pBinds = &imageBinds[bindIndex];
+      bindIndex += info.bindCount;
+    }
+
+    bindIndex = 0;
+
+    for (auto& info : imageOpaqueInfos) {
+      info.pBinds = &imageOpaqueBinds[bindIndex];
+      bindIndex += info.bindCount;
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo = { VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+    timelineInfo.waitSemaphoreValueCount    = m_waitSemaphoreValues.size();
+    timelineInfo.pWaitSemaphoreValues       = m_waitSemaphoreValues.data();
+    timelineInfo.signalSemaphoreValueCount  = m_signalSemaphoreValues.size();
+    timelineInfo.pSignalSemaphoreValues     = m_signalSemaphoreValues.data();
+
+    VkBindSparseInfo bindInfo = { VK_STRUCTURE_TYPE_BIND_SPARSE_INFO, &timelineInfo };
+    bindInfo.waitSemaphoreCount     = m_waitSemaphores.size();
+    bindInfo.pWaitSemaphores        = m_waitSemaphores.data();
+    bindInfo.bufferBindCount        = bufferInfos.size();
+    bindInfo.pBufferBinds           = bufferInfos.data();
+    bindInfo.imageOpaqueBindCount   = imageOpaqueInfos.size();
+    bindInfo.pImageOpaqueBinds      = imageOpaqueInfos.data();
+    bindInfo.imageBindCount         = imageInfos.size();
+    bindInfo.pImageBinds            = imageInfos.data();
+    bindInfo.signalSemaphoreCount   = m_signalSemaphores.size();
+    bindInfo.pSignalSemaphores      = m_signalSemaphores.data();
+
+    VkResult vr = vk->vkQueueBindSparse(queue, 1, &bindInfo, VK_NULL_HANDLE);
+
+    if (vr == VK_SUCCESS)
+      this->reset();
+
+    return vr;
+  }
+
+
+  void DxvkSparseBindSubmission::reset() {
+    m_waitSemaphores.clear();
+    m_waitSemaphoreValues.clear();
+    m_signalSemaphores.clear();
+    m_signalSemaphoreValues.clear();
+
+    m_bufferBinds.clear();
+    m_imageBinds.clear();
+    m_imageOpaqueBinds.clear();
+  }
+
+
+  bool DxvkSparseBindSubmission::BufferKey::operator < (const BufferKey& other) const {
+    if (buffer != other.buffer)
+      return std::less<VkBuffer>()(buffer, other.buffer);
+
+    return offset < other.offset;
+  }
+
+
+  bool DxvkSparseBindSubmission::ImageKey::operator < (const ImageKey& other) const {
+    if (image != other.image)
+      return std::less<VkImage>()(image, other.image);
+
+    if (subresource.aspectMask != other.subresource.aspectMask)
+      return subresource.aspectMask < other.subresource.aspectMask;
+
+    if (subresource.mipLevel != other.subresource.mipLevel)
+      return subresource.mipLevel < other.subresource.mipLevel;
+
+    if (subresource.arrayLayer != other.subresource.arrayLayer)
+      return subresource.arrayLayer < other.subresource.arrayLayer;
+
+    if (offset.z != other.offset.z)
+      return offset.z < other.offset.z;
+
+    if (offset.y != other.offset.y)
+      return offset.y < other.offset.y;
+
+    return offset.x < other.offset.x;
+  }
+
+
+  bool DxvkSparseBindSubmission::ImageOpaqueKey::operator < (const ImageOpaqueKey& other) const {
+    if (image != other.image)
+      return std::less<VkImage>()(image, other.image);
+
+    return offset < other.offset;
+  }
+
+}
@@ -0,0 +1,478 @@
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "dxvk_memory.h"
+#include "dxvk_resource.h"
+
+namespace dxvk {
+
+  class DxvkBuffer;
+  class DxvkCommandList;
+  class DxvkDevice;
+  class DxvkImage;
+
+  /**
+   * \brief Sparse page size
+   *
+   * Matches the D3D tile size as well as the
+   * standard sparse block size in Vulkan.
+   */
+  constexpr static VkDeviceSize SparseMemoryPageSize = 1ull << 16;
+
+  /**
+   * \brief Sparse page
+   *
+   * A single page of device memory that can be bound
+   * to any number of sparse resources at a time.
+   */
+  class DxvkSparsePage : public RcObject {
+
+  public:
+
+    DxvkSparsePage(
+            DxvkMemory&&          memory)
+    : m_memory(std::move(memory)) { }
+
+    /**
+     * \brief Memory handle
+     * \returns Memory handle
+     */
+    VkDeviceMemory memory() const {
+      return m_memory.memory();
+    }
+
+    /**
+     * \brief Offset into memory object
+     * \returns Memory offset
+     */
+    VkDeviceSize offset() const {
+      return m_memory.offset();
+    }
+
+  private:
+
+    DxvkMemory m_memory;
+
+  };
+
+
+  /**
+   * \brief Sparse page allocator
+   *
+   * Implements a pool of pages that can be bound to sparse
+   * resources, e.g. a D3D11 tile pool. Pages are allocated
+   * lazily the first time they are requested, so that the
+   * pool only consumes memory for pages that are mapped.
+   */
+  class DxvkSparsePageAllocator : public RcObject {
+
+  public:
+
+    DxvkSparsePageAllocator(
+            DxvkMemoryAllocator&  memoryAllocator);
+
+    ~DxvkSparsePageAllocator();
+
+    /**
+     * \brief Retrieves a page
+     *
+     * Allocates page memory if necessary.
+     * \param [in] page Page index
+     * \returns Page object, or \c nullptr
+     *    if the index is out of bounds
+     */
+    Rc<DxvkSparsePage> acquirePage(
+            uint32_t              page);
+
+    /**
+     * \brief Changes the page count
+     *
+     * If the page count is reduced, pages beyond the new
+     * limit will be released from the pool, but remain
+     * valid as long as they are bound to any resource.
+     * \param [in] pageCount New page count
+     */
+    void setCapacity(
+            uint32_t              pageCount);
+
+    /**
+     * \brief Queries page count
+     * \returns Page count
+     */
+    uint32_t getCapacity() const {
+      return m_pageCount;
+    }
+
+    /**
+     * \brief Queries number of allocated pages
+     *
+     * Only pages that have been mapped at
+     * least once actually consume memory.
+     * \returns Allocated page count
+     */
+    uint32_t getAllocatedPageCount();
+
+  private:
+
+    DxvkMemoryAllocator*  m_memory;
+
+    dxvk::mutex           m_mutex;
+    uint32_t              m_pageCount = 0;
+
+    std::vector<Rc<DxvkSparsePage>> m_pages;
+
+  };
+
+
+  /**
+   * \brief Sparse page type
+   */
+  enum class DxvkSparsePageType : uint32_t {
+    None          = 0,
+    Buffer        = 1,
+    Image         = 2,
+    ImageMipTail  = 3,
+  };
+
+
+  /**
+   * \brief Sparse page info
+   *
+   * Stores the resource region covered by a
+   * single page of a sparse resource.
+   */
+  struct DxvkSparsePageInfo {
+    DxvkSparsePageType type;
+    union {
+      struct {
+        VkDeviceSize      offset;
+        VkDeviceSize      length;
+      } buffer;
+
+      struct {
+        VkImageSubresource subresource;
+        VkOffset3D        offset;
+        VkExtent3D        extent;
+      } image;
+
+      struct {
+        VkDeviceSize      resourceOffset;
+        VkDeviceSize      resourceLength;
+      } mipTail;
+    };
+  };
+
+
+  /**
+   * \brief Sparse image properties
+   */
+  struct DxvkSparseImageProperties {
+    VkSparseImageFormatFlags  flags;
+    VkExtent3D                pageRegionExtent;
+    uint32_t                  pagedMipCount;
+    uint32_t                  mipTailPageCount;
+    VkDeviceSize              mipTailOffset;
+    VkDeviceSize              mipTailSize;
+    VkDeviceSize              mipTailStride;
+  };
+
+
+  /**
+   * \brief Sparse image subresource properties
+   */
+  struct DxvkSparseImageSubresourceProperties {
+    VkBool32                  isMipTail;
+    VkExtent3D                pageCount;
+    uint32_t                  pageIndex;
+  };
+
+
+  /**
+   * \brief Sparse page table
+   *
+   * Maps the pages of a sparse buffer or image to
+   * resource regions, and stores the page that is
+   * currently bound to each of them. Must only be
+   * modified from the context that owns the
+   * resource's page mappings.
+   */
+  class DxvkSparsePageTable {
+
+  public:
+
+    DxvkSparsePageTable();
+
+    DxvkSparsePageTable(
+      const DxvkDevice*             device,
+      const DxvkBuffer*             buffer);
+
+    DxvkSparsePageTable(
+      const DxvkDevice*             device,
+      const DxvkImage*              image);
+
+    /**
+     * \brief Queries total page count
+     * \returns Page count
+     */
+    uint32_t getPageCount() const {
+      return uint32_t(m_metadata.size());
+    }
+
+    /**
+     * \brief Queries subresource count
+     * \returns Subresource count
+     */
+    uint32_t getSubresourceCount() const {
+      return uint32_t(m_subresources.size());
+    }
+
+    /**
+     * \brief Queries image properties
+     * \returns Sparse image properties
+     */
+    DxvkSparseImageProperties getProperties() const {
+      return m_properties;
+    }
+
+    /**
+     * \brief Queries subresource properties
+     *
+     * \param [in] subresource Subresource index
+     * \returns Subresource properties
+     */
+    DxvkSparseImageSubresourceProperties getSubresourceProperties(
+            uint32_t                    subresource) const;
+
+    /**
+     * \brief Queries info for a given page
+     *
+     * \param [in] page Page index
+     * \returns Page info
+     */
+    DxvkSparsePageInfo getPageInfo(
+            uint32_t                    page) const;
+
+    /**
+     * \brief Computes page index within a region
+     *
+     * \param [in] subresource Subresource index
+     * \param [in] regionOffset Region offset, in pages
+     * \param [in] regionExtent Region extent, in pages
+     * \param [in] regionIsLinear Whether to walk pages
+     *    in linear order rather than as a 3D box
+     * \param [in] pageIndex Page index within the region
+     * \returns Page index within the resource, or
+     *    \c ~0u if the page is out of bounds
+     */
+    uint32_t computePageIndex(
+            uint32_t                    subresource,
+            VkOffset3D                  regionOffset,
+            VkExtent3D                  regionExtent,
+            VkBool32                    regionIsLinear,
+            uint32_t                    pageIndex) const;
+
+    /**
+     * \brief Queries the page bound to a page
+     *
+     * \param [in] page Page index
+     * \returns Bound page, or \c nullptr
+     */
+    Rc<DxvkSparsePage> getMapping(
+            uint32_t                    page) const;
+
+    /**
+     * \brief Changes the page bound to a page
+     *
+     * Records the corresponding bind operation into the given
+     * command list, and keeps the previously bound page alive
+     * until the command list has completed execution.
+     * \param [in] cmd Command list
+     * \param [in] page Page index
+     * \param [in] mapping New page, or \c nullptr
+     */
+    void updateMapping(
+            DxvkCommandList*            cmd,
+            uint32_t                    page,
+            Rc<DxvkSparsePage>&&        mapping);
+
+  private:
+
+    VkBuffer  m_buffer  = VK_NULL_HANDLE;
+    VkImage   m_image   = VK_NULL_HANDLE;
+
+    DxvkSparseImageProperties                         m_properties = { };
+    std::vector<DxvkSparseImageSubresourceProperties> m_subresources;
+    std::vector<DxvkSparsePageInfo>                   m_metadata;
+    std::vector<Rc<DxvkSparsePage>>                   m_mappings;
+
+  };
+
+
+  /**
+   * \brief Sparse bind mode
+   */
+  enum class DxvkSparseBindMode : uint32_t {
+    Null,   ///< Unbind page
+    Bind,   ///< Bind page from allocator
+    Copy,   ///< Copy page mapping from a resource
+  };
+
+
+  /**
+   * \brief Sparse bind
+   */
+  struct DxvkSparseBind {
+    DxvkSparseBindMode  mode;
+    uint32_t            dstPage;
+    uint32_t            srcPage;
+  };
+
+
+  /**
+   * \brief Sparse bind info
+   *
+   * Stores a set of page binds for one sparse resource.
+   * Depending on the bind mode, source pages are taken
+   * from either a page allocator or another resource.
+   */
+  struct DxvkSparseBindInfo {
+    Rc<DxvkResource>              dstResource;
+    Rc<DxvkResource>              srcResource;
+    Rc<DxvkSparsePageAllocator>   srcAllocator;
+    std::vector<DxvkSparseBind>   binds;
+  };
+
+
+  /**
+   * \brief Sparse bind submission
+   *
+   * Collects memory binds for any number of sparse resources
+   * so that they can be submitted in a single batch. Binding
+   * the same resource region multiple times will only keep
+   * the last bind for that region.
+   */
+  class DxvkSparseBindSubmission {
+
+  public:
+
+    DxvkSparseBindSubmission();
+
+    ~DxvkSparseBindSubmission();
+
+    /**
+     * \brief Adds a timeline semaphore to wait on
+     *
+     * \param [in] semaphore Timeline semaphore
+     * \param [in] value Value to wait for
+     */
+    void waitSemaphore(
+            VkSemaphore           semaphore,
+            uint64_t              value);
+
+    /**
+     * \brief Adds a timeline semaphore to signal
+     *
+     * \param [in] semaphore Timeline semaphore
+     * \param [in] value Value to signal
+     */
+    void signalSemaphore(
+            VkSemaphore           semaphore,
+            uint64_t              value);
+
+    /**
+     * \brief Adds a buffer memory bind
+     *
+     * \param [in] buffer Buffer handle
+     * \param [in] bind Memory bind
+     */
+    void bindBufferMemory(
+            VkBuffer              buffer,
+      const VkSparseMemoryBind&   bind);
+
+    /**
+     * \brief Adds an image memory bind
+     *
+     * \param [in] image Image handle
+     * \param [in] bind Memory bind
+     */
+    void bindImageMemory(
+            VkImage               image,
+      const VkSparseImageMemoryBind& bind);
+
+    /**
+     * \brief Adds an opaque image memory bind
+     *
+     * Used to bind mip tail memory.
+     * \param [in] image Image handle
+     * \param [in] bind Memory bind
+     */
+    void bindImageOpaqueMemory(
+            VkImage               image,
+      const VkSparseMemoryBind&   bind);
+
+    /**
+     * \brief Checks whether there are any binds
+     * \returns \c true if no binds were added
+     */
+    bool isEmpty() const {
+      return m_bufferBinds.empty()
+          && m_imageBinds.empty()
+          && m_imageOpaqueBinds.empty();
+    }
+
+    /**
+     * \brief Submits binds to the given queue
+     *
+     * Resets the object on success.
+     * \param [in] device DXVK device
+     * \param [in] queue Queue handle. Must
+     *    support sparse binding operations.
+     * \returns Vulkan result of the submission
+     */
+    VkResult submit(
+            DxvkDevice*           device,
+            VkQueue               queue);
+
+    /**
+     * \brief Resets object
+     */
+    void reset();
+
+  private:
+
+    struct BufferKey {
+      VkBuffer      buffer;
+      VkDeviceSize  offset;
+
+      bool operator < (const BufferKey& other) const;
+    };
+
+    struct ImageKey {
+      VkImage             image;
+      VkImageSubresource  subresource;
+      VkOffset3D          offset;
+
+      bool operator < (const ImageKey& other) const;
+    };
+
+    struct ImageOpaqueKey {
+      VkImage       image;
+      VkDeviceSize  offset;
+
+      bool operator < (const ImageOpaqueKey& other) const;
+    };
+
+    std::vector<VkSemaphore>  m_waitSemaphores;
+    std::vector<uint64_t>     m_waitSemaphoreValues;
+    std::vector<VkSemaphore>  m_signalSemaphores;
+    std::vector<uint64_t>     m_signalSemaphoreValues;
+
+    std::map<BufferKey,       VkSparseMemoryBind>       m_bufferBinds;
+    std::map<ImageKey,        VkSparseImageMemoryBind>  m_imageBinds;
+    std::map<ImageOpaqueKey,  VkSparseMemoryBind>       m_imageOpaqueBinds;
+
+  };
+
+}
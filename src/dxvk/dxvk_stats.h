@@ -15,6 +15,7 @@ namespace dxvk {
     CmdDispatchCalls,         ///< Number of compute calls
     CmdRenderPassCount,       ///< Number of render passes
     CmdBarrierCount,          ///< Number of pipeline barriers
+    CmdClearsMerged,          ///< Number of compute clears sharing a pipeline bind
     PipeCountGraphics,        ///< Number of graphics pipelines
     PipeCountLibrary,         ///< Number of graphics shader libraries
     PipeCountCompute,         ///< Number of compute pipelines
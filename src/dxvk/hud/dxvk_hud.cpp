@@ -47,6 +47,7 @@ namespace dxvk::hud {
     addItem<HudMemoryStatsItem>("memory", -1, device);
     addItem<HudCsThreadItem>("cs", -1, device);
     addItem<HudGpuLoadItem>("gpuload", -1, device);
+    addItem<HudLatencyItem>("latency", -1, device);
     addItem<HudCompilerActivityItem>("compiler", -1, device);
   }
   
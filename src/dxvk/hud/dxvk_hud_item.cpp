@@ -391,6 +391,7 @@ namespace dxvk::hud {
       m_cpCount = diffCounters.getCtr(DxvkStatCounter::CmdDispatchCalls);
       m_rpCount = diffCounters.getCtr(DxvkStatCounter::CmdRenderPassCount);
       m_pbCount = diffCounters.getCtr(DxvkStatCounter::CmdBarrierCount);
+      m_mcCount = diffCounters.getCtr(DxvkStatCounter::CmdClearsMerged);
 
       m_lastUpdate = time;
     }
@@ -446,6 +447,17 @@ namespace dxvk::hud {
       { 1.0f, 1.0f, 1.0f, 1.0f },
       str::format(m_pbCount));
     
+    position.y += 20.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 0.5f, 1.0f, 1.0f },
+      "Merged clears:");
+    
+    renderer.drawText(16.0f,
+      { position.x + 192.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      str::format(m_mcCount));
+    
     position.y += 8.0f;
     return position;
   }
@@ -742,6 +754,65 @@ namespace dxvk::hud {
   }
 
 
+  HudLatencyItem::HudLatencyItem(const Rc<DxvkDevice>& device)
+  : m_device(device) {
+
+  }
+
+
+  HudLatencyItem::~HudLatencyItem() {
+
+  }
+
+
+  void HudLatencyItem::update(dxvk::high_resolution_clock::time_point time) {
+    uint64_t ticks = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate).count();
+
+    if (ticks >= UpdateInterval) {
+      DxvkLatencyStats stats = m_device->getLatencyStats();
+
+      m_frameTimeString = str::format(stats.frameTime.count() / 1000, ".",
+        (stats.frameTime.count() / 100) % 10, " ms");
+      m_latencyString = str::format(stats.latency.count() / 1000, ".",
+        (stats.latency.count() / 100) % 10, " ms");
+
+      m_lastUpdate = time;
+    }
+  }
+
+
+  HudPos HudLatencyItem::render(
+          HudRenderer&      renderer,
+          HudPos            position) {
+    position.y += 16.0f;
+
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 0.5f, 0.25f, 1.0f },
+      "GPU frame:");
+
+    renderer.drawText(16.0f,
+      { position.x + 132.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_frameTimeString);
+
+    position.y += 20.0f;
+
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 0.5f, 0.25f, 1.0f },
+      "Latency:");
+
+    renderer.drawText(16.0f,
+      { position.x + 132.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_latencyString);
+
+    position.y += 8.0f;
+    return position;
+  }
+
+
   HudCompilerActivityItem::HudCompilerActivityItem(const Rc<DxvkDevice>& device)
   : m_device(device) {
 
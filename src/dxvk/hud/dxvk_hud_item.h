@@ -302,6 +302,7 @@ namespace dxvk::hud {
     uint64_t          m_cpCount = 0;
     uint64_t          m_rpCount = 0;
     uint64_t          m_pbCount = 0;
+    uint64_t          m_mcCount = 0;
 
     dxvk::high_resolution_clock::time_point m_lastUpdate
       = dxvk::high_resolution_clock::now();
@@ -461,6 +462,36 @@ namespace dxvk::hud {
   };
 
 
+  /**
+   * \brief HUD item to display frame latency
+   */
+  class HudLatencyItem : public HudItem {
+    constexpr static int64_t UpdateInterval = 500'000;
+  public:
+
+    HudLatencyItem(const Rc<DxvkDevice>& device);
+
+    ~HudLatencyItem();
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+            HudRenderer&      renderer,
+            HudPos            position);
+
+  private:
+
+    Rc<DxvkDevice> m_device;
+
+    std::string m_frameTimeString;
+    std::string m_latencyString;
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+  };
+
+
   /**
    * \brief HUD item to display pipeline compiler activity
    */
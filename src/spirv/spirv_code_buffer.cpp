@@ -65,7 +65,11 @@ namespace dxvk {
   
   
   void SpirvCodeBuffer::putWord(uint32_t word) {
-    m_code.insert(m_code.begin() + m_ptr, word);
+    if (likely(m_ptr == m_code.size()))
+      m_code.push_back(word);
+    else
+      m_code.insert(m_code.begin() + m_ptr, word);
+
     m_ptr += 1;
   }
   
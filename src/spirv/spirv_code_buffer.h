@@ -23,6 +23,12 @@ namespace dxvk {
     explicit SpirvCodeBuffer(uint32_t size);
     SpirvCodeBuffer(uint32_t size, const uint32_t* data);
     SpirvCodeBuffer(std::istream& stream);
+
+    SpirvCodeBuffer             (SpirvCodeBuffer&& other) = default;
+    SpirvCodeBuffer& operator = (SpirvCodeBuffer&& other) = default;
+
+    SpirvCodeBuffer             (const SpirvCodeBuffer& other) = default;
+    SpirvCodeBuffer& operator = (const SpirvCodeBuffer& other) = default;
     
     template<size_t N>
     SpirvCodeBuffer(const uint32_t (&data)[N])
@@ -53,6 +59,18 @@ namespace dxvk {
       return m_code.size() * sizeof(uint32_t);
     }
     
+    /**
+     * \brief Pre-allocates storage
+     *
+     * Ensures that at least the given number of dwords
+     * can be stored without reallocation. Useful when the
+     * final size of the buffer is known in advance.
+     * \param [in] dwords Number of dwords to reserve
+     */
+    void reserve(size_t dwords) {
+      m_code.reserve(dwords);
+    }
+    
     /**
      * \brief Begin instruction iterator
      * 
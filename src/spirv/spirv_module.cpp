@@ -16,19 +16,22 @@ namespace dxvk {
   
   
   SpirvCodeBuffer SpirvModule::compile() const {
+    auto sections = getSections();
+
+    // Compute final size up front so that
+    // we only need to allocate memory once
+    size_t size = 5;
+
+    for (auto section : sections)
+      size += section->dwords();
+
     SpirvCodeBuffer result;
+    result.reserve(size);
     result.putHeader(m_version, m_id);
-    result.append(m_capabilities);
-    result.append(m_extensions);
-    result.append(m_instExt);
-    result.append(m_memoryModel);
-    result.append(m_entryPoints);
-    result.append(m_execModeInfo);
-    result.append(m_debugNames);
-    result.append(m_annotations);
-    result.append(m_typeConstDefs);
-    result.append(m_variables);
-    result.append(m_code);
+
+    for (auto section : sections)
+      result.append(*section);
+
     return result;
   }
   
@@ -3764,4 +3767,14 @@ namespace dxvk {
     }
   }
 
-}
\ No newline at end of file
+  
+  std::array<const SpirvCodeBuffer*, SpirvModule::SectionCount> SpirvModule::getSections() const {
+    return {{
+      &m_capabilities, &m_extensions,  &m_instExt,
+      &m_memoryModel,  &m_entryPoints, &m_execModeInfo,
+      &m_debugNames,   &m_annotations, &m_typeConstDefs,
+      &m_variables,    &m_code,
+    }};
+  }
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <unordered_set>
 
 #include "spirv_code_buffer.h"
@@ -1240,6 +1241,8 @@ namespace dxvk {
     
   private:
     
+    constexpr static uint32_t SectionCount = 11;
+
     uint32_t m_version;
     uint32_t m_id             = 1;
     uint32_t m_instExtGlsl450 = 0;
@@ -1261,6 +1264,8 @@ namespace dxvk {
 
     std::vector<uint32_t> m_interfaceVars;
 
+    std::array<const SpirvCodeBuffer*, SectionCount> getSections() const;
+
     uint32_t defType(
             spv::Op                 op, 
             uint32_t                argCount,
@@ -1,8 +1,42 @@
 #include "sync_recursive.h"
 #include "sync_spinlock.h"
 
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace dxvk::sync {
 
+  static bool initProcessBarrier() {
+#if defined(_WIN32)
+    return true;
+#elif defined(__linux__)
+    return !syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0);
+#else
+    return false;
+#endif
+  }
+
+
+  static void processBarrier() {
+    // Executes a full memory barrier on all threads of the process,
+    // which allows the biased lock path to only use compiler barriers
+#if defined(_WIN32)
+    FlushProcessWriteBuffers();
+#elif defined(__linux__)
+    syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+#endif
+  }
+
+
+  static bool isProcessBarrierSupported() {
+    static const bool s_supported = initProcessBarrier();
+    return s_supported;
+  }
+
+
   void RecursiveSpinlock::lock() {
     spin(2000, [this] { return try_lock(); });
   }
@@ -33,4 +67,60 @@ namespace dxvk::sync {
     return true;
   }
 
+
+
+  BiasedRecursiveSpinlock::BiasedRecursiveSpinlock(bool allowBias)
+  : m_biased(allowBias && isProcessBarrierSupported()) {
+
+  }
+
+
+  bool BiasedRecursiveSpinlock::lockBiased() {
+    uint32_t threadId = dxvk::this_thread::get_id();
+    uint32_t owner    = m_biasOwner.load(std::memory_order_relaxed);
+
+    // The first thread to take the lock becomes the owner
+    if (unlikely(!owner)) {
+      if (m_biasOwner.compare_exchange_strong(owner, threadId, std::memory_order_relaxed))
+        owner = threadId;
+    }
+
+    if (unlikely(owner != threadId)) {
+      revokeBias();
+      return false;
+    }
+
+    // Publish the depth before checking whether the bias is being
+    // revoked. The revoking thread issues a process-wide barrier
+    // between setting the flag and reading the depth, so at least
+    // one of the two threads is guaranteed to see the other's write.
+    m_biasDepth.store(m_biasDepth.load(std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    if (likely(!m_revoking.load(std::memory_order_relaxed))) {
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+      return true;
+    }
+
+    m_biasDepth.store(m_biasDepth.load(std::memory_order_relaxed) - 1,
+      std::memory_order_release);
+    return false;
+  }
+
+
+  void BiasedRecursiveSpinlock::revokeBias() {
+    m_revoking.store(true, std::memory_order_seq_cst);
+    processBarrier();
+
+    // Wait for the owner to leave any section that
+    // it entered through the bias. This also acquires
+    // all memory writes performed within that section.
+    spin(2000, [this] {
+      return !m_biasDepth.load(std::memory_order_acquire);
+    });
+
+    m_biased.store(false, std::memory_order_relaxed);
+  }
+
 }
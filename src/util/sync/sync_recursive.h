@@ -4,6 +4,8 @@
 
 #include "../com/com_include.h"
 
+#include "../util_likely.h"
+
 namespace dxvk::sync {
 
   /**
@@ -29,4 +31,70 @@ namespace dxvk::sync {
     
   };
 
+
+  /**
+   * \brief Biased recursive spinlock
+   *
+   * Recursive spinlock that is biased towards the first thread
+   * to acquire it. As long as no other thread tries to take the
+   * lock, the owning thread only updates a counter and does not
+   * need any atomic read-modify-write operations. Once a second
+   * thread shows up, the bias is revoked for good and all threads
+   * use the underlying recursive spinlock.
+   *
+   * Revoking the bias relies on a process-wide memory barrier.
+   * On platforms where that is not available, this behaves like
+   * a regular recursive spinlock.
+   */
+  class BiasedRecursiveSpinlock {
+
+  public:
+
+    BiasedRecursiveSpinlock(bool allowBias);
+
+    /**
+     * \brief Acquires the lock
+     *
+     * \returns \c true if the lock was acquired through
+     *    the bias. Must be passed to \ref unlock.
+     */
+    bool lock() {
+      if (likely(m_biased.load(std::memory_order_relaxed))) {
+        if (lockBiased())
+          return true;
+      }
+
+      m_lock.lock();
+      return false;
+    }
+
+    /**
+     * \brief Releases the lock
+     *
+     * \param [in] biased Value returned by \ref lock
+     */
+    void unlock(bool biased) {
+      if (likely(biased)) {
+        m_biasDepth.store(m_biasDepth.load(std::memory_order_relaxed) - 1,
+          std::memory_order_release);
+      } else {
+        m_lock.unlock();
+      }
+    }
+
+  private:
+
+    RecursiveSpinlock     m_lock;
+
+    std::atomic<bool>     m_biased    = { false };
+    std::atomic<bool>     m_revoking  = { false };
+    std::atomic<uint32_t> m_biasOwner = { 0u };
+    std::atomic<uint32_t> m_biasDepth = { 0u };
+
+    bool lockBiased();
+
+    void revokeBias();
+
+  };
+
 }
@@ -77,6 +77,39 @@ namespace dxvk {
   }
 
 
+  void FpsLimiter::delayFrameStart(
+          dxvk::high_resolution_clock::time_point gpuIdleTime) {
+    TimePoint t0;
+    TimerDuration sleepDuration;
+
+    { std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+      if (!m_initialized)
+        initialize();
+
+      t0 = dxvk::high_resolution_clock::now();
+
+      if (m_frameStart != TimePoint()) {
+        auto cpuFrameTime = std::chrono::duration_cast<TimerDuration>(t0 - m_frameStart);
+        m_cpuFrameTime = (3 * m_cpuFrameTime + cpuFrameTime) / 4;
+      }
+
+      // Cap the delay so that a bad GPU time estimate,
+      // e.g. after a long loading screen, cannot stall
+      // the application for an extended period of time.
+      sleepDuration = std::chrono::duration_cast<TimerDuration>(gpuIdleTime - t0) - m_cpuFrameTime;
+      sleepDuration = std::min(sleepDuration, TimerDuration(50ms));
+    }
+
+    // Don't hold the lock while sleeping since the
+    // presenter may call delay at the same time
+    TimePoint t1 = sleep(t0, sleepDuration);
+
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    m_frameStart = t1;
+  }
+
+
   FpsLimiter::TimePoint FpsLimiter::sleep(TimePoint t0, TimerDuration duration) {
     if (duration <= TimerDuration::zero())
       return t0;
@@ -38,6 +38,20 @@ namespace dxvk {
      */
     void delay(bool vsyncEnabled);
 
+    /**
+     * \brief Delays the start of the next frame
+     *
+     * Used for latency-oriented frame pacing. Stalls the calling
+     * thread so that the next frame is expected to finish on the
+     * CPU right when the GPU finishes all previously queued work,
+     * which keeps at most one frame queued. The CPU frame time is
+     * estimated from the time between subsequent calls.
+     * \param [in] gpuIdleTime Predicted time at which
+     *    the GPU will have finished all queued frames
+     */
+    void delayFrameStart(
+            dxvk::high_resolution_clock::time_point gpuIdleTime);
+
     /**
      * \brief Checks whether the frame rate limiter is enabled
      * \returns \c true if the target frame rate is non-zero.
@@ -68,6 +82,9 @@ namespace dxvk {
     TimerDuration   m_deviation       = TimerDuration::zero();
     TimePoint       m_lastFrame;
 
+    TimePoint       m_frameStart;
+    TimerDuration   m_cpuFrameTime    = TimerDuration::zero();
+
     bool            m_initialized     = false;
     bool            m_envOverride     = false;
 
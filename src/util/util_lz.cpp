@@ -0,0 +1,187 @@
+#include "util_lz.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dxvk::lz {
+
+  constexpr uint32_t HashBits  = 14;
+  constexpr size_t   MinMatch  = 4;
+  constexpr size_t   MaxOffset = 0xffff;
+
+
+  static uint32_t read32(const uint8_t* ptr) {
+    uint32_t result;
+    std::memcpy(&result, ptr, sizeof(result));
+    return result;
+  }
+
+
+  static uint32_t hash32(uint32_t value) {
+    return (value * 2654435761u) >> (32 - HashBits);
+  }
+
+
+  static void writeLength(std::vector<uint8_t>& dst, size_t length) {
+    while (length >= 255) {
+      dst.push_back(255);
+      length -= 255;
+    }
+
+    dst.push_back(uint8_t(length));
+  }
+
+
+  static bool readLength(const uint8_t* src, size_t srcSize, size_t& pos, size_t& length) {
+    uint8_t byte;
+
+    do {
+      if (pos >= srcSize)
+        return false;
+
+      byte = src[pos++];
+      length += byte;
+    } while (byte == 255);
+
+    return true;
+  }
+
+
+  static void writeSequence(
+          std::vector<uint8_t>& dst,
+    const uint8_t*              literals,
+          size_t                literalCount,
+          size_t                matchOffset,
+          size_t                matchLength) {
+    size_t matchCode = matchLength ? matchLength - MinMatch : 0;
+
+    uint8_t token = uint8_t(std::min<size_t>(literalCount, 15) << 4)
+                  | uint8_t(std::min<size_t>(matchCode, 15));
+    dst.push_back(token);
+
+    if (literalCount >= 15)
+      writeLength(dst, literalCount - 15);
+
+    dst.insert(dst.end(), literals, literals + literalCount);
+
+    if (!matchLength)
+      return;
+
+    dst.push_back(uint8_t(matchOffset));
+    dst.push_back(uint8_t(matchOffset >> 8));
+
+    if (matchCode >= 15)
+      writeLength(dst, matchCode - 15);
+  }
+
+
+  bool compress(
+    const void*                 src,
+          size_t                srcSize,
+          std::vector<uint8_t>& dst) {
+    auto in = reinterpret_cast<const uint8_t*>(src);
+
+    dst.clear();
+    dst.reserve(srcSize / 2);
+
+    // Stores the last position plus one for each hashed 4-byte sequence
+    std::vector<uint32_t> table(1u << HashBits, 0u);
+
+    size_t anchor = 0;
+    size_t pos    = 0;
+
+    while (pos + MinMatch <= srcSize) {
+      uint32_t seq  = read32(&in[pos]);
+      uint32_t hash = hash32(seq);
+
+      size_t ref = table[hash];
+      table[hash] = uint32_t(pos + 1);
+
+      if (ref-- && pos - ref <= MaxOffset && read32(&in[ref]) == seq) {
+        size_t length = MinMatch;
+
+        while (pos + length < srcSize && in[ref + length] == in[pos + length])
+          length += 1;
+
+        writeSequence(dst, &in[anchor], pos - anchor, pos - ref, length);
+
+        pos   += length;
+        anchor = pos;
+      } else {
+        // Skip ahead faster through data that does not compress
+        pos += 1 + ((pos - anchor) >> 6);
+      }
+
+      // Bail out early if we will not save any memory
+      if (dst.size() >= srcSize)
+        return false;
+    }
+
+    writeSequence(dst, &in[anchor], srcSize - anchor, 0, 0);
+    return dst.size() < srcSize;
+  }
+
+
+  bool decompress(
+    const void*                 src,
+          size_t                srcSize,
+          void*                 dst,
+          size_t                dstSize) {
+    auto in  = reinterpret_cast<const uint8_t*>(src);
+    auto out = reinterpret_cast<uint8_t*>(dst);
+
+    size_t inPos  = 0;
+    size_t outPos = 0;
+
+    while (inPos < srcSize) {
+      uint8_t token = in[inPos++];
+
+      size_t literalCount = token >> 4;
+
+      if (literalCount == 15 && !readLength(in, srcSize, inPos, literalCount))
+        return false;
+
+      if (literalCount > srcSize - inPos || literalCount > dstSize - outPos)
+        return false;
+
+      std::memcpy(&out[outPos], &in[inPos], literalCount);
+      inPos  += literalCount;
+      outPos += literalCount;
+
+      // The last sequence only consists of literals
+      if (inPos == srcSize)
+        break;
+
+      if (srcSize - inPos < 2)
+        return false;
+
+      size_t offset = size_t(in[inPos]) | (size_t(in[inPos + 1]) << 8);
+      inPos += 2;
+
+      size_t length = token & 0xf;
+
+      if (length == 15 && !readLength(in, srcSize, inPos, length))
+        return false;
+
+      length += MinMatch;
+
+      if (!offset || offset > outPos || length > dstSize - outPos)
+        return false;
+
+      // Matches may overlap the data being written
+      const uint8_t* ref = &out[outPos - offset];
+
+      if (offset >= length) {
+        std::memcpy(&out[outPos], ref, length);
+      } else {
+        for (size_t i = 0; i < length; i++)
+          out[outPos + i] = ref[i];
+      }
+
+      outPos += length;
+    }
+
+    return outPos == dstSize;
+  }
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dxvk::lz {
+
+  /**
+   * \brief Compresses a block of data
+   *
+   * Uses a simple byte-oriented LZ77 variant that favours
+   * speed over compression ratio. Each sequence consists of
+   * a token byte storing literal and match lengths, optional
+   * length extension bytes, the literals, and a 16-bit match
+   * offset. The final sequence only contains literals.
+   * \param [in] src Source data
+   * \param [in] srcSize Source data size, in bytes
+   * \param [out] dst Compressed data
+   * \returns \c true if the compressed data is
+   *    smaller than the source data
+   */
+  bool compress(
+    const void*                 src,
+          size_t                srcSize,
+          std::vector<uint8_t>& dst);
+
+  /**
+   * \brief Decompresses a block of data
+   *
+   * \param [in] src Compressed data
+   * \param [in] srcSize Compressed data size, in bytes
+   * \param [out] dst Destination buffer
+   * \param [in] dstSize Uncompressed data size, in bytes
+   * \returns \c true on success, \c false if the
+   *    compressed data is invalid
+   */
+  bool decompress(
+    const void*                 src,
+          size_t                srcSize,
+          void*                 dst,
+          size_t                dstSize);
+
+}
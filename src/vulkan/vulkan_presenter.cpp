@@ -226,6 +226,12 @@ namespace dxvk::vk {
   }
 
 
+  void Presenter::delayFrameStart(
+          dxvk::high_resolution_clock::time_point gpuIdleTime) {
+    m_fpsLimiter.delayFrameStart(gpuIdleTime);
+  }
+
+
   VkResult Presenter::getSupportedFormats(std::vector<VkSurfaceFormatKHR>& formats, const PresenterDesc& desc) {
     uint32_t numFormats = 0;
 
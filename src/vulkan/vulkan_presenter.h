@@ -161,6 +161,16 @@ namespace dxvk::vk {
      */
     void setFrameRateLimit(double frameRate);
 
+    /**
+     * \brief Delays the start of the next frame
+     *
+     * Implements latency-oriented frame pacing.
+     * \param [in] gpuIdleTime Predicted time at which
+     *    the GPU will have finished all queued frames
+     */
+    void delayFrameStart(
+            dxvk::high_resolution_clock::time_point gpuIdleTime);
+
     /**
      * \brief Checks whether a Vulkan swap chain exists
      *
@@ -0,0 +1,188 @@
+#include <cstring>
+#include <vector>
+
+#include <d3d11_2.h>
+#include <dxgi1_4.h>
+
+#include <windows.h>
+#include <windowsx.h>
+
+#include "../test_utils.h"
+
+using namespace dxvk;
+
+constexpr UINT TileSize = 65536;
+
+// Large enough that committing it up front would be obvious
+constexpr UINT PoolSize = 256u << 20;
+
+Com<ID3D11Device>           g_d3d11Device;
+Com<ID3D11DeviceContext>    g_d3d11Context;
+
+Com<ID3D11Device2>          g_d3d11Device2;
+Com<ID3D11DeviceContext2>   g_d3d11Context2;
+
+Com<IDXGIAdapter3>          g_dxgiAdapter;
+
+Com<ID3D11Texture2D>        g_tiledTexture;
+Com<ID3D11Buffer>           g_tilePool;
+Com<ID3D11Buffer>           g_readBuffer;
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  if (FAILED(D3D11CreateDevice(
+        nullptr, D3D_DRIVER_TYPE_HARDWARE,
+        nullptr, 0, nullptr, 0, D3D11_SDK_VERSION,
+        &g_d3d11Device, nullptr, &g_d3d11Context))) {
+    std::cerr << "Failed to create D3D11 device" << std::endl;
+    return 1;
+  }
+
+  if (FAILED(g_d3d11Device->QueryInterface(IID_PPV_ARGS(&g_d3d11Device2)))
+   || FAILED(g_d3d11Context->QueryInterface(IID_PPV_ARGS(&g_d3d11Context2)))) {
+    std::cerr << "Failed to query D3D11.2 interfaces" << std::endl;
+    return 1;
+  }
+
+  Com<IDXGIDevice> dxgiDevice;
+  Com<IDXGIAdapter> dxgiAdapter;
+
+  if (FAILED(g_d3d11Device->QueryInterface(IID_PPV_ARGS(&dxgiDevice)))
+   || FAILED(dxgiDevice->GetAdapter(&dxgiAdapter))
+   || FAILED(dxgiAdapter->QueryInterface(IID_PPV_ARGS(&g_dxgiAdapter)))) {
+    std::cerr << "Failed to query DXGI adapter" << std::endl;
+    return 1;
+  }
+
+  D3D11_FEATURE_DATA_D3D11_OPTIONS1 options = { };
+
+  if (FAILED(g_d3d11Device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS1, &options, sizeof(options)))
+   || options.TiledResourcesTier == D3D11_TILED_RESOURCES_NOT_SUPPORTED) {
+    std::cerr << "Tiled resources not supported" << std::endl;
+    return 1;
+  }
+
+  // Map a 4x4 tile region at the origin of the texture
+  constexpr UINT regionTiles = 4;
+  constexpr UINT poolTiles = regionTiles * regionTiles;
+
+  // Create the readback buffer up front so that it does
+  // not show up in the video memory usage measured below
+  D3D11_BUFFER_DESC readDesc;
+  readDesc.ByteWidth           = poolTiles * TileSize;
+  readDesc.Usage               = D3D11_USAGE_STAGING;
+  readDesc.BindFlags           = 0;
+  readDesc.CPUAccessFlags      = D3D11_CPU_ACCESS_READ;
+  readDesc.MiscFlags           = 0;
+  readDesc.StructureByteStride = 0;
+
+  if (FAILED(g_d3d11Device->CreateBuffer(&readDesc, nullptr, &g_readBuffer))) {
+    std::cerr << "Failed to create readback buffer" << std::endl;
+    return 1;
+  }
+
+  DXGI_QUERY_VIDEO_MEMORY_INFO memInfoBefore = { };
+  g_dxgiAdapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &memInfoBefore);
+
+  // 1 GiB worth of texels, of which only a small corner is backed by memory
+  D3D11_TEXTURE2D_DESC textureDesc;
+  textureDesc.Width           = 16384;
+  textureDesc.Height          = 16384;
+  textureDesc.MipLevels       = 1;
+  textureDesc.ArraySize       = 1;
+  textureDesc.Format          = DXGI_FORMAT_R8G8B8A8_UNORM;
+  textureDesc.SampleDesc      = { 1, 0 };
+  textureDesc.Usage           = D3D11_USAGE_DEFAULT;
+  textureDesc.BindFlags       = D3D11_BIND_SHADER_RESOURCE;
+  textureDesc.CPUAccessFlags  = 0;
+  textureDesc.MiscFlags       = D3D11_RESOURCE_MISC_TILED;
+
+  if (FAILED(g_d3d11Device->CreateTexture2D(&textureDesc, nullptr, &g_tiledTexture))) {
+    std::cerr << "Failed to create tiled texture" << std::endl;
+    return 1;
+  }
+
+  UINT tileCount = 0;
+  D3D11_TILE_SHAPE tileShape = { };
+
+  g_d3d11Device2->GetResourceTiling(g_tiledTexture.ptr(),
+    &tileCount, nullptr, &tileShape, nullptr, 0, nullptr);
+
+  D3D11_BUFFER_DESC poolDesc;
+  poolDesc.ByteWidth           = PoolSize;
+  poolDesc.Usage               = D3D11_USAGE_DEFAULT;
+  poolDesc.BindFlags           = 0;
+  poolDesc.CPUAccessFlags      = 0;
+  poolDesc.MiscFlags           = D3D11_RESOURCE_MISC_TILE_POOL;
+  poolDesc.StructureByteStride = 0;
+
+  if (FAILED(g_d3d11Device->CreateBuffer(&poolDesc, nullptr, &g_tilePool))) {
+    std::cerr << "Failed to create tile pool" << std::endl;
+    return 1;
+  }
+
+  D3D11_TILED_RESOURCE_COORDINATE regionCoord = { };
+
+  D3D11_TILE_REGION_SIZE regionSize = { };
+  regionSize.NumTiles = poolTiles;
+  regionSize.bUseBox  = TRUE;
+  regionSize.Width    = regionTiles;
+  regionSize.Height   = regionTiles;
+  regionSize.Depth    = 1;
+
+  UINT rangeFlags = 0;
+  UINT poolOffset = 0;
+  UINT rangeCount = poolTiles;
+
+  if (FAILED(g_d3d11Context2->UpdateTileMappings(g_tiledTexture.ptr(),
+      1, &regionCoord, &regionSize, g_tilePool.ptr(),
+      1, &rangeFlags, &poolOffset, &rangeCount, 0))) {
+    std::cerr << "Failed to update tile mappings" << std::endl;
+    return 1;
+  }
+
+  // Upload a distinct pattern to each tile, then read it back
+  std::vector<uint32_t> srcData(poolTiles * TileSize / sizeof(uint32_t));
+
+  for (size_t i = 0; i < srcData.size(); i++)
+    srcData[i] = uint32_t(i);
+
+  g_d3d11Context2->UpdateTiles(g_tiledTexture.ptr(),
+    &regionCoord, &regionSize, srcData.data(), 0);
+
+  g_d3d11Context2->CopyTiles(g_tiledTexture.ptr(),
+    &regionCoord, &regionSize, g_readBuffer.ptr(), 0,
+    D3D11_TILE_COPY_SWIZZLED_TILED_RESOURCE_TO_LINEAR_BUFFER);
+
+  D3D11_MAPPED_SUBRESOURCE mapped;
+
+  if (FAILED(g_d3d11Context->Map(g_readBuffer.ptr(), 0, D3D11_MAP_READ, 0, &mapped))) {
+    std::cerr << "Failed to map readback buffer" << std::endl;
+    return 1;
+  }
+
+  bool match = !std::memcmp(mapped.pData, srcData.data(), readDesc.ByteWidth);
+  g_d3d11Context->Unmap(g_readBuffer.ptr(), 0);
+
+  // Map synchronizes with the GPU, so all tile mappings are in effect.
+  // The measurement includes the allocator's chunk granularity.
+  DXGI_QUERY_VIDEO_MEMORY_INFO memInfoAfter = { };
+  g_dxgiAdapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &memInfoAfter);
+
+  UINT64 fullSize = UINT64(tileCount) * TileSize;
+  UINT64 usedSize = memInfoAfter.CurrentUsage > memInfoBefore.CurrentUsage
+    ? memInfoAfter.CurrentUsage - memInfoBefore.CurrentUsage : 0;
+
+  std::cout << "Tile shape:     " << tileShape.WidthInTexels << "x" << tileShape.HeightInTexels << std::endl;
+  std::cout << "Resource tiles: " << tileCount << std::endl;
+  std::cout << "Full size:      " << (fullSize >> 20) << " MiB" << std::endl;
+  std::cout << "Tile pool size: " << (PoolSize >> 20) << " MiB" << std::endl;
+  std::cout << "Mapped tiles:   " << poolTiles << " (" << ((poolTiles * TileSize) >> 10) << " kiB)" << std::endl;
+  std::cout << "Committed:      " << (usedSize >> 10) << " kiB" << std::endl;
+  std::cout << "Tile data:      " << (match ? "OK" : "MISMATCH") << std::endl;
+
+  g_d3d11Context->ClearState();
+  return match ? 0 : 1;
+}
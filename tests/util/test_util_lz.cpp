@@ -0,0 +1,127 @@
+#include <cstring>
+#include <vector>
+
+#include <windows.h>
+#include <windowsx.h>
+
+#include "../test_utils.h"
+
+#include "../../src/util/util_lz.h"
+
+using namespace dxvk;
+
+uint32_t g_seed = 0x12345678u;
+
+uint8_t randomByte() {
+  g_seed ^= g_seed << 13;
+  g_seed ^= g_seed >> 17;
+  g_seed ^= g_seed << 5;
+  return uint8_t(g_seed);
+}
+
+std::vector<uint8_t> randomData(size_t size) {
+  std::vector<uint8_t> data(size);
+
+  for (size_t i = 0; i < size; i++)
+    data[i] = randomByte();
+
+  return data;
+}
+
+/**
+ * \brief Compresses and decompresses data
+ *
+ * \param [in] name Test case name
+ * \param [in] data Uncompressed data
+ * \param [in] expectCompressed Whether compression must succeed
+ * \returns \c true if the test case passed
+ */
+bool testRoundTrip(const char* name, const std::vector<uint8_t>& data, bool expectCompressed) {
+  std::vector<uint8_t> compressed;
+  bool success = lz::compress(data.data(), data.size(), compressed);
+
+  if (success != expectCompressed) {
+    std::cerr << name << ": Compression " << (success ? "succeeded" : "failed")
+              << " for " << data.size() << " bytes" << std::endl;
+    return false;
+  }
+
+  if (!success)
+    return true;
+
+  if (compressed.size() >= data.size()) {
+    std::cerr << name << ": Compressed data not smaller than input" << std::endl;
+    return false;
+  }
+
+  std::vector<uint8_t> decompressed(data.size());
+
+  if (!lz::decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size())) {
+    std::cerr << name << ": Decompression failed for " << data.size() << " bytes" << std::endl;
+    return false;
+  }
+
+  if (std::memcmp(decompressed.data(), data.data(), data.size())) {
+    std::cerr << name << ": Data mismatch for " << data.size() << " bytes" << std::endl;
+    return false;
+  }
+
+  // Truncated input must be rejected rather than read out of bounds
+  if (lz::decompress(compressed.data(), compressed.size() / 2, decompressed.data(), decompressed.size())) {
+    std::cerr << name << ": Truncated data accepted for " << data.size() << " bytes" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  bool success = true;
+
+  // Random data never compresses, regardless of size
+  for (size_t size : { 0, 1, 4, 64, 4096, 65536, 1 << 20 })
+    success &= testRoundTrip("Incompressible", randomData(size), false);
+
+  // All-zero data compresses as soon as a single match pays off
+  for (size_t size : { 0, 1, 3, 4, 5 })
+    success &= testRoundTrip("Zero", std::vector<uint8_t>(size), false);
+
+  for (size_t size : { 16, 19, 20, 270, 274, 275, 4096, 65535, 65536, 65537, 1 << 20 })
+    success &= testRoundTrip("Zero", std::vector<uint8_t>(size), true);
+
+  // Literal runs around the token and length byte boundaries,
+  // followed by enough zeroes to make the data compressible
+  for (size_t literals : { 14, 15, 16, 269, 270, 271, 524, 525, 526 }) {
+    std::vector<uint8_t> data = randomData(literals);
+    data.resize(literals + 1024);
+    success &= testRoundTrip("Literals", data, true);
+  }
+
+  // Matches around the largest offset the format can encode
+  for (size_t offset : { 65534, 65535, 65536 }) {
+    std::vector<uint8_t> block = randomData(256);
+    std::vector<uint8_t> data(offset + block.size());
+
+    std::memcpy(&data[0], block.data(), block.size());
+    std::memcpy(&data[offset], block.data(), block.size());
+
+    success &= testRoundTrip("Offset", data, true);
+  }
+
+  // Repeating short period, which produces overlapping matches
+  for (size_t period : { 1, 2, 3, 7 }) {
+    std::vector<uint8_t> pattern = randomData(period);
+    std::vector<uint8_t> data(4099);
+
+    for (size_t i = 0; i < data.size(); i++)
+      data[i] = pattern[i % period];
+
+    success &= testRoundTrip("Period", data, true);
+  }
+
+  std::cout << "LZ round-trip: " << (success ? "OK" : "FAILED") << std::endl;
+  return success ? 0 : 1;
+}